@@ -10,6 +10,7 @@ module;
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 export module CEngine.Base;
+export import :Handle;
 export import :Object;
 import std;
 
@@ -0,0 +1,183 @@
+/**
+ * @file Handle.ixx
+ * @brief 代际句柄
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+export module CEngine.Base:Handle;
+import std;
+
+namespace CEngine {
+    export class Object;
+
+    /**
+     * @brief 无类型句柄
+     * @remark 32位槽位 + 32位代数；代数为0表示空句柄
+     */
+    export struct ObjectHandle {
+        std::uint32_t Slot = 0;
+        std::uint32_t Generation = 0;
+
+        bool IsNull() const { return Generation == 0; }
+
+        bool operator==(const ObjectHandle &) const = default;
+    };
+
+    /**
+     * @brief 代际句柄表
+     * @remark 槽位按页分配，页一旦分配不再移动或释放，因此查询无需加锁；\n
+     * 槽位释放时代数自增，旧句柄随即失效，地址复用不会产生误判；\n
+     * 分配与释放由互斥锁保护，可在工作线程中创建对象
+     * @note 句柄只能判断对象是否仍然存活，不能阻止其他线程在使用期间将其销毁
+     */
+    export class HandleTable {
+    public:
+        HandleTable() = delete;
+
+        /// 每页槽位数的位数
+        static constexpr std::uint32_t PageBits = 12;
+        static constexpr std::uint32_t PageSize = 1u << PageBits;
+        /// 最大页数（共支持 MaxPages * PageSize 个同时存活的对象）
+        static constexpr std::uint32_t MaxPages = 4096;
+
+        /**
+         * 分配槽位
+         * @param obj 对象指针
+         * @return 指向该对象的句柄
+         */
+        static ObjectHandle Allocate(Object *obj) {
+            std::lock_guard lock(Mutex);
+            std::uint32_t slot;
+            if (!FreeSlots.empty()) {
+                slot = FreeSlots.back();
+                FreeSlots.pop_back();
+            } else {
+                slot = NextSlot++;
+                const auto page_index = slot >> PageBits;
+                if (page_index >= MaxPages)
+                    throw std::length_error("HandleTable: 存活对象数量超出上限");
+                if (Pages[page_index].load(std::memory_order_relaxed) == nullptr)
+                    Pages[page_index].store(new Entry[PageSize], std::memory_order_release);
+            }
+            Entry &entry = At(slot);
+            entry.Ptr.store(obj, std::memory_order_release);
+            ++AliveCount;
+            return {slot, entry.Generation.load(std::memory_order_relaxed)};
+        }
+
+        /**
+         * 释放槽位，所有指向该槽位的句柄随即失效
+         * @param handle 句柄
+         */
+        static void Release(const ObjectHandle handle) {
+            if (handle.IsNull()) return;
+            std::lock_guard lock(Mutex);
+            Entry &entry = At(handle.Slot);
+            if (entry.Generation.load(std::memory_order_relaxed) != handle.Generation) return;
+            auto next = handle.Generation + 1;
+            if (next == 0) next = 1; // 跳过空句柄的代数
+            entry.Generation.store(next, std::memory_order_release);
+            entry.Ptr.store(nullptr, std::memory_order_release);
+            FreeSlots.push_back(handle.Slot);
+            --AliveCount;
+        }
+
+        /**
+         * 查询句柄对应的对象
+         * @param handle 句柄
+         * @return 对象存活则返回其指针，否则返回<code>nullptr</code>
+         */
+        static Object *Resolve(const ObjectHandle handle) {
+            if (handle.IsNull()) return nullptr;
+            const auto page_index = handle.Slot >> PageBits;
+            if (page_index >= MaxPages) return nullptr;
+            const auto page = Pages[page_index].load(std::memory_order_acquire);
+            if (page == nullptr) return nullptr;
+            const Entry &entry = page[handle.Slot & (PageSize - 1)];
+            if (entry.Generation.load(std::memory_order_acquire) != handle.Generation) return nullptr;
+            const auto ptr = entry.Ptr.load(std::memory_order_acquire);
+            // 读取指针期间槽位可能已被释放并复用，再次确认代数
+            if (entry.Generation.load(std::memory_order_acquire) != handle.Generation) return nullptr;
+            return ptr;
+        }
+
+        /// 句柄是否有效
+        static bool IsAlive(const ObjectHandle handle) {
+            return Resolve(handle) != nullptr;
+        }
+
+        /// 当前存活的对象数量
+        static std::uint32_t GetAliveCount() {
+            std::lock_guard lock(Mutex);
+            return AliveCount;
+        }
+
+    private:
+        struct Entry {
+            std::atomic<std::uint32_t> Generation{1};
+            std::atomic<Object *> Ptr{nullptr};
+        };
+
+        static Entry &At(const std::uint32_t slot) {
+            return Pages[slot >> PageBits].load(std::memory_order_relaxed)[slot & (PageSize - 1)];
+        }
+
+        static std::array<std::atomic<Entry *>, MaxPages> Pages;
+        static std::mutex Mutex;
+        static std::vector<std::uint32_t> FreeSlots;
+        static std::uint32_t NextSlot;
+        static std::uint32_t AliveCount;
+    };
+
+    std::array<std::atomic<HandleTable::Entry *>, HandleTable::MaxPages> HandleTable::Pages{};
+    std::mutex HandleTable::Mutex;
+    std::vector<std::uint32_t> HandleTable::FreeSlots;
+    std::uint32_t HandleTable::NextSlot = 0;
+    std::uint32_t HandleTable::AliveCount = 0;
+
+    /**
+     * @brief 类型化句柄
+     * @remark 可安全地长期保存，对象销毁后Get()返回<code>nullptr</code>
+     * @tparam T Object的子类
+     */
+    export template<class T>
+    class Handle {
+    public:
+        Handle() = default;
+
+        Handle(std::nullptr_t) {
+        }
+
+        Handle(T *obj) {
+            if (obj != nullptr) Raw = obj->GetHandle();
+        }
+
+        /// 从无类型句柄构造（调用者需保证类型正确）
+        static Handle FromRaw(const ObjectHandle raw) {
+            Handle h;
+            h.Raw = raw;
+            return h;
+        }
+
+        /// 对象存活则返回其指针，否则返回<code>nullptr</code>
+        T *Get() const {
+            return static_cast<T *>(HandleTable::Resolve(Raw));
+        }
+
+        T *operator->() const { return Get(); }
+
+        explicit operator bool() const { return Get() != nullptr; }
+
+        bool operator==(const Handle &) const = default;
+
+        bool operator==(const T *obj) const { return Get() == obj; }
+
+        /// @property Raw
+        ObjectHandle GetRaw() const { return Raw; }
+
+    private:
+        ObjectHandle Raw;
+    };
+}
@@ -7,6 +7,7 @@
  */
 
 export module CEngine.Base:Object;
+export import :Handle;
 import std;
 
 namespace CEngine {
@@ -14,33 +15,49 @@ namespace CEngine {
         * @class Object
         * @brief 基类
         * @remark 建议成员添加静态字符串成员TAG\n
-        * @note 已实现判断对象指针是否可用\n
+        * @note 每个对象在HandleTable中占有一个槽位，可通过Handle&lt;T&gt;安全地保存引用并判断对象是否可用\n
         */
     export class Object {
     public:
         const static char *TAG;
 
-        Object() {
-            _addr_.insert(this);
+        Object() : Self(HandleTable::Allocate(this)) {
+        }
+
+        /// 复制出的对象是新对象，拥有自己的句柄
+        Object(const Object &) : Object() {
+        }
+
+        /// 句柄与对象地址绑定，赋值不改变句柄
+        Object &operator=(const Object &) {
+            return *this;
         }
 
         virtual ~Object() {
-            _addr_.erase(this);
+            HandleTable::Release(Self);
         }
 
+        /// @property Handle
+        ObjectHandle GetHandle() const { return Self; }
+
         /**
-        * 判断是否可用
+        * 判断句柄是否可用
         * @return 可以返回<code>true</code>，不可用返回<code>false</code>
+        * @remark O(1)，无哈希；对空句柄与已销毁对象的句柄均返回<code>false</code>
         */
-        bool IsValid() {
-            return _addr_.contains(this);
+        static bool IsValid(const ObjectHandle handle) {
+            return HandleTable::IsAlive(handle);
+        }
+
+        template<class T>
+        static bool IsValid(const Handle<T> &handle) {
+            return HandleTable::IsAlive(handle.GetRaw());
         }
 
     private:
-        /// @brief 用于存储实例化的对象地址
-        static std::unordered_set<Object *> _addr_;
+        /// @brief 自身的句柄
+        ObjectHandle Self;
     };
 
     const char *Object::TAG = "Object";
-    std::unordered_set<Object *> Object::_addr_;
 }
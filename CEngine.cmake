@@ -1,5 +1,14 @@
 include_directories("CEngine/ThirdParty/include")
 
+# 引擎头文件（模块无法导出的宏，如Utils/Profiler.h）
+include_directories("CEngine")
+
+# CPU性能分析，关闭时CE_PROFILE_*宏展开为空
+option(CENGINE_PROFILER "启用CPU性能分析" ON)
+if (CENGINE_PROFILER)
+    add_compile_definitions(CE_PROFILER)
+endif ()
+
 # glad库
 include_directories("CEngine/ThirdParty/glad/include")
 file(GLOB glad_source "CEngine/ThirdParty/glad/src/*.c")
@@ -46,6 +55,15 @@ target_link_libraries(
         std_modules
 )
 
+# CPU性能分析
+add_library(Profiler)
+target_sources(Profiler PUBLIC FILE_SET CXX_MODULES FILES "CEngine/Utils/Profiler.ixx")
+target_link_libraries(
+        Profiler
+        std_modules
+        Logger
+)
+
 # 事件类
 add_library(Event)
 target_sources(Event PUBLIC FILE_SET CXX_MODULES FILES "CEngine/Utils/Event.ixx")
@@ -55,6 +73,31 @@ target_link_libraries(
         Base
 )
 
+# 线程池
+add_library(ThreadPool)
+target_sources(ThreadPool PUBLIC FILE_SET CXX_MODULES FILES "CEngine/Utils/ThreadPool.ixx")
+target_link_libraries(
+        ThreadPool
+        std_modules
+        Profiler
+)
+
+# 哈希
+add_library(Hash)
+target_sources(Hash PUBLIC FILE_SET CXX_MODULES FILES "CEngine/Utils/Hash.ixx")
+target_link_libraries(
+        Hash
+        std_modules
+)
+
+# 内存映射文件
+add_library(MappedFile)
+target_sources(MappedFile PUBLIC FILE_SET CXX_MODULES FILES "CEngine/Utils/MappedFile.ixx")
+target_link_libraries(
+        MappedFile
+        std_modules
+)
+
 # 渲染单位
 add_library(Render)
 file(GLOB render_sources "CEngine/Render/*.ixx")
@@ -67,6 +110,9 @@ target_link_libraries(
         Utils
         Image
         Event
+        ThreadPool
+        Hash
+        Profiler
 )
 
 # 图像相关
@@ -79,6 +125,9 @@ target_link_libraries(
         glad
         Utils
         Logger
+        MappedFile
+        ThreadPool
+        Hash
 )
 
 # Node系列
@@ -92,6 +141,7 @@ target_link_libraries(
         Logger
         Utils
         Render
+        Profiler
 )
 
 # 模型导入器
@@ -101,6 +151,23 @@ target_link_libraries(
         ModelImporter
         Node
         Render
+        Image
+        ModelCooker
+        ThreadPool
+        Profiler
+        ${assimp}
+)
+
+# 模型烘焙
+add_library(ModelCooker)
+target_sources(ModelCooker PUBLIC FILE_SET CXX_MODULES FILES "CEngine/Utils/ModelCooker.ixx")
+target_link_libraries(
+        ModelCooker
+        std_modules
+        Logger
+        MappedFile
+        Hash
+        Render
         ${assimp}
 )
 
@@ -139,6 +206,7 @@ target_link_libraries(
         Engine
         UI
         Logger
+        Profiler
 )
 
 # Behaviour预设
@@ -165,6 +233,7 @@ target_link_libraries(
         Utils
         BehaviourPresets
         Engine
+        Profiler
 )
 
 # 引擎主模块
@@ -181,6 +250,8 @@ target_link_libraries(
         Event
         Node
         UI
+        ModelImporter
+        Profiler
 )
 
 # 构建后处理
@@ -11,6 +11,7 @@ module;
 #include <glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/ext/matrix_transform.hpp>
+#include "Utils/Profiler.h"
 export module CEngine.Engine;
 import std;
 import CEngine.Base;
@@ -19,6 +20,8 @@ import CEngine.Event;
 import CEngine.Node;
 import CEngine.Render;
 import CEngine.UI;
+import CEngine.ModelImporter;
+import CEngine.Profiler;
 
 namespace CEngine {
     /**
@@ -47,7 +50,7 @@ namespace CEngine {
         */
         void Loop();
         /**
-         * 每绘制一次调用(即Mesh.Render函数后)
+         * 每帧绘制结束后调用(即RenderQueue.Flush函数后)
          */
         void DrawCallEnd();
         /**
@@ -60,18 +63,28 @@ namespace CEngine {
 
         void LoadAllPresets() const;
 
+        /**
+         * 启用连续变换存储
+         * @remark 已有节点与之后创建的Node3D的变换均存放于同一TransformStorage中，\n
+         * 每帧以一次线性扫描计算全部世界矩阵，适用于节点数量巨大的场景
+         */
+        void EnableTransformStorage();
+
         /// @property RootNode
         Node3D *getRoot() const { return RootNode; }
 
         /// @property ToolNode
         Node3D *getToolNode() const { return ToolNode; }
 
+        /// @property Queue
+        const RenderQueue &getRenderQueue() const { return Queue; }
+
         /// @property window
         GLFWwindow *getWindow() const { return window; }
 
         /// @property ui
         void setUI(UI *u) {
-            if (!ui->IsValid())
+            if (ui == nullptr)
                 u->InitUI();
             ui = u;
         }
@@ -100,6 +113,15 @@ namespace CEngine {
         /// Ready时添加飞行相机
         bool AddFlyCamera3DWhenReady = false;
 
+        /// 每帧异步纹理上传的时间预算(ms)
+        double TextureUploadBudget = 2.0;
+
+        /// 每帧异步模型导入（创建网格）的时间预算(ms)
+        double ModelImportBudget = 4.0;
+
+        /// 每帧取得异步着色器编译结果的时间预算(ms)，并行编译可用时通常不会用尽
+        double ShaderCompileBudget = 4.0;
+
     private:
         Engine();
         /// @brief 引擎实例对象指针
@@ -107,13 +129,19 @@ namespace CEngine {
         /// @brief 窗口对象指针<code>GLFWwindow</code>
         GLFWwindow *window;
         /// @brief UI
-        UI *ui;
+        UI *ui = nullptr;
+        /// @brief 变换存储（需在节点之前构造）
+        TransformStorage Transforms;
+        /// @brief 场景索引（需在节点之前构造）
+        SceneIndex Scene;
+        /// @brief 渲染队列
+        RenderQueue Queue;
         /// @brief 节点根目录
         Node3D *RootNode = Node3D::Create();
         /// 工具节点
         Node3D *ToolNode = Node3D::Create();
         /// 相机
-        Camera *CurrentCamera;
+        Handle<Camera> CurrentCamera;
 
         /**
         * 当引擎准备就绪时
@@ -141,15 +169,18 @@ namespace CEngine {
     Engine::Engine() {
         Ins = this;
         window = nullptr;
+        CE_PROFILE_THREAD("Main");
         glfwInit();
         glfwWindowHint(GLFW_VERSION_MAJOR, 4);
         glfwWindowHint(GLFW_VERSION_MINOR, 6);
         RootNode->setName("Root");
         ToolNode->setName("ToolNode");
+        RootNode->EnterScene(&Scene);
+        ToolNode->EnterScene(&Scene);
     }
 
     Engine *Engine::GetIns() {
-        if (Ins->IsValid())
+        if (Ins != nullptr)
             return Ins;
         Ins = new Engine();
         return Ins;
@@ -174,6 +205,8 @@ namespace CEngine {
             return false;
         }
         LogS(TAG) << "GLAD加载成功.";
+        Texture::DetectCompressionSupport();
+        ShaderProgram::DetectParallelCompileSupport(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
         return true;
     }
 
@@ -181,22 +214,25 @@ namespace CEngine {
         Ready();
         double DeltaTime = 0;
         while (!glfwWindowShouldClose(window)) {
+            CE_PROFILE_FRAME_BEGIN();
             DeltaTime = Process(DeltaTime);
             Event_Process.Invoke(DeltaTime);
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+            {
+                CE_PROFILE_ZONE("SwapBuffers");
+                glfwSwapBuffers(window);
+            }
+            {
+                CE_PROFILE_ZONE("PollEvents");
+                glfwPollEvents();
+            }
+            CE_PROFILE_FRAME_END();
         }
         Destroy();
     }
 
     void Engine::DrawCallEnd() {
+        // 绑定状态由GLState缓存，无需解绑
         Texture::ResetTextureSlot();
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-        glUseProgram(0);
     }
 
     void Engine::Exit() const {
@@ -215,7 +251,9 @@ namespace CEngine {
         glGetIntegerv(GL_MAX_UNIFORM_LOCATIONS, &maxUniformLocations);
         LogI(TAG) << "当前设备最大Uniform数量: " << maxUniformLocations;
         // 背面剔除
-        glEnable(GL_CULL_FACE);
+        GLState::Enable(GL_CULL_FACE);
+        // 深度测试（渲染队列按由近到远提交不透明物体）
+        GLState::Enable(GL_DEPTH_TEST);
         // 订阅Camera激活事件
         Camera::Event_CameraActivated += [&](Camera *cam) {
             this->CurrentCamera = cam;
@@ -226,8 +264,10 @@ namespace CEngine {
     }
 
     double Engine::Process(const double DeltaTime) {
+        CE_PROFILE_ZONE("Engine::Process");
         // 计时开始
         const double time = glfwGetTime();
+        GPUProfiler::BeginFrame();
         // 设置清空颜色
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         // 清空颜色缓冲区
@@ -236,38 +276,90 @@ namespace CEngine {
         glClear(GL_DEPTH_BUFFER_BIT);
         // 重置纹理槽
         Texture::ResetTextureSlot();
+        {
+            CE_PROFILE_ZONE("Uploads");
+            GPUProfileScope scope("Uploads");
+            // 异步纹理上传
+            Texture::ProcessUploads(TextureUploadBudget);
+            // 异步着色器编译
+            ShaderProgram::ProcessPendingPrograms(ShaderCompileBudget);
+            // 异步模型导入
+            ModelImporter::process_imports(ModelImportBudget);
+        }
         // 获得视图矩阵和透视矩阵
         glm::mat4 viewM, projectM;
-        if (CurrentCamera->IsValid()) {
-            viewM = CurrentCamera->GetViewMatrix();
-            projectM = CurrentCamera->GetProjectionMatrix();
+        if (const auto camera = CurrentCamera.Get(); camera != nullptr) {
+            viewM = camera->GetViewMatrix();
+            projectM = camera->GetProjectionMatrix();
         } else {
             viewM = glm::mat4(1.f);
             projectM = glm::mat4(1.f);
         }
         // projectM = glm::scale(glm::mat4(1.f), glm::vec3(9.f / 16.f, 1.f, 1.f));
-        std::stack<Node *> stack;
-        stack.push(ToolNode);
-        stack.push(RootNode);
-        while (!stack.empty()) {
-            Node *node = stack.top();
-            stack.pop();
-            if (node->GetChildCount() > 0)
-                for (const auto child: node->GetChildren())
-                    stack.push(child);
-            if (const auto behaviour = node->GetBehaviour(); behaviour != nullptr)
-                behaviour->Process(DeltaTime);
-            if (const auto ru3d = dynamic_cast<RenderUnit3D *>(node); ru3d != nullptr) {
-                ru3d->Render(viewM, projectM);
-                DrawCallEnd();
+        // Behaviour处理（遍历期间节点树可被修改）
+        {
+            CE_PROFILE_ZONE("Behaviours");
+            Scene.BeginIteration();
+            const auto &behaviour_nodes = Scene.GetBehaviourNodes();
+            for (std::size_t i = 0, count = behaviour_nodes.size(); i < count; ++i) {
+                if (behaviour_nodes[i] == nullptr) continue;
+                // 持有副本，防止Behaviour在处理中被替换而析构
+                if (const auto behaviour = behaviour_nodes[i]->GetBehaviour(); behaviour != nullptr)
+                    behaviour->Process(DeltaTime);
+            }
+            Scene.EndIteration();
+        }
+        // 自上而下刷新世界变换矩阵（帧内后续的修改由GetWorldMatrix按需刷新）
+        {
+            CE_PROFILE_ZONE("Transforms");
+            RootNode->ResolveWorldMatrices();
+            ToolNode->ResolveWorldMatrices();
+        }
+        // 帧常量
+        FrameConstants constants;
+        constants.View = viewM;
+        constants.Projection = projectM;
+        constants.ViewProjection = projectM * viewM;
+        constants.CameraPosition = glm::vec4(glm::vec3(glm::inverse(viewM)[3]), 1.0f);
+        int framebuffer_width, framebuffer_height;
+        glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+        constants.ScreenSize = glm::vec2(framebuffer_width, framebuffer_height);
+        constants.Time = static_cast<float>(time);
+        constants.DeltaTime = static_cast<float>(DeltaTime);
+        // 渲染：收集渲染包，排序后统一提交
+        {
+            CE_PROFILE_ZONE("Scene");
+            GPUProfileScope scope("Scene");
+            Queue.Clear();
+            Queue.SetFrameConstants(constants);
+            {
+                CE_PROFILE_ZONE("Submit");
+                for (const auto ru3d: Scene.GetRenderables())
+                    ru3d->Submit(Queue, viewM, projectM);
             }
+            Queue.Sort();
+            Queue.Flush();
+            DrawCallEnd();
+        }
+        {
+            CE_PROFILE_ZONE("UI");
+            GPUProfileScope scope("UI");
+            ui->ProcessUI();
         }
-        ui->ProcessUI();
+        // ImGui会修改GL状态
+        GLState::Invalidate();
+        GPUProfiler::EndFrame();
         return (glfwGetTime() - time) * 1000.0;
     }
 
     void Engine::Destroy() {
         Event_Destroy.Invoke();
+        Queue.Release();
+        MeshArena::Release();
+        MaterialPool::Release();
+        TextureAtlas::Release();
+        Texture::ReleaseUploads();
+        GPUProfiler::Release();
         glfwDestroyWindow(window);
         glfwTerminate();
         delete RootNode;
@@ -277,6 +369,13 @@ namespace CEngine {
         delete this;
     }
 
+    void Engine::EnableTransformStorage() {
+        Node3D::SetDefaultTransformStorage(&Transforms);
+        RootNode->AdoptTransformStorage(&Transforms);
+        ToolNode->AdoptTransformStorage(&Transforms);
+        LogI(TAG) << "已启用连续变换存储";
+    }
+
     std::pair<int, int> Engine::GetScreenSize() const {
         int _window_width, _window_height;
         glfwGetWindowSize(window, &_window_width, &_window_height);
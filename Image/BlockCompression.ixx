@@ -0,0 +1,427 @@
+/**
+ * @file BlockCompression.ixx
+ * @brief BCn块压缩编码
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+export module CEngine.Image:BlockCompression;
+import std;
+import CEngine.Logger;
+import CEngine.ThreadPool;
+
+namespace CEngine {
+    /// 块压缩格式（数值写入.cetex，不可更改）
+    export enum class BlockFormat : std::uint32_t {
+        NONE = 0,
+        BC1 = 1, // RGB，4bpp
+        BC3 = 3, // RGBA（BC1颜色 + BC4 Alpha），8bpp
+        BC4 = 4, // 单通道，4bpp
+        BC5 = 5, // 双通道（RG），8bpp
+        BC7 = 7  // RGBA（模式6），8bpp
+    };
+
+    /**
+     * @brief 纹理用途
+     * @remark 决定压缩格式与取用的通道：\n
+     * Normal压缩为BC5（只保留XY，着色器中以<code>sqrt(1 - dot(xy, xy))</code>重建Z）；\n
+     * Mask/Roughness/Metalness压缩为BC4，三通道以上的图片分别取R/G/B（glTF的金属度-粗糙度贴图约定）；\n
+     * 通道约定：无论是否压缩、是否位于图集，着色器都从原通道取值（Roughness取.g，Metalness取.b，单通道图片取.r），\n
+     * 由G/B压缩的BC4纹理上传时以GL_TEXTURE_SWIZZLE_G/B映射回原通道
+     */
+    export enum class TextureUsage : std::uint32_t {
+        Color,
+        Normal,
+        Mask,
+        Roughness,
+        Metalness
+    };
+
+    /// 压缩方式
+    export struct BlockEncoding {
+        BlockFormat Format = BlockFormat::NONE;
+        /// @brief BC4/BC5读取的首个通道
+        std::uint32_t FirstChannel = 0;
+    };
+
+    /**
+     * @brief BCn块压缩编码器
+     * @remark 以4x4像素块为单位编码，各块行在线程池中并行处理；\n
+     * 端点取像素在主轴（协方差矩阵幂迭代求得）上投影的两端，再逐像素选取最近的调色板索引
+     */
+    export class BlockCompressor {
+    public:
+        const static char *TAG;
+
+        BlockCompressor() = delete;
+
+        static void SetEnabled(const bool enabled) { Enabled = enabled; }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /**
+         * 设置S3TC（BC1/BC3）是否可用
+         * @remark S3TC不是核心功能，不可用时RGB颜色贴图改用BC7
+         */
+        static void SetS3TCAvailable(const bool available) { S3TCAvailable = available; }
+
+        static bool IsS3TCAvailable() { return S3TCAvailable; }
+
+        /// 每块字节数
+        static std::uint32_t GetBlockBytes(const BlockFormat format) {
+            return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+        }
+
+        /// 压缩后的大小（字节）
+        static std::uint64_t GetCompressedSize(const BlockFormat format, const std::uint32_t width, const std::uint32_t height) {
+            return static_cast<std::uint64_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(format);
+        }
+
+        /**
+         * 按通道数与用途选择压缩方式
+         * @param channels 通道数
+         * @param usage 用途
+         */
+        static BlockEncoding ChooseEncoding(const std::uint32_t channels, const TextureUsage usage) {
+            switch (usage) {
+                case TextureUsage::Normal: return {channels >= 2 ? BlockFormat::BC5 : BlockFormat::BC4, 0};
+                case TextureUsage::Mask: return {BlockFormat::BC4, 0};
+                case TextureUsage::Roughness: return {BlockFormat::BC4, channels >= 3 ? 1u : 0u};
+                case TextureUsage::Metalness: return {BlockFormat::BC4, channels >= 3 ? 2u : 0u};
+                default: break;
+            }
+            switch (channels) {
+                case 1: return {BlockFormat::BC4, 0};
+                case 2: return {BlockFormat::BC5, 0};
+                case 3: return {S3TCAvailable ? BlockFormat::BC1 : BlockFormat::BC7, 0};
+                default: return {BlockFormat::BC7, 0};
+            }
+        }
+
+        /**
+         * 压缩
+         * @param data 像素数据（8位每通道，行紧密排列）
+         * @param width 宽
+         * @param height 高
+         * @param channels 通道数（1~4）
+         * @param encoding 压缩方式
+         * @return 压缩后的块数据（块按行优先排列）
+         */
+        static std::vector<unsigned char> Compress(const unsigned char *data, const std::uint32_t width, const std::uint32_t height,
+                                                   const std::uint32_t channels, const BlockEncoding encoding) {
+            const auto block_bytes = GetBlockBytes(encoding.Format);
+            const auto blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+            std::vector<unsigned char> out(GetCompressedSize(encoding.Format, width, height));
+            ThreadPool::Global().ParallelFor(blocks_y, [&](const std::size_t by) {
+                Pixels block;
+                for (std::uint32_t bx = 0; bx < blocks_x; ++bx) {
+                    FetchBlock(data, width, height, channels, bx * 4, static_cast<std::uint32_t>(by) * 4, block);
+                    auto dst = out.data() + (by * blocks_x + bx) * block_bytes;
+                    switch (encoding.Format) {
+                        case BlockFormat::BC1: EncodeBC1(block, channels, dst); break;
+                        case BlockFormat::BC3:
+                            EncodeBC4(block, 3, dst);
+                            EncodeBC1(block, channels, dst + 8);
+                            break;
+                        case BlockFormat::BC4: EncodeBC4(block, encoding.FirstChannel, dst); break;
+                        case BlockFormat::BC5:
+                            EncodeBC4(block, encoding.FirstChannel, dst);
+                            EncodeBC4(block, encoding.FirstChannel + 1, dst + 8);
+                            break;
+                        case BlockFormat::BC7: EncodeBC7(block, channels, dst); break;
+                        default: break;
+                    }
+                }
+            });
+            return out;
+        }
+
+        /**
+         * 解码BC1块（四色模式，用于校验编码结果）
+         * @param in 8字节的块
+         * @return 16个像素的RGB
+         */
+        static std::array<std::array<float, 3>, 16> DecodeBC1(const unsigned char *in) {
+            const auto c0 = static_cast<std::uint16_t>(in[0] | in[1] << 8), c1 = static_cast<std::uint16_t>(in[2] | in[3] << 8);
+            const auto p0 = From565(c0), p1 = From565(c1);
+            std::array<std::array<float, 3>, 4> palette{p0, p1};
+            for (std::uint32_t c = 0; c < 3; ++c) {
+                palette[2][c] = (2.0f * p0[c] + p1[c]) / 3.0f;
+                palette[3][c] = (p0[c] + 2.0f * p1[c]) / 3.0f;
+            }
+            const auto bits = static_cast<std::uint32_t>(in[4] | in[5] << 8 | in[6] << 16 | in[7] << 24);
+            std::array<std::array<float, 3>, 16> pixels;
+            for (std::uint32_t i = 0; i < 16; ++i) pixels[i] = c0 == c1 ? p0 : palette[bits >> (i * 2) & 3];
+            return pixels;
+        }
+
+        /**
+         * 自检：色度块（亮度方向上无方差的红/绿棋盘）经BC1编码后解码，检查误差
+         * @remark 主轴与(1,1,1)正交的块曾被压成单一颜色，此自检防止回退
+         * @return 最大通道误差在容差内返回<code>true</code>
+         */
+        static bool SelfTest() {
+            std::array<unsigned char, 4 * 4 * 3> pixels{};
+            for (std::uint32_t i = 0; i < 16; ++i)
+                pixels[i * 3 + ((i % 4 + i / 4) % 2 == 0 ? 0 : 1)] = 255;
+            const auto encoded = Compress(pixels.data(), 4, 4, 3, {BlockFormat::BC1, 0});
+            const auto decoded = DecodeBC1(encoded.data());
+            float error = 0.0f;
+            for (std::uint32_t i = 0; i < 16; ++i)
+                for (std::uint32_t c = 0; c < 3; ++c)
+                    error = std::max(error, std::abs(decoded[i][c] - static_cast<float>(pixels[i * 3 + c])));
+            if (error > 8.0f) {
+                LogE(TAG) << "BC1色度块往返误差过大: " << error;
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        /// 4x4块的像素（RGBA，缺失通道按R8/RG8/RGB8的采样结果补齐）
+        using Pixels = std::array<std::array<float, 4>, 16>;
+
+        static void FetchBlock(const unsigned char *data, const std::uint32_t width, const std::uint32_t height, const std::uint32_t channels,
+                               const std::uint32_t x0, const std::uint32_t y0, Pixels &block) {
+            for (std::uint32_t i = 0; i < 16; ++i) {
+                // 边缘不足4像素的块重复最后一行/列
+                const auto x = std::min(x0 + i % 4, width - 1), y = std::min(y0 + i / 4, height - 1);
+                const auto src = data + (static_cast<std::size_t>(y) * width + x) * channels;
+                for (std::uint32_t c = 0; c < 4; ++c)
+                    block[i][c] = c < channels ? src[c] : c == 3 ? 255.0f : 0.0f;
+            }
+        }
+
+        /**
+         * 主轴拟合端点
+         * @tparam N 参与拟合的通道数
+         */
+        template<std::uint32_t N>
+        static void FitEndpoints(const Pixels &block, std::array<float, N> &e0, std::array<float, N> &e1) {
+            std::array<float, N> mean{};
+            for (const auto &p: block)
+                for (std::uint32_t c = 0; c < N; ++c) mean[c] += p[c] / 16.0f;
+            std::array<std::array<float, N>, N> cov{};
+            for (const auto &p: block)
+                for (std::uint32_t i = 0; i < N; ++i)
+                    for (std::uint32_t j = 0; j < N; ++j)
+                        cov[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]);
+            // 幂迭代求主轴，以方差最大的通道所在的协方差行为初值（对角线初值与(1,1,1)正交的方差上无法收敛）
+            std::uint32_t seed = 0;
+            for (std::uint32_t i = 1; i < N; ++i)
+                if (cov[i][i] > cov[seed][seed]) seed = i;
+            std::array<float, N> axis = cov[seed];
+            float seed_length = 0.0f;
+            for (const auto v: axis) seed_length += v * v;
+            if (seed_length < 1e-12f) {
+                // 纯色块
+                for (std::uint32_t c = 0; c < N; ++c) e0[c] = e1[c] = std::clamp(mean[c], 0.0f, 255.0f);
+                return;
+            }
+            seed_length = std::sqrt(seed_length);
+            for (auto &v: axis) v /= seed_length;
+            for (int iteration = 0; iteration < 8; ++iteration) {
+                std::array<float, N> next{};
+                for (std::uint32_t i = 0; i < N; ++i)
+                    for (std::uint32_t j = 0; j < N; ++j)
+                        next[i] += cov[i][j] * axis[j];
+                float length = 0.0f;
+                for (const auto v: next) length += v * v;
+                if (length < 1e-12f) break;
+                length = std::sqrt(length);
+                for (std::uint32_t i = 0; i < N; ++i) axis[i] = next[i] / length;
+            }
+            float t_min = 0.0f, t_max = 0.0f;
+            for (const auto &p: block) {
+                float t = 0.0f;
+                for (std::uint32_t c = 0; c < N; ++c) t += (p[c] - mean[c]) * axis[c];
+                t_min = std::min(t_min, t);
+                t_max = std::max(t_max, t);
+            }
+            if (t_max - t_min < 1.0f) {
+                // 迭代退化：改用包围盒对角线（各通道的最小值到最大值）
+                for (std::uint32_t c = 0; c < N; ++c) {
+                    e0[c] = 255.0f;
+                    e1[c] = 0.0f;
+                }
+                for (const auto &p: block)
+                    for (std::uint32_t c = 0; c < N; ++c) {
+                        e0[c] = std::min(e0[c], p[c]);
+                        e1[c] = std::max(e1[c], p[c]);
+                    }
+                return;
+            }
+            for (std::uint32_t c = 0; c < N; ++c) {
+                e0[c] = std::clamp(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+                e1[c] = std::clamp(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+            }
+        }
+
+        /// 在调色板中为每个像素选取最近的索引
+        template<std::uint32_t N, std::size_t P>
+        static std::array<std::uint32_t, 16> SelectIndices(const Pixels &block, const std::array<std::array<float, N>, P> &palette,
+                                                           const std::uint32_t first_channel = 0) {
+            std::array<std::uint32_t, 16> indices{};
+            for (std::uint32_t i = 0; i < 16; ++i) {
+                float best = std::numeric_limits<float>::max();
+                for (std::uint32_t k = 0; k < P; ++k) {
+                    float error = 0.0f;
+                    for (std::uint32_t c = 0; c < N; ++c) {
+                        const auto d = block[i][first_channel + c] - palette[k][c];
+                        error += d * d;
+                    }
+                    if (error < best) {
+                        best = error;
+                        indices[i] = k;
+                    }
+                }
+            }
+            return indices;
+        }
+
+        static std::uint16_t To565(const std::array<float, 3> &color) {
+            const auto r = static_cast<std::uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+            const auto g = static_cast<std::uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+            const auto b = static_cast<std::uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+            return static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+        }
+
+        static std::array<float, 3> From565(const std::uint16_t color) {
+            const auto r = color >> 11 & 31u, g = color >> 5 & 63u, b = color & 31u;
+            return {static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2)};
+        }
+
+        /// BC1（总使用四色模式，BC3中的颜色块同样适用）
+        static void EncodeBC1(const Pixels &block, const std::uint32_t channels, unsigned char *out) {
+            std::array<float, 3> e0, e1;
+            if (channels >= 3) FitEndpoints<3>(block, e0, e1);
+            else {
+                // 灰度：R=G=B
+                Pixels gray = block;
+                for (auto &p: gray) p[1] = p[2] = p[0];
+                FitEndpoints<3>(gray, e0, e1);
+            }
+            auto c0 = To565(e1), c1 = To565(e0);
+            if (c0 < c1) std::swap(c0, c1);
+            std::uint32_t bits = 0;
+            if (c0 != c1) {
+                const auto p0 = From565(c0), p1 = From565(c1);
+                std::array<std::array<float, 3>, 4> palette;
+                for (std::uint32_t c = 0; c < 3; ++c) {
+                    palette[0][c] = p0[c];
+                    palette[1][c] = p1[c];
+                    palette[2][c] = (2.0f * p0[c] + p1[c]) / 3.0f;
+                    palette[3][c] = (p0[c] + 2.0f * p1[c]) / 3.0f;
+                }
+                const auto indices = SelectIndices<3>(block, palette);
+                for (std::uint32_t i = 0; i < 16; ++i) bits |= indices[i] << (i * 2);
+            }
+            out[0] = static_cast<unsigned char>(c0 & 0xFF);
+            out[1] = static_cast<unsigned char>(c0 >> 8);
+            out[2] = static_cast<unsigned char>(c1 & 0xFF);
+            out[3] = static_cast<unsigned char>(c1 >> 8);
+            for (std::uint32_t i = 0; i < 4; ++i) out[4 + i] = static_cast<unsigned char>(bits >> (i * 8) & 0xFF);
+        }
+
+        /// BC4（八值模式）
+        static void EncodeBC4(const Pixels &block, const std::uint32_t channel, unsigned char *out) {
+            float low = 255.0f, high = 0.0f;
+            for (const auto &p: block) {
+                low = std::min(low, p[channel]);
+                high = std::max(high, p[channel]);
+            }
+            const auto r0 = static_cast<std::uint32_t>(std::lround(high)), r1 = static_cast<std::uint32_t>(std::lround(low));
+            std::uint64_t bits = 0;
+            if (r0 != r1) {
+                std::array<std::array<float, 1>, 8> palette;
+                palette[0][0] = static_cast<float>(r0);
+                palette[1][0] = static_cast<float>(r1);
+                for (std::uint32_t k = 2; k < 8; ++k)
+                    palette[k][0] = static_cast<float>((8 - k) * r0 + (k - 1) * r1) / 7.0f;
+                const auto indices = SelectIndices<1>(block, palette, channel);
+                for (std::uint32_t i = 0; i < 16; ++i) bits |= static_cast<std::uint64_t>(indices[i]) << (i * 3);
+            }
+            out[0] = static_cast<unsigned char>(r0);
+            out[1] = static_cast<unsigned char>(r1);
+            for (std::uint32_t i = 0; i < 6; ++i) out[2 + i] = static_cast<unsigned char>(bits >> (i * 8) & 0xFF);
+        }
+
+        /// 按位写入128位块
+        struct BitWriter {
+            std::array<std::uint64_t, 2> Words{};
+            std::uint32_t Position = 0;
+
+            void Write(const std::uint64_t value, const std::uint32_t bits) {
+                for (std::uint32_t i = 0; i < bits; ++i, ++Position)
+                    Words[Position / 64] |= (value >> i & 1u) << (Position % 64);
+            }
+        };
+
+        /// BC7模式6：单子集RGBA，7位端点 + 每端点1个P位，4位索引
+        static void EncodeBC7(const Pixels &block, const std::uint32_t channels, unsigned char *out) {
+            std::array<float, 4> e0, e1;
+            if (channels >= 3) FitEndpoints<4>(block, e0, e1);
+            else {
+                Pixels gray = block;
+                for (auto &p: gray) p[1] = p[2] = p[0];
+                FitEndpoints<4>(gray, e0, e1);
+            }
+            // 量化端点，P位取误差较小者
+            std::array<std::array<std::uint32_t, 4>, 2> q;
+            std::array<std::uint32_t, 2> pbit;
+            std::array<std::array<float, 4>, 2> endpoints;
+            const std::array<const std::array<float, 4> *, 2> source = {&e0, &e1};
+            for (std::uint32_t e = 0; e < 2; ++e) {
+                float best = std::numeric_limits<float>::max();
+                for (std::uint32_t p = 0; p < 2; ++p) {
+                    float error = 0.0f;
+                    std::array<std::uint32_t, 4> candidate;
+                    for (std::uint32_t c = 0; c < 4; ++c) {
+                        candidate[c] = static_cast<std::uint32_t>(std::clamp(std::lround(((*source[e])[c] - static_cast<float>(p)) / 2.0f), 0l, 127l));
+                        const auto d = static_cast<float>(candidate[c] << 1 | p) - (*source[e])[c];
+                        error += d * d;
+                    }
+                    if (error < best) {
+                        best = error;
+                        q[e] = candidate;
+                        pbit[e] = p;
+                    }
+                }
+                for (std::uint32_t c = 0; c < 4; ++c) endpoints[e][c] = static_cast<float>(q[e][c] << 1 | pbit[e]);
+            }
+            static constexpr std::array<std::uint32_t, 16> Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+            std::array<std::array<float, 4>, 16> palette;
+            for (std::uint32_t k = 0; k < 16; ++k)
+                for (std::uint32_t c = 0; c < 4; ++c)
+                    palette[k][c] = static_cast<float>(((64 - Weights[k]) * static_cast<std::uint32_t>(endpoints[0][c]) +
+                                                        Weights[k] * static_cast<std::uint32_t>(endpoints[1][c]) + 32) >> 6);
+            auto indices = SelectIndices<4>(block, palette);
+            // 首个像素的索引最高位隐含为0
+            if (indices[0] & 8u) {
+                std::swap(q[0], q[1]);
+                std::swap(pbit[0], pbit[1]);
+                for (auto &index: indices) index = 15 - index;
+            }
+            BitWriter writer;
+            writer.Write(1u << 6, 7);
+            for (std::uint32_t c = 0; c < 4; ++c) {
+                writer.Write(q[0][c], 7);
+                writer.Write(q[1][c], 7);
+            }
+            writer.Write(pbit[0], 1);
+            writer.Write(pbit[1], 1);
+            writer.Write(indices[0], 3);
+            for (std::uint32_t i = 1; i < 16; ++i) writer.Write(indices[i], 4);
+            for (std::uint32_t i = 0; i < 16; ++i)
+                out[i] = static_cast<unsigned char>(writer.Words[i / 8] >> (i % 8 * 8) & 0xFF);
+        }
+
+        static bool Enabled;
+        static bool S3TCAvailable;
+    };
+
+    const char *BlockCompressor::TAG = "BlockCompressor";
+    bool BlockCompressor::Enabled = true;
+    bool BlockCompressor::S3TCAvailable = false;
+}
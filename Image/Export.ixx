@@ -1,4 +1,6 @@
 export module CEngine.Image;
 export import :Pixel;
 export import :Image;
-export import :ImageBuffer;
\ No newline at end of file
+export import :ImageBuffer;
+export import :BlockCompression;
+export import :TextureCooker;
\ No newline at end of file
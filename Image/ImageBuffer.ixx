@@ -12,6 +12,7 @@ module;
 export module CEngine.Image:ImageBuffer;
 import :Pixel;
 import CEngine.Logger;
+import CEngine.Hash;
 
 namespace CEngine {
     export class ImageBuffer {
@@ -29,6 +30,8 @@ namespace CEngine {
             }
             Data = new unsigned char[size];
             memcpy(Data, data, sizeof(unsigned char) * size);
+            // 解码时顺带计算内容哈希（尺寸与格式参与哈希）
+            ContentHash = Hasher().UpdateValue(width).UpdateValue(height).UpdateValue(mode).Update(Data, size).Finish();
         };
 
         explicit ImageBuffer(const char *img_path) : Data(nullptr), Width(0), Height(0), mColorMode(ColorMode::NONE) {
@@ -69,6 +72,8 @@ namespace CEngine {
         unsigned int GetWidth() const { return Width; }
         unsigned int GetHeight() const { return Height; }
         ColorMode GetColorMode() const { return mColorMode; }
+        /// 内容哈希
+        const Hash128 &GetHash() const { return ContentHash; }
 
     private:
         const static char *TAG;
@@ -76,6 +81,7 @@ namespace CEngine {
         unsigned int Width;
         unsigned int Height;
         ColorMode mColorMode{};
+        Hash128 ContentHash{};
     };
 
     const char *ImageBuffer::TAG = "ImageBuffer";
@@ -0,0 +1,380 @@
+/**
+ * @file TextureCooker.ixx
+ * @brief 纹理烘焙（.cetex）
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+export module CEngine.Image:TextureCooker;
+import :Pixel;
+import :ImageBuffer;
+import :BlockCompression;
+import std;
+import CEngine.Logger;
+import CEngine.MappedFile;
+import CEngine.Hash;
+
+namespace CEngine {
+    /**
+     * @brief .cetex文件头
+     * @remark 文件布局：Header | Level[LevelCount] | 填充 | 各级Mip数据（从DataOffset开始，每级按LevelAlignment对齐，行紧密排列）
+     */
+    export struct CookedTextureHeader {
+        char Magic[4] = {'C', 'E', 'T', 'X'};
+        std::uint32_t Version = 0;
+        std::uint32_t Width = 0;
+        std::uint32_t Height = 0;
+        std::uint32_t Channels = 0;
+        std::uint32_t LevelCount = 0;
+        /// @brief 块压缩格式（BlockFormat）
+        std::uint32_t Format = 0;
+        std::uint32_t Reserved = 0;
+        /// @brief Mip数据的起始偏移（字节）
+        std::uint64_t DataOffset = 0;
+        /// @brief Mip数据的总大小（字节）
+        std::uint64_t DataSize = 0;
+    };
+
+    /**
+     * @brief 烘焙后的纹理
+     * @remark 数据来自映射的.cetex文件，或在内存中由ImageBuffer生成；可直接按级上传\n
+     * 压缩格式下每级数据为按行优先排列的4x4块
+     */
+    export class CookedTexture {
+    public:
+        /// 一级Mip
+        struct Level {
+            std::uint32_t Width = 0;
+            std::uint32_t Height = 0;
+            /// @brief 相对于数据起始的偏移（字节）
+            std::uint64_t Offset = 0;
+            std::uint64_t Size = 0;
+        };
+
+        /// 每级数据的对齐（字节）
+        static constexpr std::uint64_t LevelAlignment = 16;
+
+        CookedTexture() = default;
+        CookedTexture(CookedTexture &&) noexcept = default;
+        CookedTexture &operator=(CookedTexture &&) noexcept = default;
+
+        /**
+         * 映射并校验.cetex文件
+         * @param path 文件路径
+         * @param version 期望的版本
+         * @return 文件不存在或校验失败返回<code>std::nullopt</code>
+         */
+        static std::optional<CookedTexture> Open(const std::filesystem::path &path, const std::uint32_t version) {
+            auto file = MappedFile::Open(path);
+            if (!file || file->size() < sizeof(CookedTextureHeader)) return std::nullopt;
+            CookedTextureHeader header;
+            std::memcpy(&header, file->data(), sizeof(header));
+            if (std::memcmp(header.Magic, CookedTextureHeader{}.Magic, sizeof(header.Magic)) != 0 || header.Version != version) return std::nullopt;
+            if (header.Channels < 1 || header.Channels > 4 || header.LevelCount == 0 || header.LevelCount > 32) return std::nullopt;
+            const auto format = static_cast<BlockFormat>(header.Format);
+            if (format != BlockFormat::NONE && format != BlockFormat::BC1 && format != BlockFormat::BC3 && format != BlockFormat::BC4 &&
+                format != BlockFormat::BC5 && format != BlockFormat::BC7)
+                return std::nullopt;
+            const auto levels_end = sizeof(CookedTextureHeader) + sizeof(Level) * header.LevelCount;
+            if (levels_end > file->size() || header.DataOffset < levels_end || header.DataOffset > file->size() ||
+                header.DataSize > file->size() - header.DataOffset)
+                return std::nullopt;
+            CookedTexture cooked;
+            cooked.Levels.resize(header.LevelCount);
+            std::memcpy(cooked.Levels.data(), file->data() + sizeof(CookedTextureHeader), sizeof(Level) * header.LevelCount);
+            auto width = header.Width, height = header.Height;
+            for (const auto &level: cooked.Levels) {
+                if (level.Width != width || level.Height != height || level.Size != LevelSize(format, width, height, header.Channels) ||
+                    level.Offset % LevelAlignment != 0 || level.Offset > header.DataSize || level.Size > header.DataSize - level.Offset)
+                    return std::nullopt;
+                width = std::max(1u, width / 2);
+                height = std::max(1u, height / 2);
+            }
+            cooked.Width = header.Width;
+            cooked.Height = header.Height;
+            cooked.Channels = header.Channels;
+            cooked.Format = format;
+            cooked.Data = reinterpret_cast<const unsigned char *>(file->data()) + header.DataOffset;
+            cooked.DataSize = header.DataSize;
+            cooked.File = std::move(*file);
+            return cooked;
+        }
+
+        /**
+         * 由图片生成完整的Mip链（2x2盒式滤波）
+         * @param img 图片
+         * @param encoding 压缩方式（各级生成后分别压缩）
+         */
+        static CookedTexture FromImage(const ImageBuffer &img, const BlockEncoding encoding = {}) {
+            CookedTexture cooked;
+            cooked.Width = img.GetWidth();
+            cooked.Height = img.GetHeight();
+            cooked.Channels = static_cast<std::uint32_t>(ColorMode_GetChannelCount(img.GetColorMode()));
+            if (!img.IsValid() || cooked.Channels == 0) return cooked;
+            // 计算各级布局
+            auto width = cooked.Width, height = cooked.Height;
+            std::uint64_t offset = 0;
+            while (true) {
+                const auto size = static_cast<std::uint64_t>(width) * height * cooked.Channels;
+                cooked.Levels.push_back({width, height, offset, size});
+                offset = AlignUp(offset + size);
+                if (width == 1 && height == 1) break;
+                width = std::max(1u, width / 2);
+                height = std::max(1u, height / 2);
+            }
+            cooked.Owned.resize(offset);
+            std::memcpy(cooked.Owned.data(), img.GetBuffer(), cooked.Levels[0].Size);
+            for (std::size_t i = 1; i < cooked.Levels.size(); ++i)
+                Downsample(cooked.Owned.data() + cooked.Levels[i - 1].Offset, cooked.Levels[i - 1], cooked.Owned.data() + cooked.Levels[i].Offset,
+                           cooked.Levels[i], cooked.Channels);
+            cooked.Data = cooked.Owned.data();
+            cooked.DataSize = offset;
+            if (encoding.Format != BlockFormat::NONE) cooked.Compress(encoding);
+            return cooked;
+        }
+
+        /// 是否包含有效数据
+        bool IsValid() const { return Data != nullptr && !Levels.empty(); }
+
+        /// 数据是否来自映射的文件
+        bool IsMapped() const { return File.IsOpen(); }
+
+        /// @property Width
+        std::uint32_t GetWidth() const { return Width; }
+
+        /// @property Height
+        std::uint32_t GetHeight() const { return Height; }
+
+        /// @property Channels
+        std::uint32_t GetChannels() const { return Channels; }
+
+        /// @property Format
+        BlockFormat GetFormat() const { return Format; }
+
+        bool IsCompressed() const { return Format != BlockFormat::NONE; }
+
+        ColorMode GetColorMode() const {
+            switch (Channels) {
+                case 1: return ColorMode::GRAY;
+                case 2: return ColorMode::GRAY_A;
+                case 3: return ColorMode::RGB;
+                case 4: return ColorMode::RGBA;
+                default: return ColorMode::NONE;
+            }
+        }
+
+        /// @property Levels
+        const std::vector<Level> &GetLevels() const { return Levels; }
+
+        /// 全部Mip数据
+        const unsigned char *GetData() const { return Data; }
+
+        /// @property DataSize
+        std::uint64_t GetDataSize() const { return DataSize; }
+
+        /// 某级Mip的数据
+        const unsigned char *GetLevelData(const std::size_t level) const { return Data + Levels[level].Offset; }
+
+        static std::uint64_t AlignUp(const std::uint64_t value) {
+            return (value + LevelAlignment - 1) / LevelAlignment * LevelAlignment;
+        }
+
+        /// 一级数据的大小（字节）
+        static std::uint64_t LevelSize(const BlockFormat format, const std::uint32_t width, const std::uint32_t height, const std::uint32_t channels) {
+            return format == BlockFormat::NONE
+                       ? static_cast<std::uint64_t>(width) * height * channels
+                       : BlockCompressor::GetCompressedSize(format, width, height);
+        }
+
+    private:
+        /// 压缩各级数据（替换原数据）
+        void Compress(const BlockEncoding encoding) {
+            std::vector<unsigned char> compressed;
+            for (auto &level: Levels) {
+                const auto blocks = BlockCompressor::Compress(Owned.data() + level.Offset, level.Width, level.Height, Channels, encoding);
+                level.Offset = compressed.size();
+                level.Size = blocks.size();
+                compressed.insert(compressed.end(), blocks.begin(), blocks.end());
+                compressed.resize(AlignUp(compressed.size()));
+            }
+            Owned = std::move(compressed);
+            Data = Owned.data();
+            DataSize = Owned.size();
+            Format = encoding.Format;
+        }
+
+        static void Downsample(const unsigned char *src, const Level &src_level, unsigned char *dst, const Level &dst_level, const std::uint32_t channels) {
+            for (std::uint32_t y = 0; y < dst_level.Height; ++y) {
+                const auto y0 = std::min(y * 2, src_level.Height - 1), y1 = std::min(y * 2 + 1, src_level.Height - 1);
+                for (std::uint32_t x = 0; x < dst_level.Width; ++x) {
+                    const auto x0 = std::min(x * 2, src_level.Width - 1), x1 = std::min(x * 2 + 1, src_level.Width - 1);
+                    const auto p00 = src + (static_cast<std::size_t>(y0) * src_level.Width + x0) * channels;
+                    const auto p01 = src + (static_cast<std::size_t>(y0) * src_level.Width + x1) * channels;
+                    const auto p10 = src + (static_cast<std::size_t>(y1) * src_level.Width + x0) * channels;
+                    const auto p11 = src + (static_cast<std::size_t>(y1) * src_level.Width + x1) * channels;
+                    const auto out = dst + (static_cast<std::size_t>(y) * dst_level.Width + x) * channels;
+                    for (std::uint32_t c = 0; c < channels; ++c)
+                        out[c] = static_cast<unsigned char>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+                }
+            }
+        }
+
+        MappedFile File;
+        std::vector<unsigned char> Owned;
+        const unsigned char *Data = nullptr;
+        std::uint64_t DataSize = 0;
+        std::uint32_t Width = 0, Height = 0, Channels = 0;
+        BlockFormat Format = BlockFormat::NONE;
+        std::vector<Level> Levels;
+    };
+
+    /**
+     * @brief 纹理烘焙器
+     * @remark 把源图片转换为带完整Mip链的.cetex文件，以源文件内容的128位哈希（Hash128）与用途命名保存在缓存目录中；\n
+     * 再次加载同一内容的图片时直接映射缓存文件，无需解码与生成Mip
+     */
+    export class TextureCooker {
+    public:
+        const static char *TAG;
+
+        TextureCooker() = delete;
+
+        /// .cetex格式版本，格式变化时递增以使旧缓存失效
+        static constexpr std::uint32_t Version = 2;
+
+        static void SetEnabled(const bool enabled) { Enabled = enabled; }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /// @property CacheDirectory
+        static void SetCacheDirectory(const std::filesystem::path &dir) { CacheDirectory = dir; }
+
+        /// @property CacheDirectory
+        static const std::filesystem::path &GetCacheDirectory() { return CacheDirectory; }
+
+        /**
+         * 计算文件内容的哈希
+         * @remark 分块流式读取，不需要整个文件的缓冲
+         * @return 读取失败返回<code>std::nullopt</code>
+         */
+        static std::optional<Hash128> HashFile(const std::filesystem::path &path) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) return std::nullopt;
+            Hasher hasher;
+            std::array<char, 64 * 1024> chunk;
+            while (in) {
+                in.read(chunk.data(), chunk.size());
+                hasher.Update(chunk.data(), static_cast<std::size_t>(in.gcount()));
+            }
+            if (in.bad()) return std::nullopt;
+            return hasher.Finish();
+        }
+
+        /**
+         * 缓存名称
+         * @remark 同一源文件按不同用途压缩的结果分别缓存；颜色贴图的压缩格式取决于S3TC是否可用（BC1/BC3或BC7），\n
+         * 两者分别缓存，避免在不支持S3TC的驱动上加载BC1/BC3
+         * @param hash 源文件内容的哈希
+         * @param compress 是否块压缩
+         * @param usage 用途
+         */
+        static std::string GetCacheName(const Hash128 &hash, const bool compress, const TextureUsage usage) {
+            static constexpr std::array<const char *, 5> UsageNames = {"color", "normal", "mask", "roughness", "metalness"};
+            if (!compress) return std::format("{}_raw", hash.ToString());
+            const bool s3tc = usage == TextureUsage::Color && BlockCompressor::IsS3TCAvailable();
+            return std::format("{}_{}{}", hash.ToString(), UsageNames[static_cast<std::size_t>(usage)], s3tc ? "_s3tc" : "");
+        }
+
+        /// 缓存文件路径
+        static std::filesystem::path GetCachePath(const std::string &name) {
+            return CacheDirectory / (name + ".cetex");
+        }
+
+        /**
+         * 烘焙并写入文件
+         * @remark 先写入临时文件再重命名，写入中途失败不会留下损坏的缓存
+         * @param cooked 烘焙后的纹理
+         * @param output 输出路径
+         * @return 是否成功
+         */
+        static bool Write(const CookedTexture &cooked, const std::filesystem::path &output) {
+            if (!cooked.IsValid()) return false;
+            CookedTextureHeader header;
+            header.Version = Version;
+            header.Width = cooked.GetWidth();
+            header.Height = cooked.GetHeight();
+            header.Channels = cooked.GetChannels();
+            header.LevelCount = static_cast<std::uint32_t>(cooked.GetLevels().size());
+            header.Format = static_cast<std::uint32_t>(cooked.GetFormat());
+            header.DataOffset = CookedTexture::AlignUp(sizeof(CookedTextureHeader) + sizeof(CookedTexture::Level) * header.LevelCount);
+            header.DataSize = cooked.GetDataSize();
+            std::error_code ec;
+            std::filesystem::create_directories(output.parent_path(), ec);
+            auto temp = output;
+            temp += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                if (!out) {
+                    LogE(TAG) << "无法写入: " << temp.string();
+                    return false;
+                }
+                out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char *>(cooked.GetLevels().data()),
+                          static_cast<std::streamsize>(sizeof(CookedTexture::Level) * header.LevelCount));
+                const std::array<char, CookedTexture::LevelAlignment> zeros{};
+                out.write(zeros.data(), static_cast<std::streamsize>(header.DataOffset - sizeof(header) - sizeof(CookedTexture::Level) * header.LevelCount));
+                out.write(reinterpret_cast<const char *>(cooked.GetData()), static_cast<std::streamsize>(header.DataSize));
+                if (!out) {
+                    LogE(TAG) << "写入失败: " << temp.string();
+                    out.close();
+                    std::filesystem::remove(temp, ec);
+                    return false;
+                }
+            }
+            std::filesystem::rename(temp, output, ec);
+            if (ec) {
+                std::filesystem::remove(temp, ec);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * 加载源图片对应的烘焙纹理
+         * @remark 缓存有效时直接映射；否则解码源图片、生成Mip（并压缩）后写入缓存（写入失败时返回内存中的结果）
+         * @param source 源图片路径
+         * @param hash 源文件内容的哈希（<code>HashFile</code>）
+         * @param compress 是否块压缩
+         * @param usage 用途（决定压缩格式）
+         * @return 源图片无法解码返回<code>std::nullopt</code>
+         */
+        static std::optional<CookedTexture> Load(const std::filesystem::path &source, const Hash128 &hash, const bool compress = false,
+                                                 const TextureUsage usage = TextureUsage::Color) {
+            const auto cache_path = GetCachePath(GetCacheName(hash, compress, usage));
+            if (auto cooked = CookedTexture::Open(cache_path, Version)) {
+                // 旧缓存可能是在支持S3TC的驱动上烘焙的，当前不可用时重新烘焙
+                const auto format = cooked->GetFormat();
+                if (BlockCompressor::IsS3TCAvailable() || (format != BlockFormat::BC1 && format != BlockFormat::BC3)) return cooked;
+                LogW(TAG) << "缓存使用了不可用的S3TC格式，重新烘焙: " << cache_path.string();
+            }
+            const ImageBuffer img(source.string().c_str());
+            if (!img.IsValid()) return std::nullopt;
+            auto cooked = CookedTexture::FromImage(img, compress
+                                                            ? BlockCompressor::ChooseEncoding(ColorMode_GetChannelCount(img.GetColorMode()), usage)
+                                                            : BlockEncoding{});
+            if (!Write(cooked, cache_path)) return cooked;
+            LogI(TAG) << "已烘焙: " << source.string() << " -> " << cache_path.string();
+            if (auto mapped = CookedTexture::Open(cache_path, Version)) return mapped;
+            return cooked;
+        }
+
+    private:
+        static bool Enabled;
+        static std::filesystem::path CacheDirectory;
+    };
+
+    const char *TextureCooker::TAG = "TextureCooker";
+    bool TextureCooker::Enabled = true;
+    std::filesystem::path TextureCooker::CacheDirectory = "Cache/Textures";
+}
@@ -6,8 +6,11 @@
  * @date 2024/10/20
  */
 
+module;
+#include "Utils/Profiler.h"
 export module CEngine.Node:Behaviour;
 import CEngine.Base;
+import CEngine.Profiler;
 
 namespace CEngine {
     export class Node;
@@ -18,6 +21,7 @@ namespace CEngine {
         ~Behaviour() override = default;
 
         void Process(const double DeltaTime) {
+            CE_PROFILE_ZONE("Behaviour::Process");
             if (!ReadyCalled) Ready();
             Update(DeltaTime);
         }
@@ -25,7 +25,7 @@ namespace CEngine {
         }
 
         void UpdateViewMatrix() {
-            ViewMatrix = Camera::GetViewMatrix(Position, -GetForward(true), GetUp(true));
+            ViewMatrix = Camera::GetViewMatrix(GetPosition(), -GetForward(true), GetUp(true));
         }
 
         Camera3D &SetPosition(const glm::vec3 &p, const bool updateM = true) override {
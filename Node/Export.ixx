@@ -2,6 +2,8 @@ module;
 #include <vcruntime_typeinfo.h>
 export module CEngine.Node;
 export import :Node;
+export import :TransformStorage;
+export import :SceneIndex;
 export import :Node3D;
 export import :RenderUnit3D;
 export import :PBR3D;
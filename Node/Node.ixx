@@ -16,6 +16,8 @@ import CEngine.Utils;
 import CEngine.Logger;
 
 namespace CEngine {
+    export class SceneIndex;
+
     /**
      * @brief 节点类
      * @remark 仅实现父子关系
@@ -34,11 +36,8 @@ namespace CEngine {
         Node(Node &&other) noexcept = delete;
         Node &operator=(Node &&other) = delete;
 
-        ~Node() override {
-            for (const auto child: Children | std::views::values) {
-                delete child;
-            }
-        }
+        /// @file SceneIndex.ixx
+        ~Node() override;
 
         virtual const char *GetTypeName() {
             return "Node";
@@ -60,6 +59,17 @@ namespace CEngine {
             return std::ranges::to<std::vector<Node *> >(Children | std::views::values);
         }
 
+        /**
+         * 遍历全部子级
+         * @remark 不产生额外的内存分配
+         * @param func 形如<code>void(Node *)</code>的函数
+         */
+        template<class F>
+        void ForEachChild(F &&func) const {
+            for (const auto child: Children | std::views::values)
+                func(child);
+        }
+
         /**
          * 添加子级
          * @remark 注意：若节点已有父级，则会从原父级弹出！
@@ -73,6 +83,8 @@ namespace CEngine {
             node->Parent = this;
             node->setName(node->Name); // 原地设置，让setName自动判断是否有重复名
             Children.emplace(node->Name, node);
+            node->OnParentTransformChanged(); // 父级改变，世界变换随之改变
+            if (Scene != nullptr) node->EnterScene(Scene);
         }
 
         /**
@@ -100,6 +112,8 @@ namespace CEngine {
             if (t.empty()) return nullptr;
             const auto n = t.mapped();
             n->Parent = nullptr;
+            n->OnParentTransformChanged();
+            n->ExitScene();
             return n;
         }
 
@@ -167,9 +181,33 @@ namespace CEngine {
         /// @property Behaviour
         std::shared_ptr<Behaviour> GetBehaviour() const { return Behaviour; }
 
-        void SetBehaviour(const std::shared_ptr<Behaviour> &behaviour) {
-            Behaviour = behaviour;
-            Behaviour->SetParentNode(this);
+        /// @file SceneIndex.ixx
+        void SetBehaviour(const std::shared_ptr<Behaviour> &behaviour);
+
+        /**
+         * 将本节点及其子树加入场景索引
+         * @remark 通常只需对根节点调用，AddChild会自动将子树加入父级所在的场景
+         * @file SceneIndex.ixx
+         */
+        void EnterScene(SceneIndex *scene);
+
+        /**
+         * 将本节点及其子树移出场景索引
+         * @file SceneIndex.ixx
+         */
+        void ExitScene();
+
+        /// @property Scene
+        SceneIndex *getScene() const { return Scene; }
+
+        /**
+         * 父级的世界变换已改变
+         * @remark 由AddChild、PopChild以及Node3D的变换修改触发\n
+         * Node本身没有变换，直接向子级传递
+         */
+        virtual void OnParentTransformChanged() {
+            for (const auto child: Children | std::views::values)
+                child->OnParentTransformChanged();
         }
 
     protected:
@@ -177,6 +215,14 @@ namespace CEngine {
             Name = Utils::GenerateUUID();
         }
 
+        /// 加入场景索引时调用（派生类在此登记自身）
+        virtual void OnEnterScene() {
+        }
+
+        /// 移出场景索引时调用
+        virtual void OnExitScene() {
+        }
+
         /// @brief Node的名称（在同层级中唯一）
         std::string Name;
         /// @brief 父级
@@ -185,6 +231,8 @@ namespace CEngine {
         std::unordered_map<std::string, Node *> Children;
         ///
         std::shared_ptr<Behaviour> Behaviour = nullptr;
+        /// @brief 所在的场景索引（不在场景中则为空）
+        SceneIndex *Scene = nullptr;
     };
 
     const char *Node::TAG = "Node";
@@ -11,12 +11,14 @@ module;
 #include <glm/gtc/quaternion.hpp>
 export module CEngine.Node:Node3D;
 import :Node;
+import :TransformStorage;
 import CEngine.Utils;
 
 namespace CEngine {
     /**
      * @brief 3D节点类
-     * @remark 仅实现3D变换功能
+     * @remark 仅实现3D变换功能\n
+     * 可选：变换数据存放于TransformStorage（见<code>SetDefaultTransformStorage</code>），此时各访问器为存储数组的视图
      */
     export class Node3D : public Node {
     public:
@@ -24,71 +26,159 @@ namespace CEngine {
             return new Node3D();
         }
 
+        ~Node3D() override {
+            if (Storage != nullptr) Storage->Release(Slot);
+        }
+
+        /**
+         * 设置默认变换存储
+         * @remark 仅影响之后创建的Node3D；已有节点在被AddChild到使用存储的父级下时自动迁移
+         * @param storage 变换存储（<code>nullptr</code>表示各节点自行保存变换）
+         */
+        static void SetDefaultTransformStorage(TransformStorage *storage) {
+            DefaultStorage = storage;
+        }
+
+        /**
+         * 将子树内全部Node3D的变换迁移至指定存储
+         * @param storage 目标存储（<code>nullptr</code>表示迁出至节点自身）
+         */
+        void AdoptTransformStorage(TransformStorage *storage) {
+            std::vector<Node *> stack{this};
+            while (!stack.empty()) {
+                const auto node = stack.back();
+                stack.pop_back();
+                if (const auto n3d = dynamic_cast<Node3D *>(node); n3d != nullptr)
+                    n3d->MoveToStorage(storage);
+                node->ForEachChild([&](Node *child) { stack.push_back(child); });
+            }
+        }
+
+        /// @property Storage
+        TransformStorage *getTransformStorage() const { return Storage; }
+
         const char *GetTypeName() override {
             return "Node3D";
         }
 
         virtual Node3D &SetPosition(const glm::vec3 &p, const bool updateM = true) {
-            Position = p;
+            PositionRef() = p;
             if (updateM) UpdateModelMatrix();
             return *this;
         }
 
         virtual Node3D &SetRotation(const EulerRotation &e, const bool updateM = true) {
-            Rotation = e;
+            RotationRef() = e;
             if (updateM) UpdateModelMatrix();
             return *this;
         }
 
         virtual Node3D &SetScale(const glm::vec3 &s, const bool updateM = true) {
-            Scale = s;
+            ScaleRef() = s;
             if (updateM) UpdateModelMatrix();
             return *this;
         }
 
         virtual Node3D &UpdateModelMatrix() {
+            if (Storage != nullptr) {
+                // 由存储统一计算
+                Storage->MarkLocalDirty(Slot);
+                return *this;
+            }
             // 平移矩阵 * 旋转矩阵 * 缩放矩阵
             // ModelMatrix = glm::translate(glm::mat4(1.0f), Position) * glm::mat4_cast(Rotation.ToOrientation()) * glm::scale(glm::mat4(1.0f), Scale);
             ModelMatrix = glm::mat4_cast(Rotation.ToOrientation()) * glm::translate(glm::mat4(1.0f), Position) * glm::scale(glm::mat4(1.0f), Scale);
+            MarkWorldDirty();
             return *this;
         }
 
         virtual void SetModelMatrix(const glm::mat4 &matrix) {
-            Position = glm::vec3(matrix[3]);
-            Scale = {
+            auto &scale = ScaleRef();
+            PositionRef() = glm::vec3(matrix[3]);
+            scale = {
                 glm::length(glm::vec3(matrix[0])),
                 glm::length(glm::vec3(matrix[1])),
                 glm::length(glm::vec3(matrix[2])),
             };
             glm::mat4 rotationM = matrix;
-            rotationM[0] /= Scale.x;
-            rotationM[1] /= Scale.y;
-            rotationM[2] /= Scale.z;
+            rotationM[0] /= scale.x;
+            rotationM[1] /= scale.y;
+            rotationM[2] /= scale.z;
             const glm::vec3 rotationEuler = glm::eulerAngles(glm::quat_cast(rotationM));
-            Rotation = {rotationEuler.y, rotationEuler.x, rotationEuler.z};
+            RotationRef() = {rotationEuler.y, rotationEuler.x, rotationEuler.z};
             UpdateModelMatrix();
         }
 
-        glm::vec3 GetPosition() const { return Position; }
-        EulerRotation GetRotation() const { return Rotation; }
-        EulerRotation *GetRotationPtr() { return &Rotation; }
-        glm::vec3 GetScale() const { return Scale; }
-        glm::mat4 GetModelMatrix() const { return ModelMatrix; }
+        glm::vec3 GetPosition() const { return PositionRef(); }
+        EulerRotation GetRotation() const { return RotationRef(); }
+        /// @remark 使用存储时，指针在下一次分配槽或刷新存储后失效，请勿保存
+        EulerRotation *GetRotationPtr() { return &RotationRef(); }
+        glm::vec3 GetScale() const { return ScaleRef(); }
+        glm::mat4 GetModelMatrix() const { return Storage != nullptr ? Storage->GetLocalMatrix(Slot) : ModelMatrix; }
 
         /**
          * 获取世界变换矩阵
+         * @remark 使用缓存，仅在变换被修改后重新计算
          * @return 世界变换矩阵
          */
         glm::mat4 GetWorldMatrix() const {
-            auto matrix = ModelMatrix;
-            auto parent = Parent;
-            while (parent != nullptr) {
-                if (const auto n3d = dynamic_cast<Node3D *>(parent); n3d != nullptr) {
-                    matrix = n3d->GetWorldMatrix() * matrix;
+            if (Storage != nullptr) return Storage->GetWorldMatrix(Slot);
+            if (WorldDirty) {
+                if (const auto parent = GetParentNode3D(); parent != nullptr)
+                    WorldMatrix = parent->GetWorldMatrix() * ModelMatrix;
+                else
+                    WorldMatrix = ModelMatrix;
+                WorldDirty = false;
+            }
+            return WorldMatrix;
+        }
+
+        /**
+         * 自上而下刷新子树内所有过期的世界变换矩阵
+         * @remark 每帧调用一次，单次遍历，每个节点最多计算一次\n
+         * 使用存储时，改为对整个存储做一次线性扫描
+         */
+        void ResolveWorldMatrices() {
+            if (Storage != nullptr) {
+                Storage->Update();
+                return;
+            }
+            std::vector<std::pair<Node *, const glm::mat4 *> > stack;
+            const glm::mat4 world = GetWorldMatrix();
+            ForEachChild([&](Node *child) { stack.emplace_back(child, &world); });
+            while (!stack.empty()) {
+                auto [node, parent_world] = stack.back();
+                stack.pop_back();
+                if (const auto n3d = dynamic_cast<Node3D *>(node); n3d != nullptr) {
+                    if (n3d->WorldDirty) {
+                        n3d->WorldMatrix = *parent_world * n3d->ModelMatrix;
+                        n3d->WorldDirty = false;
+                    }
+                    parent_world = &n3d->WorldMatrix;
                 }
-                parent = parent->getParent();
+                node->ForEachChild([&](Node *child) { stack.emplace_back(child, parent_world); });
             }
-            return matrix;
+        }
+
+        /**
+         * 标记世界变换矩阵过期，并向子级传递
+         * @remark 已过期的节点，其子级必然也已过期，因此可以提前返回
+         */
+        void MarkWorldDirty() {
+            if (Storage != nullptr || WorldDirty) return;
+            WorldDirty = true;
+            Node::OnParentTransformChanged();
+        }
+
+        void OnParentTransformChanged() override {
+            const auto parent = GetParentNode3D();
+            if (parent != nullptr && parent->Storage != Storage) {
+                // 跟随父级的存储方式
+                AdoptTransformStorage(parent->Storage);
+            } else if (Storage != nullptr) {
+                Storage->SetParent(Slot, parent != nullptr ? parent->Slot : TransformStorage::InvalidSlot);
+            }
+            MarkWorldDirty();
         }
 
         glm::vec3 GetWorldPosition() const {
@@ -122,7 +212,7 @@ namespace CEngine {
         glm::vec3 GetForward(const bool world = false) const {
             if (world)
                 return glm::normalize(GetWorldRotation().ToOrientation() * WorldForward);
-            return glm::normalize(Rotation.ToOrientation() * WorldForward);
+            return glm::normalize(RotationRef().ToOrientation() * WorldForward);
         }
 
         glm::vec3 GetRight(const bool world = false) const {
@@ -137,14 +227,71 @@ namespace CEngine {
         }
 
     protected:
-        Node3D() = default;
-        /// 局部变换矩阵
+        Node3D() {
+            if (DefaultStorage != nullptr) MoveToStorage(DefaultStorage);
+        }
+
+        /// 默认变换存储
+        static TransformStorage *DefaultStorage;
+
+        glm::vec3 &PositionRef() const { return Storage != nullptr ? Storage->Position(Slot) : Position; }
+        EulerRotation &RotationRef() const { return Storage != nullptr ? Storage->Rotation(Slot) : Rotation; }
+        glm::vec3 &ScaleRef() const { return Storage != nullptr ? Storage->Scale(Slot) : Scale; }
+
+        /**
+         * 迁移本节点的变换数据
+         * @remark 不处理子级，请使用AdoptTransformStorage
+         */
+        void MoveToStorage(TransformStorage *storage) {
+            if (storage == Storage) return;
+            if (Storage != nullptr) {
+                // 迁出至节点自身
+                Position = Storage->Position(Slot);
+                Rotation = Storage->Rotation(Slot);
+                Scale = Storage->Scale(Slot);
+                ModelMatrix = Storage->GetLocalMatrix(Slot);
+                Storage->Release(Slot);
+                Slot = TransformStorage::InvalidSlot;
+                WorldDirty = true;
+            }
+            Storage = storage;
+            if (Storage != nullptr) {
+                Slot = Storage->Allocate();
+                Storage->Position(Slot) = Position;
+                Storage->Rotation(Slot) = Rotation;
+                Storage->Scale(Slot) = Scale;
+                Storage->MarkLocalDirty(Slot);
+                const auto parent = GetParentNode3D();
+                if (parent != nullptr && parent->Storage == Storage)
+                    Storage->SetParent(Slot, parent->Slot);
+            }
+        }
+
+        /// 获取最近的Node3D祖先
+        Node3D *GetParentNode3D() const {
+            for (auto parent = Parent; parent != nullptr; parent = parent->getParent())
+                if (const auto n3d = dynamic_cast<Node3D *>(parent); n3d != nullptr)
+                    return n3d;
+            return nullptr;
+        }
+
+        /// 局部变换矩阵（未使用存储时）
         glm::mat4 ModelMatrix = glm::mat4(1.0f);
-        /// 坐标
-        glm::vec3 Position = glm::vec3(0.0f);
-        /// 旋转值
-        EulerRotation Rotation = EulerRotation(0.0f, 0.0f, 0.0f);
-        /// 缩放值
-        glm::vec3 Scale = glm::vec3(1.0f);
+        /// 坐标（未使用存储时）
+        mutable glm::vec3 Position = glm::vec3(0.0f);
+        /// 旋转值（未使用存储时）
+        mutable EulerRotation Rotation = EulerRotation(0.0f, 0.0f, 0.0f);
+        /// 缩放值（未使用存储时）
+        mutable glm::vec3 Scale = glm::vec3(1.0f);
+        /// 世界变换矩阵（该变量用于缓存）
+        mutable glm::mat4 WorldMatrix = glm::mat4(1.0f);
+        /// 世界变换矩阵是否过期
+        mutable bool WorldDirty = true;
+        /// 变换存储（为空表示使用节点自身的变量）
+        TransformStorage *Storage = nullptr;
+        /// 在变换存储中的槽
+        TransformStorage::SlotID Slot = TransformStorage::InvalidSlot;
     };
+
+    TransformStorage *Node3D::DefaultStorage = nullptr;
 }
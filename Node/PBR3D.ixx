@@ -8,9 +8,11 @@
 
 module;
 #include <glm/glm.hpp>
+#include "Utils/Profiler.h"
 export module CEngine.Node:PBR3D;
 import :RenderUnit3D;
 import CEngine.Render;
+import CEngine.Profiler;
 
 namespace CEngine {
     export class PBR3D final : public RenderUnit3D {
@@ -23,15 +25,11 @@ namespace CEngine {
             return new PBR3D(m, std::move(mat), shader);
         }
 
-        void Render(const glm::mat4 &viewM, const glm::mat4 &projectM) override {
-            shader_program->Use();
-            shader_program->SetUniform(0, projectM * (GetWorldMatrix() * viewM));
-            Mat.Use(shader_program);
-            if (!uniforms.empty())
-                for (auto [name, value]: uniforms) {
-                    shader_program->SetShaderUniformVar(name.c_str(), value);
-                }
-            mesh->Render();
+        void Submit(RenderQueue &queue, const glm::mat4 &viewM, const glm::mat4 &projectM) override {
+            CE_PROFILE_ZONE("PBR3D::Submit");
+            Mat.RefreshPendingTextures();
+            queue.Submit(Mat.IsTransparent() ? RenderPass::Transparent : RenderPass::Opaque, shader_program, &Mat, mesh,
+                         projectM * (GetWorldMatrix() * viewM), &uniforms);
         }
 
         Material &getMaterial() {
@@ -39,7 +37,7 @@ namespace CEngine {
         }
 
     protected:
-        PBR3D(Mesh *m, Material &&mat, ShaderProgram *shader) : RenderUnit3D(m, shader == nullptr ? ShaderProgram::All_Instances["PBR"] : shader),
+        PBR3D(Mesh *m, Material &&mat, ShaderProgram *shader) : RenderUnit3D(m, shader == nullptr ? ShaderProgram::Find("PBR") : shader),
                                                                 Mat(std::move(mat)) {
         }
 
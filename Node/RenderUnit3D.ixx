@@ -9,10 +9,13 @@
 module;
 #include <glm/glm.hpp>
 #include <glm/ext/matrix_transform.hpp>
+#include "Utils/Profiler.h"
 export module CEngine.Node:RenderUnit3D;
 import :Node3D;
+import :SceneIndex;
 import std;
 import CEngine.Render;
+import CEngine.Profiler;
 
 namespace CEngine {
     /**
@@ -29,17 +32,16 @@ namespace CEngine {
             return new RenderUnit3D(m, s);
         }
 
+        ~RenderUnit3D() override {
+            if (Scene != nullptr) Scene->RemoveRenderable(this);
+        }
+
         /**
-         * 执行渲染
+         * 向渲染队列提交渲染包
          */
-        virtual void Render(const glm::mat4 &viewM, const glm::mat4 &projectM) {
-            shader_program->Use();
-            shader_program->SetUniform(0, projectM * (GetWorldMatrix() * viewM));
-            if (!uniforms.empty())
-                for (auto [name, value]: uniforms) {
-                    shader_program->SetShaderUniformVar(name.c_str(), value);
-                }
-            mesh->Render();
+        virtual void Submit(RenderQueue &queue, const glm::mat4 &viewM, const glm::mat4 &projectM) {
+            CE_PROFILE_ZONE("RenderUnit3D::Submit");
+            queue.Submit(RenderPass::Opaque, shader_program, nullptr, mesh, projectM * (GetWorldMatrix() * viewM), &uniforms);
         }
 
         /**
@@ -48,10 +50,10 @@ namespace CEngine {
          * @param value 值
          */
         template<typename T>
-        void SetShaderUniform(const std::string &name, T &&value) {
+        void SetShaderUniform(const std::string &name, const T &value) {
             LogI(TAG) << "设置Shader Uniform: " << name << " = " << value;
-            if (uniforms.contains(name)) uniforms.erase(name);
-            uniforms.emplace(name, ShaderUniformVar(value));
+            if constexpr (std::is_same_v<T, ShaderUniformVar::Type>) uniforms.Add(name, value);
+            else uniforms.Set(name, value);
         }
 
         /// @property mesh
@@ -61,14 +63,22 @@ namespace CEngine {
         ShaderProgram *getShaderProgram() const { return shader_program; }
 
         /// @property uniforms
-        std::unordered_map<std::string, ShaderUniformVar> &getUniforms() { return uniforms; }
+        UniformOverrides &getUniforms() { return uniforms; }
 
     protected:
         RenderUnit3D(Mesh *m, ShaderProgram *s) : mesh(m), shader_program(s) {
         }
 
+        void OnEnterScene() override {
+            Scene->AddRenderable(this);
+        }
+
+        void OnExitScene() override {
+            Scene->RemoveRenderable(this);
+        }
+
         Mesh *mesh;
         ShaderProgram *shader_program;
-        std::unordered_map<std::string, ShaderUniformVar> uniforms;
+        UniformOverrides uniforms;
     };
 }
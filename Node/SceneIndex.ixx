@@ -0,0 +1,152 @@
+/**
+ * @file SceneIndex.ixx
+ * @brief 场景索引
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+export module CEngine.Node:SceneIndex;
+import :Node;
+import :Behaviour;
+import std;
+
+namespace CEngine {
+    export class RenderUnit3D;
+
+    /**
+     * @brief 扁平列表
+     * @remark 增删均为O(1)；遍历期间删除的元素先置空，遍历结束后统一压缩
+     */
+    template<class T>
+    class IndexedList {
+    public:
+        const std::vector<T *> &Items() const { return items; }
+
+        void Add(T *item) {
+            if (positions.contains(item)) return;
+            positions.emplace(item, items.size());
+            items.push_back(item);
+        }
+
+        void Remove(T *item, const bool iterating) {
+            const auto it = positions.find(item);
+            if (it == positions.end()) return;
+            const auto index = it->second;
+            positions.erase(it);
+            if (iterating) {
+                items[index] = nullptr;
+                has_holes = true;
+                return;
+            }
+            if (index != items.size() - 1) {
+                items[index] = items.back();
+                if (items[index] != nullptr) positions[items[index]] = index;
+            }
+            items.pop_back();
+        }
+
+        void Compact() {
+            if (!has_holes) return;
+            std::erase(items, nullptr);
+            for (std::size_t i = 0; i < items.size(); ++i)
+                positions[items[i]] = i;
+            has_holes = false;
+        }
+
+    private:
+        std::vector<T *> items;
+        std::unordered_map<T *, std::size_t> positions;
+        bool has_holes = false;
+    };
+
+    /**
+     * @brief 场景索引
+     * @remark 保存场景内所有渲染单位与带有Behaviour的节点的扁平列表，\n
+     * 由AddChild、PopChild、RemoveChild、SetBehaviour增量维护，帧循环中直接遍历，无需遍历节点树
+     */
+    export class SceneIndex {
+    public:
+        SceneIndex() = default;
+        SceneIndex(const SceneIndex &) = delete;
+        SceneIndex &operator=(const SceneIndex &) = delete;
+
+        /// 全部渲染单位（遍历期间可能含有空指针）
+        const std::vector<RenderUnit3D *> &GetRenderables() const { return Renderables.Items(); }
+
+        /// 全部带有Behaviour的节点（遍历期间可能含有空指针）
+        const std::vector<Node *> &GetBehaviourNodes() const { return BehaviourNodes.Items(); }
+
+        void AddRenderable(RenderUnit3D *unit) { Renderables.Add(unit); }
+        void RemoveRenderable(RenderUnit3D *unit) { Renderables.Remove(unit, Iterating); }
+        void AddBehaviourNode(Node *node) { BehaviourNodes.Add(node); }
+        void RemoveBehaviourNode(Node *node) { BehaviourNodes.Remove(node, Iterating); }
+
+        /**
+         * 开始遍历
+         * @remark 遍历期间删除的元素置空而不移动，新增的元素追加到末尾
+         */
+        void BeginIteration() {
+            Iterating = true;
+        }
+
+        /// 结束遍历，压缩列表
+        void EndIteration() {
+            Iterating = false;
+            Renderables.Compact();
+            BehaviourNodes.Compact();
+        }
+
+    private:
+        IndexedList<RenderUnit3D> Renderables;
+        IndexedList<Node> BehaviourNodes;
+        bool Iterating = false;
+    };
+
+    void Node::EnterScene(SceneIndex *scene) {
+        if (Scene == scene) return;
+        if (Scene != nullptr) ExitScene();
+        std::vector<Node *> stack{this};
+        while (!stack.empty()) {
+            const auto node = stack.back();
+            stack.pop_back();
+            node->Scene = scene;
+            if (node->Behaviour != nullptr) scene->AddBehaviourNode(node);
+            node->OnEnterScene();
+            for (const auto child: node->Children | std::views::values)
+                stack.push_back(child);
+        }
+    }
+
+    void Node::ExitScene() {
+        if (Scene == nullptr) return;
+        std::vector<Node *> stack{this};
+        while (!stack.empty()) {
+            const auto node = stack.back();
+            stack.pop_back();
+            node->OnExitScene();
+            if (node->Behaviour != nullptr) node->Scene->RemoveBehaviourNode(node);
+            node->Scene = nullptr;
+            for (const auto child: node->Children | std::views::values)
+                stack.push_back(child);
+        }
+    }
+
+    Node::~Node() {
+        if (Scene != nullptr && Behaviour != nullptr)
+            Scene->RemoveBehaviourNode(this);
+        for (const auto child: Children | std::views::values) {
+            delete child;
+        }
+    }
+
+    void Node::SetBehaviour(const std::shared_ptr<CEngine::Behaviour> &behaviour) {
+        if (Scene != nullptr) {
+            if (Behaviour == nullptr && behaviour != nullptr) Scene->AddBehaviourNode(this);
+            else if (Behaviour != nullptr && behaviour == nullptr) Scene->RemoveBehaviourNode(this);
+        }
+        Behaviour = behaviour;
+        if (Behaviour != nullptr)
+            Behaviour->SetParentNode(this);
+    }
+}
@@ -0,0 +1,307 @@
+/**
+ * @file TransformStorage.ixx
+ * @brief 连续存储的变换数据（SoA）
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+export module CEngine.Node:TransformStorage;
+import std;
+import CEngine.Base;
+
+namespace CEngine {
+    /**
+     * @brief 变换数据存储
+     * @remark 以结构数组（SoA）形式保存局部TRS、局部矩阵与世界矩阵，数组按父级在前的顺序排列，\n
+     * 使世界矩阵可以通过一次线性扫描完成计算（SSE/AVX2）\n
+     * 外部通过稳定的SlotID访问，数组重排不影响SlotID
+     */
+    export class TransformStorage {
+    public:
+        using SlotID = std::uint32_t;
+        static constexpr SlotID InvalidSlot = std::numeric_limits<SlotID>::max();
+
+        TransformStorage() = default;
+        TransformStorage(const TransformStorage &) = delete;
+        TransformStorage &operator=(const TransformStorage &) = delete;
+
+        /**
+         * 分配变换槽
+         * @return 新槽ID（无父级，单位变换）
+         */
+        SlotID Allocate() {
+            SlotID id;
+            if (!FreeIDs.empty()) {
+                id = FreeIDs.back();
+                FreeIDs.pop_back();
+            } else {
+                id = static_cast<SlotID>(IDToDense.size());
+                IDToDense.push_back(InvalidSlot);
+            }
+            const auto dense = static_cast<std::uint32_t>(DenseToID.size());
+            IDToDense[id] = dense;
+            DenseToID.push_back(id);
+            ParentIDs.push_back(InvalidSlot);
+            Parents.push_back(InvalidSlot);
+            Positions.emplace_back(0.0f);
+            Rotations.emplace_back();
+            Scales.emplace_back(1.0f);
+            Locals.emplace_back(1.0f);
+            Worlds.emplace_back(1.0f);
+            LocalDirty.push_back(0);
+            Stale = true;
+            return id;
+        }
+
+        /**
+         * 释放变换槽
+         * @remark 该槽的子级将在下次重排时变为根
+         */
+        void Release(const SlotID id) {
+            const auto dense = IDToDense[id];
+            const auto last = static_cast<std::uint32_t>(DenseToID.size() - 1);
+            // 与末尾交换后删除，顺序与父级下标均可能失效，标记重排
+            if (dense != last) MoveEntry(last, dense);
+            PopEntry();
+            IDToDense[id] = InvalidSlot;
+            // 子级可能仍引用该ID，重排之后才允许复用
+            ReleasedIDs.push_back(id);
+            OrderDirty = true;
+            Stale = true;
+        }
+
+        /**
+         * 设置父级
+         * @param id 目标槽
+         * @param parent 父级槽（<code>InvalidSlot</code>表示无父级）
+         */
+        void SetParent(const SlotID id, const SlotID parent) {
+            const auto dense = IDToDense[id];
+            ParentIDs[dense] = parent;
+            const auto parent_dense = parent == InvalidSlot ? InvalidSlot : IDToDense[parent];
+            Parents[dense] = parent_dense;
+            // 父级仍在前面则无需重排
+            if (parent_dense != InvalidSlot && parent_dense > dense)
+                OrderDirty = true;
+            Stale = true;
+        }
+
+        glm::vec3 &Position(const SlotID id) { return Positions[IDToDense[id]]; }
+        EulerRotation &Rotation(const SlotID id) { return Rotations[IDToDense[id]]; }
+        glm::vec3 &Scale(const SlotID id) { return Scales[IDToDense[id]]; }
+
+        /// 标记局部变换已修改
+        void MarkLocalDirty(const SlotID id) {
+            LocalDirty[IDToDense[id]] = 1;
+            Stale = true;
+        }
+
+        /// 获取局部变换矩阵（过期则立即计算）
+        const glm::mat4 &GetLocalMatrix(const SlotID id) {
+            const auto dense = IDToDense[id];
+            if (LocalDirty[dense]) ComputeLocal(dense);
+            return Locals[dense];
+        }
+
+        /**
+         * 获取世界变换矩阵
+         * @remark 若存在未扫描的修改，则沿父级链（连续数组内）即时计算，不写回
+         */
+        glm::mat4 GetWorldMatrix(const SlotID id) {
+            auto dense = IDToDense[id];
+            if (!Stale) return Worlds[dense];
+            glm::mat4 matrix = GetLocalMatrix(id);
+            for (auto parent = ParentIDs[dense]; parent != InvalidSlot && IDToDense[parent] != InvalidSlot; parent = ParentIDs[dense]) {
+                matrix = GetLocalMatrix(parent) * matrix;
+                dense = IDToDense[parent];
+            }
+            return matrix;
+        }
+
+        /**
+         * 刷新全部世界变换矩阵
+         * @remark 必要时先按父级在前的顺序重排，然后一次线性扫描计算全部世界矩阵
+         */
+        void Update() {
+            if (!Stale) return;
+            if (OrderDirty) Reorder();
+            const auto count = DenseToID.size();
+            for (std::size_t i = 0; i < count; ++i) {
+                if (LocalDirty[i]) ComputeLocal(static_cast<std::uint32_t>(i));
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                if (const auto parent = Parents[i]; parent == InvalidSlot)
+                    Worlds[i] = Locals[i];
+                else
+                    MultiplyMatrix(Worlds[parent], Locals[i], Worlds[i]);
+            }
+            Stale = false;
+        }
+
+        /// 槽数量
+        std::size_t Size() const { return DenseToID.size(); }
+
+    private:
+        /// SlotID -> 数组下标
+        std::vector<std::uint32_t> IDToDense;
+        /// 数组下标 -> SlotID
+        std::vector<SlotID> DenseToID;
+        /// 可复用的SlotID
+        std::vector<SlotID> FreeIDs;
+        /// 已释放但尚未重排的SlotID
+        std::vector<SlotID> ReleasedIDs;
+        /// 父级SlotID
+        std::vector<SlotID> ParentIDs;
+        /// 父级数组下标（扫描用）
+        std::vector<std::uint32_t> Parents;
+        std::vector<glm::vec3> Positions;
+        std::vector<EulerRotation> Rotations;
+        std::vector<glm::vec3> Scales;
+        std::vector<glm::mat4> Locals;
+        std::vector<glm::mat4> Worlds;
+        std::vector<std::uint8_t> LocalDirty;
+        /// 数组顺序不再满足父级在前
+        bool OrderDirty = false;
+        /// 存在未扫描的修改
+        bool Stale = false;
+
+        void ComputeLocal(const std::uint32_t dense) {
+            // 与Node3D::UpdateModelMatrix保持一致
+            Locals[dense] = glm::mat4_cast(Rotations[dense].ToOrientation()) * glm::translate(glm::mat4(1.0f), Positions[dense]) *
+                            glm::scale(glm::mat4(1.0f), Scales[dense]);
+            LocalDirty[dense] = 0;
+        }
+
+        void MoveEntry(const std::uint32_t from, const std::uint32_t to) {
+            DenseToID[to] = DenseToID[from];
+            IDToDense[DenseToID[to]] = to;
+            ParentIDs[to] = ParentIDs[from];
+            Positions[to] = Positions[from];
+            Rotations[to] = Rotations[from];
+            Scales[to] = Scales[from];
+            Locals[to] = Locals[from];
+            Worlds[to] = Worlds[from];
+            LocalDirty[to] = LocalDirty[from];
+        }
+
+        void PopEntry() {
+            DenseToID.pop_back();
+            ParentIDs.pop_back();
+            Parents.pop_back();
+            Positions.pop_back();
+            Rotations.pop_back();
+            Scales.pop_back();
+            Locals.pop_back();
+            Worlds.pop_back();
+            LocalDirty.pop_back();
+        }
+
+        /**
+         * 按深度优先顺序重排全部数组
+         * @remark 子树在数组中连续，父级必在子级之前
+         */
+        void Reorder() {
+            const auto count = static_cast<std::uint32_t>(DenseToID.size());
+            // 构建子级链表（下标）
+            std::vector<std::uint32_t> first_child(count, InvalidSlot), next_sibling(count, InvalidSlot);
+            std::vector<std::uint32_t> roots;
+            for (std::uint32_t i = count; i-- > 0;) {
+                const auto parent_id = ParentIDs[i];
+                const auto parent = parent_id == InvalidSlot ? InvalidSlot : IDToDense[parent_id];
+                if (parent == InvalidSlot) {
+                    ParentIDs[i] = InvalidSlot; // 父级已释放
+                    roots.push_back(i);
+                } else {
+                    next_sibling[i] = first_child[parent];
+                    first_child[parent] = i;
+                }
+            }
+            std::vector<std::uint32_t> order;
+            order.reserve(count);
+            std::vector<std::uint32_t> stack(roots.begin(), roots.end());
+            while (!stack.empty()) {
+                const auto i = stack.back();
+                stack.pop_back();
+                order.push_back(i);
+                for (auto c = first_child[i]; c != InvalidSlot; c = next_sibling[c])
+                    stack.push_back(c);
+            }
+            // 按新顺序重建数组
+            auto permute = [&order]<typename T>(std::vector<T> &v) {
+                std::vector<T> tmp;
+                tmp.reserve(v.size());
+                for (const auto i: order) tmp.push_back(v[i]);
+                v.swap(tmp);
+            };
+            permute(DenseToID);
+            permute(ParentIDs);
+            permute(Positions);
+            permute(Rotations);
+            permute(Scales);
+            permute(Locals);
+            permute(Worlds);
+            permute(LocalDirty);
+            for (std::uint32_t i = 0; i < count; ++i)
+                IDToDense[DenseToID[i]] = i;
+            for (std::uint32_t i = 0; i < count; ++i)
+                Parents[i] = ParentIDs[i] == InvalidSlot ? InvalidSlot : IDToDense[ParentIDs[i]];
+            FreeIDs.insert(FreeIDs.end(), ReleasedIDs.begin(), ReleasedIDs.end());
+            ReleasedIDs.clear();
+            OrderDirty = false;
+        }
+
+        /**
+         * out = a * b（列主序）
+         * @remark out可以与b相同
+         */
+        static void MultiplyMatrix(const glm::mat4 &a, const glm::mat4 &b, glm::mat4 &out) {
+            const auto pa = reinterpret_cast<const float *>(&a);
+            const auto pb = reinterpret_cast<const float *>(&b);
+            const auto po = reinterpret_cast<float *>(&out);
+#if defined(__AVX2__)
+            // 一次处理两列：低128位为第j列，高128位为第j+1列
+            const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(pa + 0));
+            const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(pa + 4));
+            const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(pa + 8));
+            const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(pa + 12));
+            const __m256 b01 = _mm256_loadu_ps(pb + 0);
+            const __m256 b23 = _mm256_loadu_ps(pb + 8);
+            auto column_pair = [&](const __m256 bc) {
+                __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, 0x00));
+                r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bc, bc, 0x55)));
+                r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bc, bc, 0xAA)));
+                return _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bc, bc, 0xFF)));
+            };
+            const __m256 r01 = column_pair(b01);
+            const __m256 r23 = column_pair(b23);
+            _mm256_storeu_ps(po + 0, r01);
+            _mm256_storeu_ps(po + 8, r23);
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+            const __m128 a0 = _mm_loadu_ps(pa + 0);
+            const __m128 a1 = _mm_loadu_ps(pa + 4);
+            const __m128 a2 = _mm_loadu_ps(pa + 8);
+            const __m128 a3 = _mm_loadu_ps(pa + 12);
+            __m128 r[4];
+            for (int j = 0; j < 4; ++j) {
+                const __m128 bc = _mm_loadu_ps(pb + j * 4);
+                __m128 v = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, 0x00));
+                v = _mm_add_ps(v, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, 0x55)));
+                v = _mm_add_ps(v, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, 0xAA)));
+                r[j] = _mm_add_ps(v, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, 0xFF)));
+            }
+            for (int j = 0; j < 4; ++j)
+                _mm_storeu_ps(po + j * 4, r[j]);
+#else
+            out = a * b;
+#endif
+        }
+    };
+}
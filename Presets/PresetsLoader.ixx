@@ -6,6 +6,8 @@
  * @date 2024/10/21
  */
 
+module;
+#include "Utils/Profiler.h"
 export module CEngine.PresetsLoader;
 import std;
 import CEngine.Engine;
@@ -14,6 +16,7 @@ import CEngine.Node;
 import CEngine.Logger;
 import CEngine.Utils;
 import CEngine.Presets.Behaviours;
+import CEngine.Profiler;
 
 namespace CEngine {
     export class PresetsLoader {
@@ -21,11 +24,13 @@ namespace CEngine {
         static const char *TAG;
 
         static void LoadAll() {
+            CE_PROFILE_ZONE("PresetsLoader::LoadAll");
             LoadShaderProgram();
             LoadBehaviours();
         }
 
         static void LoadShaderProgram() {
+            CE_PROFILE_ZONE("PresetsLoader::LoadShaderProgram");
             const auto presets_shader_directory = "Shader";
             LogI(TAG) << "加载预设着色器...";
             if (!std::filesystem::exists(presets_shader_directory) || !std::filesystem::is_directory(presets_shader_directory)) {
@@ -41,15 +46,17 @@ namespace CEngine {
                 auto _filename = file.path().filename().string();
                 const auto shader_name = _filename.substr(0, _filename.find_last_of('.'));
                 LogI(TAG) << "加载预设着色器: " << shader_name << " (" << vert_path << ", " << frag_path << ")";
-                auto vert = GLSL::FromFile(vert_path.c_str(), GLSL::ShaderType::Vertex);
-                auto frag = GLSL::FromFile(frag_path.c_str(), GLSL::ShaderType::Fragment);
+                auto vert = GLSL::ReadSource(vert_path.c_str());
+                auto frag = GLSL::ReadSource(frag_path.c_str());
                 if (!vert || !frag) {
                     LogE(TAG) << "预设着色器加载失败: " << shader_name << " (" << vert_path << ", " << frag_path << ")";
+                    continue;
                 }
-                ShaderProgram::Create(shader_name)
-                        ->AddShader(vert.get())
-                        ->AddShader(frag.get())
-                        ->Link();
+                // 命中程序二进制缓存时不编译源码，否则异步编译，不阻塞启动
+                ShaderProgram::CreateFromSourceAsync(shader_name, {
+                                                         {GLSL::ShaderType::Vertex, std::move(*vert), vert_path},
+                                                         {GLSL::ShaderType::Fragment, std::move(*frag), frag_path}
+                                                     });
             }
         }
 
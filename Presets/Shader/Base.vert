@@ -7,8 +7,43 @@
 layout (location = 0) in vec3 Position;
 layout (location = 1) in vec3 Normal;
 layout (location = 2) in vec3 TexCoord;
+layout (std140, binding = 0) uniform Frame_Constants
+{
+    mat4 View;
+    mat4 Projection;
+    mat4 View_Projection;
+    vec4 Camera_Position;
+    vec2 Screen_Size;
+    float Time;
+    float Delta_Time;
+};
+#if defined(CE_MULTI_DRAW)
+layout (std430, binding = 0) readonly buffer Instance_Data
+{
+    mat4 Instance_Transforms[];
+};
+struct Draw_Record
+{
+    uint Instance_Offset;
+    uint Instance_Count;
+};
+layout (std430, binding = 1) readonly buffer Draw_Data
+{
+    Draw_Record Draw_Records[];
+};
+layout (location = 1) uniform uint Draw_Offset;
+#define CE_TRANSFORM Instance_Transforms[Draw_Records[Draw_Offset + gl_DrawID].Instance_Offset + gl_InstanceID]
+#elif defined(CE_INSTANCED)
+layout (std430, binding = 0) readonly buffer Instance_Data
+{
+    mat4 Instance_Transforms[];
+};
+#define CE_TRANSFORM Instance_Transforms[gl_BaseInstance + gl_InstanceID]
+#else
 layout (location = 0) uniform mat4 Transform;
+#define CE_TRANSFORM Transform
+#endif
 
 void main() {
-    gl_Position = Transform * vec4(Position, 1.0);
+    gl_Position = CE_TRANSFORM * vec4(Position, 1.0);
 }
\ No newline at end of file
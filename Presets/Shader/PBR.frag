@@ -7,6 +7,7 @@
 in vec3 Vertex_Position;
 in vec3 Vertex_Normal;
 in vec2 UV;
+flat in uint Material_ID;
 
 layout (location = 0) uniform mat4 Transform;
 
@@ -30,9 +31,40 @@ uniform sampler2D Tex_AmbientOcclusion;
 uniform sampler2D Tex_Sheen;
 uniform sampler2D Tex_Clearcoat;
 uniform sampler2D Tex_Transmission;
+uniform sampler2DArray Tex_Atlas;
+
+struct Atlas_Ref
+{
+    vec4 Rect;
+    int Layer;
+};
+struct Material_Parameters
+{
+    float Emissive_Intensity;
+    float Metallic;
+    float Roughness;
+    float Opacity;
+    vec4 Diffuse_Color;
+    vec4 Specular_Color;
+    vec4 Emission_Color;
+    vec4 Reflective_Color;
+    vec4 Transparent_Color;
+    Atlas_Ref Atlas[4]; // Diffuse, Normals, Metalness, DiffuseRoughness
+};
+layout (std430, binding = 2) readonly buffer Material_Data
+{
+    Material_Parameters Materials[];
+};
 
 out vec4 FragColor;
 
+vec4 SampleDiffuse() {
+    Atlas_Ref ref = Materials[Material_ID].Atlas[0];
+    if (ref.Layer >= 0)
+        return texture(Tex_Atlas, vec3(fract(UV) * ref.Rect.xy + ref.Rect.zw, ref.Layer));
+    return texture(Tex_Diffuse, UV);
+}
+
 void main() {
-    FragColor = texture(Tex_Diffuse, UV);
+    FragColor = SampleDiffuse();
 }
\ No newline at end of file
@@ -5,10 +5,72 @@
 #version 460
 
 layout (location = 0) in vec3 Position;
+#if defined(CE_OCT_NORMAL)
+layout (location = 1) in vec2 Normal_Octahedral;
+vec3 Decode_Octahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+#define CE_NORMAL Decode_Octahedral(Normal_Octahedral)
+#else
 layout (location = 1) in vec3 Normal;
+#define CE_NORMAL Normal
+#endif
 layout (location = 2) in vec2 TexCoord;
 
+layout (std140, binding = 0) uniform Frame_Constants
+{
+    mat4 View;
+    mat4 Projection;
+    mat4 View_Projection;
+    vec4 Camera_Position;
+    vec2 Screen_Size;
+    float Time;
+    float Delta_Time;
+};
+
+#if defined(CE_MULTI_DRAW)
+layout (std430, binding = 0) readonly buffer Instance_Data
+{
+    mat4 Instance_Transforms[];
+};
+struct Draw_Record
+{
+    uint Instance_Offset;
+    uint Instance_Count;
+};
+layout (std430, binding = 1) readonly buffer Draw_Data
+{
+    Draw_Record Draw_Records[];
+};
+layout (location = 1) uniform uint Draw_Offset;
+layout (std430, binding = 3) readonly buffer Instance_Material_Data
+{
+    uint Instance_Materials[];
+};
+#define CE_INSTANCE_INDEX (Draw_Records[Draw_Offset + gl_DrawID].Instance_Offset + gl_InstanceID)
+#define CE_TRANSFORM Instance_Transforms[CE_INSTANCE_INDEX]
+#define CE_MATERIAL Instance_Materials[CE_INSTANCE_INDEX]
+#elif defined(CE_INSTANCED)
+layout (std430, binding = 0) readonly buffer Instance_Data
+{
+    mat4 Instance_Transforms[];
+};
+layout (std430, binding = 3) readonly buffer Instance_Material_Data
+{
+    uint Instance_Materials[];
+};
+#define CE_TRANSFORM Instance_Transforms[gl_BaseInstance + gl_InstanceID]
+#define CE_MATERIAL Instance_Materials[gl_BaseInstance + gl_InstanceID]
+#else
 layout (location = 0) uniform mat4 Transform;
+uniform uint Material_Index;
+#define CE_TRANSFORM Transform
+#define CE_MATERIAL Material_Index
+#endif
 
 uniform sampler2D Tex_Diffuse;
 uniform sampler2D Tex_Specular;
@@ -31,26 +93,15 @@ uniform sampler2D Tex_Sheen;
 uniform sampler2D Tex_Clearcoat;
 uniform sampler2D Tex_Transmission;
 
-layout (std140) uniform Material_Parameters
-{
-    float Emissive_Intensity;
-    float Metallic;
-    float Roughness;
-    float Opacity;
-    vec4 Diffuse_Color;
-    vec4 Specular_Color;
-    vec4 Emission_Color;
-    vec4 Reflective_Color;
-    vec4 Transparent_Color;
-};
-
 out vec3 Vertex_Position;
 out vec3 Vertex_Normal;
 out vec2 UV;
+flat out uint Material_ID;
 
 void main() {
-    gl_Position = Transform * vec4(Position, 1.0);
+    gl_Position = CE_TRANSFORM * vec4(Position, 1.0);
     Vertex_Position = Position;
-    Vertex_Normal = Normal;
+    Vertex_Normal = CE_NORMAL;
     UV = TexCoord;
+    Material_ID = CE_MATERIAL;
 }
\ No newline at end of file
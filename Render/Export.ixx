@@ -2,10 +2,20 @@ export module CEngine.Render;
 export import :GLSL;
 export import :ShaderProgram;
 export import :Mesh;
+export import :MeshArena;
+export import :VertexLayout;
+export import :MeshOptimizer;
 export import :Material;
+export import :MaterialPool;
 export import :Texture;
+export import :TextureAtlas;
 export import :ShaderUniformVar;
+export import :UniformOverrides;
 export import :Camera;
+export import :RenderQueue;
+export import :FrameRingBuffer;
+export import :GPUProfiler;
+export import :GLState;
 
 namespace CEngine {
     // @formatter:off
@@ -0,0 +1,166 @@
+/**
+ * @file FrameRingBuffer.ixx
+ * @brief 帧环形缓冲
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+export module CEngine.Render:FrameRingBuffer;
+import :GLState;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /**
+     * @brief 帧环形缓冲
+     * @remark 一块持久映射（GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT）的缓冲，按FrameCount等分为若干区域，每帧写入其中一块；\n
+     * 每帧结束时在该区域上放置glFenceSync，再次轮到该区域时等待其栅栏，保证CPU不会覆盖GPU尚未读取的数据；\n
+     * 区域容量不足时重建更大的缓冲（旧缓冲由驱动在GPU使用完毕后释放）
+     */
+    export class FrameRingBuffer {
+    public:
+        const static char *TAG;
+
+        /// 同时在途的帧数
+        static constexpr std::uint32_t FrameCount = 3;
+        /// 初始区域大小（字节）
+        static constexpr std::size_t DefaultRegionSize = 1u << 20;
+
+        FrameRingBuffer() = default;
+        FrameRingBuffer(const FrameRingBuffer &) = delete;
+        FrameRingBuffer &operator=(const FrameRingBuffer &) = delete;
+
+        ~FrameRingBuffer() {
+            Release();
+        }
+
+        /// 分配结果
+        struct Allocation {
+            /// @brief 在缓冲中的偏移（字节）
+            GLintptr Offset = 0;
+            /// @brief 映射地址
+            void *Pointer = nullptr;
+        };
+
+        /**
+         * 开始一帧
+         * @remark 切换到下一块区域并等待其栅栏
+         * @param required 本帧需要的字节数（含对齐填充）
+         */
+        void BeginFrame(const std::size_t required) {
+            if (Buffer == 0 || required > RegionSize) {
+                auto size = std::max(RegionSize, DefaultRegionSize);
+                while (size < required) size *= 2;
+                Create(size);
+            }
+            Frame = (Frame + 1) % FrameCount;
+            if (const auto fence = Fences[Frame]; fence != nullptr) {
+                if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                    ++Stalls;
+                    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+                    }
+                }
+                glDeleteSync(fence);
+                Fences[Frame] = nullptr;
+            }
+            Offset = 0;
+        }
+
+        /**
+         * 在当前区域中分配
+         * @param size 大小（字节）
+         * @param alignment 偏移对齐
+         * @return 超出BeginFrame声明的容量时返回<code>std::nullopt</code>
+         */
+        std::optional<Allocation> Allocate(const std::size_t size, const std::size_t alignment) {
+            const auto offset = AlignUp(Offset, alignment);
+            if (offset + size > RegionSize) {
+                LogE(TAG) << "帧环形缓冲区域不足: " << offset + size << " > " << RegionSize;
+                return std::nullopt;
+            }
+            Offset = offset + size;
+            const auto absolute = static_cast<GLintptr>(Frame * RegionSize + offset);
+            return Allocation{absolute, Mapped + absolute};
+        }
+
+        /**
+         * 写入数据
+         * @param data 数据
+         * @param size 大小（字节）
+         * @param alignment 偏移对齐
+         * @return 在缓冲中的偏移，失败返回<code>std::nullopt</code>
+         */
+        std::optional<GLintptr> Write(const void *data, const std::size_t size, const std::size_t alignment) {
+            const auto alloc = Allocate(size, alignment);
+            if (!alloc) return std::nullopt;
+            std::memcpy(alloc->Pointer, data, size);
+            return alloc->Offset;
+        }
+
+        /// 结束一帧，在当前区域上放置栅栏
+        void EndFrame() {
+            if (Buffer == 0) return;
+            Fences[Frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        /// 向上对齐
+        static std::size_t AlignUp(const std::size_t value, const std::size_t alignment) {
+            return alignment <= 1 ? value : (value + alignment - 1) / alignment * alignment;
+        }
+
+        /// @property Buffer
+        unsigned int getBuffer() const { return Buffer; }
+
+        /// @property RegionSize
+        std::size_t getRegionSize() const { return RegionSize; }
+
+        /// 等待栅栏的次数（CPU领先GPU超过FrameCount帧）
+        std::uint64_t GetStallCount() const { return Stalls; }
+
+        /**
+         * 释放GPU资源
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        void Release() {
+            for (auto &fence: Fences) {
+                if (fence != nullptr) glDeleteSync(fence);
+                fence = nullptr;
+            }
+            if (Buffer != 0) {
+                GLState::BindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+                GLState::DeleteBuffer(Buffer);
+            }
+            Buffer = 0;
+            Mapped = nullptr;
+            RegionSize = 0;
+        }
+
+    private:
+        void Create(const std::size_t region_size) {
+            Release();
+            constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            const auto size = static_cast<GLsizeiptr>(region_size * FrameCount);
+            glGenBuffers(1, &Buffer);
+            GLState::BindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+            glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+            Mapped = static_cast<std::byte *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+            RegionSize = region_size;
+            Frame = 0;
+            LogD(TAG) << "创建帧环形缓冲: " << FrameCount << " x " << region_size << "字节";
+        }
+
+        unsigned int Buffer = 0;
+        std::byte *Mapped = nullptr;
+        std::size_t RegionSize = 0;
+        std::size_t Offset = 0;
+        std::uint32_t Frame = 0;
+        std::array<GLsync, FrameCount> Fences{};
+        std::uint64_t Stalls = 0;
+    };
+
+    const char *FrameRingBuffer::TAG = "FrameRingBuffer";
+}
@@ -18,13 +18,10 @@ import CEngine.Logger;
 import CEngine.Utils;
 
 namespace CEngine {
-    const std::regex ShaderUniformPattern_1(R"(^uniform\s(\w+?)\s(\w+))");
-    const std::regex ShaderUniformPattern_2(R"(layout.*?uniform\s(\w+?)\s(\w+))");
-
     /**
      * @brief GLSL文件类\n
      * 用于读取GLSL文件并进行编译\n
-     * @remark 编译完成后请传入ShaderProgram类
+     * @remark 编译完成后请传入ShaderProgram类，Uniform信息由ShaderProgram链接后反射获得
      */
     export class GLSL final : public Object {
     public:
@@ -49,19 +46,40 @@ namespace CEngine {
          * @param name 异常输出标识
          */
         static std::shared_ptr<GLSL> FromSource(const std::string &glsl_source, const ShaderType shader_type, const char *name = "源码编译") {
+            auto glsl = Submit(glsl_source, shader_type, name);
+            return glsl->CheckCompile() ? glsl : nullptr;
+        }
+
+        /**
+         * 提交编译，不等待结果
+         * @remark 驱动支持并行编译时在后台编译；之后以CheckCompile取得结果（未完成时会等待）
+         * @param glsl_source glsl源码
+         * @param shader_type 着色器类型（枚举：ShaderType）
+         * @param name 异常输出标识
+         */
+        static std::shared_ptr<GLSL> Submit(const std::string &glsl_source, const ShaderType shader_type, const char *name = "源码编译") {
             const unsigned int id = glCreateShader(static_cast<GLenum>(shader_type));
             const char *source = glsl_source.c_str();
             glShaderSource(id, 1, &source, nullptr);
             glCompileShader(id);
+            return std::make_shared<GLSL>(id, name, glsl_source, shader_type);
+        }
+
+        /**
+         * 检查编译结果
+         * @remark 编译失败时输出InfoLog
+         * @return 是否编译成功
+         */
+        bool CheckCompile() const {
             int success_flag = 0;
-            glGetShaderiv(id, GL_COMPILE_STATUS, &success_flag);
+            glGetShaderiv(shader_id, GL_COMPILE_STATUS, &success_flag);
             if (success_flag == GL_FALSE) {
                 char info_log[512];
-                glGetShaderInfoLog(id, 512, nullptr, info_log);
-                LogE(TAG) << "着色器编译错误: " << name << "\nInfoLog: " << info_log;
-                return nullptr;
+                glGetShaderInfoLog(shader_id, 512, nullptr, info_log);
+                LogE(TAG) << "着色器编译错误: " << Name << "\nInfoLog: " << info_log;
+                return false;
             }
-            return std::make_shared<GLSL>(id, name, GetShaderUniformsFromSource(glsl_source));
+            return true;
         }
 
         /**
@@ -70,45 +88,55 @@ namespace CEngine {
          * @param shader_type 着色器类型（枚举：ShaderType）
          */
         static std::shared_ptr<GLSL> FromFile(const char *file_path, const ShaderType shader_type) {
+            const auto glsl_source = ReadSource(file_path);
+            if (!glsl_source) return nullptr;
+            LogI(TAG) << "正在编译着色器: " << file_path;
+            return FromSource(*glsl_source, shader_type, file_path);
+        }
+
+        /**
+         * 读取GLSL文件（不编译）
+         * @param file_path 文件路径
+         * @return 文件不存在或读取失败返回<code>std::nullopt</code>
+         */
+        static std::optional<std::string> ReadSource(const char *file_path) {
             if (!Utils::FileExists(file_path)) {
                 LogE(TAG) << "文件不存在: " << file_path;
-                return nullptr;
+                return std::nullopt;
             }
-            LogI(TAG) << "正在编译着色器: " << file_path;
             std::ifstream file;
             file.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-            std::string glsl_source;
             try {
                 file.open(file_path);
                 std::stringstream ss;
                 ss << file.rdbuf();
-                glsl_source = ss.str();
                 file.close();
+                return ss.str();
             } catch (const std::ifstream::failure &e) {
                 LogE(TAG) << "读取glsl文件时发生错误: " << file_path << "\n错误信息: " << e.what();
-                return nullptr;
+                return std::nullopt;
             }
-            return FromSource(glsl_source, shader_type, file_path);
         }
 
-        static std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > GetShaderUniformsFromSource(const std::string &glsl_source) {
-            std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > uniforms;
-            std::smatch match;
-            auto it = glsl_source.cbegin();
-            while (std::regex_search(it, glsl_source.cend(), match, ShaderUniformPattern_1)) {
-                it = match[0].second;
-                uniforms.insert({ShaderUniformVar::StringToType(match[1]), match[2]});
-            }
-            it = glsl_source.cbegin();
-            while (std::regex_search(it, glsl_source.cend(), match, ShaderUniformPattern_2)) {
-                it = match[0].second;
-                uniforms.insert({ShaderUniformVar::StringToType(match[1]), match[2]});
-            }
-            return std::move(uniforms);
+        GLSL(const unsigned int id, std::string name, std::string source, const ShaderType type)
+            : shader_id(id), Name(std::move(name)), Source(std::move(source)), Type(type) {
         }
 
-        GLSL(const unsigned int id, std::string name, std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > &&uniforms)
-            : shader_id(id), UniformsList(std::move(uniforms)), Name(std::move(name)) {
+        /**
+         * 在源码的#version之后插入宏定义
+         * @param glsl_source glsl源码
+         * @param defines 宏名称列表
+         * @return 插入后的源码
+         */
+        static std::string InjectDefines(const std::string &glsl_source, const std::vector<std::string> &defines) {
+            std::string block;
+            for (const auto &define: defines)
+                block += std::format("#define {}\n", define);
+            auto pos = glsl_source.find("#version");
+            if (pos == std::string::npos) return block + glsl_source;
+            pos = glsl_source.find('\n', pos);
+            if (pos == std::string::npos) return glsl_source + "\n" + block;
+            return std::string(glsl_source).insert(pos + 1, block);
         }
 
         GLSL(const GLSL &) = delete;
@@ -125,23 +153,30 @@ namespace CEngine {
             return shader_id;
         }
 
-        /// @property UniformsList
-        std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > &getUniformsList() {
-            return UniformsList;
-        }
-
         /// @property Name
         std::string getName() const {
             return Name;
         }
 
+        /// @property Source
+        const std::string &getSource() const {
+            return Source;
+        }
+
+        /// @property Type
+        ShaderType getType() const {
+            return Type;
+        }
+
     private:
         /// @brief 着色器ID
         unsigned int shader_id = 0;
-        /// @brief GLSL中Uniform列表
-        std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > UniformsList;
         /// 仅用作为异常输出标识
         std::string Name;
+        /// @brief 源码（用于编译变体）
+        std::string Source;
+        /// @brief 着色器类型
+        ShaderType Type;
     };
 
     const char *GLSL::TAG = "GLSL";
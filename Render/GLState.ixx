@@ -0,0 +1,268 @@
+/**
+ * @file GLState.ixx
+ * @brief OpenGL状态缓存
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+export module CEngine.Render:GLState;
+import std;
+
+namespace CEngine {
+    /**
+     * @brief OpenGL状态缓存
+     * @remark 记录当前绑定的程序、VAO、缓冲、纹理单元、采样器及启用标志，与当前状态相同的调用不再提交给驱动\n
+     * 引擎内所有绑定操作均应经过此类；第三方代码（如ImGui）修改状态后请调用Invalidate\n
+     * 删除对象请使用此类的Delete*函数，避免名称复用后缓存误判
+     */
+    export class GLState {
+    public:
+        GLState() = delete;
+
+        /// 最大跟踪的纹理单元数
+        static constexpr unsigned int MaxTextureUnits = 32;
+        /// 最大跟踪的索引绑定点数
+        static constexpr unsigned int MaxIndexedBindings = 32;
+
+        /// glUseProgram
+        static void UseProgram(const unsigned int program) {
+            if (Program == program) return;
+            glUseProgram(program);
+            Program = program;
+        }
+
+        /// glBindVertexArray
+        static void BindVertexArray(const unsigned int vao) {
+            if (VertexArray == vao) return;
+            glBindVertexArray(vao);
+            VertexArray = vao;
+            // 索引缓冲绑定属于VAO状态
+            Buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+
+        /// glBindBuffer
+        static void BindBuffer(const GLenum target, const unsigned int buffer) {
+            if (const auto it = Buffers.find(target); it != Buffers.end() && it->second == buffer) return;
+            glBindBuffer(target, buffer);
+            Buffers[target] = buffer;
+        }
+
+        /**
+         * glBindBufferBase
+         * @remark 同时会修改通用绑定点
+         */
+        static void BindBufferBase(const GLenum target, const unsigned int index, const unsigned int buffer) {
+            BindBufferRange(target, index, buffer, 0, 0);
+        }
+
+        /**
+         * glBindBufferRange
+         * @remark size为0时等同于glBindBufferBase
+         */
+        static void BindBufferRange(const GLenum target, const unsigned int index, const unsigned int buffer, const GLintptr offset,
+                                    const GLsizeiptr size) {
+            IndexedBinding *binding = nullptr;
+            if (const auto slot = IndexedSlot(target); slot >= 0 && index < MaxIndexedBindings) {
+                binding = &IndexedBindings[slot][index];
+                if (binding->Buffer == buffer && binding->Offset == offset && binding->Size == size) return;
+            }
+            if (size == 0) glBindBufferBase(target, index, buffer);
+            else glBindBufferRange(target, index, buffer, offset, size);
+            if (binding != nullptr) *binding = {buffer, offset, size};
+            Buffers[target] = buffer;
+        }
+
+        /// glActiveTexture
+        static void ActiveTexture(const unsigned int unit) {
+            if (ActiveUnit == unit) return;
+            glActiveTexture(GL_TEXTURE0 + unit);
+            ActiveUnit = unit;
+        }
+
+        /**
+         * 将纹理绑定到指定纹理单元
+         * @param unit 纹理单元
+         * @param target 纹理类型
+         * @param texture 纹理ID
+         */
+        static void BindTexture(const unsigned int unit, const GLenum target, const unsigned int texture) {
+            const auto slot = TextureSlot(target);
+            if (slot >= 0 && unit < MaxTextureUnits && Textures[unit][slot] == texture) return;
+            ActiveTexture(unit);
+            glBindTexture(target, texture);
+            if (slot >= 0 && unit < MaxTextureUnits) Textures[unit][slot] = texture;
+        }
+
+        /// 将纹理绑定到当前纹理单元
+        static void BindTexture(const GLenum target, const unsigned int texture) {
+            BindTexture(ActiveUnit == Unknown ? 0 : ActiveUnit, target, texture);
+        }
+
+        /// glBindSampler
+        static void BindSampler(const unsigned int unit, const unsigned int sampler) {
+            if (unit < MaxTextureUnits && Samplers[unit] == sampler) return;
+            glBindSampler(unit, sampler);
+            if (unit < MaxTextureUnits) Samplers[unit] = sampler;
+        }
+
+        /// glEnable / glDisable
+        static void SetEnabled(const GLenum cap, const bool enabled) {
+            if (const auto it = Capabilities.find(cap); it != Capabilities.end() && it->second == enabled) return;
+            if (enabled) glEnable(cap);
+            else glDisable(cap);
+            Capabilities[cap] = enabled;
+        }
+
+        static void Enable(const GLenum cap) { SetEnabled(cap, true); }
+
+        static void Disable(const GLenum cap) { SetEnabled(cap, false); }
+
+        /// glDepthMask
+        static void DepthMask(const bool enabled) {
+            const int value = enabled ? 1 : 0;
+            if (DepthWrite == value) return;
+            glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+            DepthWrite = value;
+        }
+
+        /// glBlendFunc
+        static void BlendFunc(const GLenum src, const GLenum dst) {
+            if (BlendSrc == src && BlendDst == dst) return;
+            glBlendFunc(src, dst);
+            BlendSrc = src;
+            BlendDst = dst;
+        }
+
+        /// 删除程序
+        static void DeleteProgram(const unsigned int program) {
+            glDeleteProgram(program);
+            if (Program == program) Program = Unknown; // 仍在使用的程序延迟删除，状态未知
+        }
+
+        /// 删除VAO
+        static void DeleteVertexArray(const unsigned int vao) {
+            glDeleteVertexArrays(1, &vao);
+            if (VertexArray == vao) {
+                VertexArray = 0;
+                Buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+            }
+        }
+
+        /// 删除缓冲
+        static void DeleteBuffer(const unsigned int buffer) {
+            glDeleteBuffers(1, &buffer);
+            for (auto &bound: Buffers | std::views::values)
+                if (bound == buffer) bound = 0;
+            for (auto &bindings: IndexedBindings)
+                for (auto &binding: bindings)
+                    if (binding.Buffer == buffer) binding = {};
+        }
+
+        /// 删除纹理
+        static void DeleteTexture(const unsigned int texture) {
+            glDeleteTextures(1, &texture);
+            for (auto &unit: Textures)
+                for (auto &bound: unit)
+                    if (bound == texture) bound = 0;
+        }
+
+        /// 删除采样器
+        static void DeleteSampler(const unsigned int sampler) {
+            glDeleteSamplers(1, &sampler);
+            for (auto &bound: Samplers)
+                if (bound == sampler) bound = 0;
+        }
+
+        /// @property Program
+        static unsigned int GetProgram() { return Program; }
+
+        /// @property VertexArray
+        static unsigned int GetVertexArray() { return VertexArray; }
+
+        /**
+         * 使缓存失效
+         * @remark 之后的每个调用都会提交一次给驱动
+         */
+        static void Invalidate() {
+            Program = Unknown;
+            VertexArray = Unknown;
+            ActiveUnit = Unknown;
+            Buffers.clear();
+            for (auto &bindings: IndexedBindings)
+                bindings.fill(IndexedBinding{Unknown, -1, -1});
+            for (auto &unit: Textures)
+                unit.fill(Unknown);
+            Samplers.fill(Unknown);
+            Capabilities.clear();
+            DepthWrite = -1;
+            BlendSrc = BlendDst = Unknown;
+        }
+
+    private:
+        /// 未知状态
+        static constexpr unsigned int Unknown = std::numeric_limits<unsigned int>::max();
+        /// 跟踪的纹理类型数
+        static constexpr int TextureTargetCount = 3;
+
+        struct IndexedBinding {
+            unsigned int Buffer = 0;
+            GLintptr Offset = 0;
+            GLsizeiptr Size = 0;
+        };
+
+        static int TextureSlot(const GLenum target) {
+            switch (target) {
+                case GL_TEXTURE_2D: return 0;
+                case GL_TEXTURE_2D_ARRAY: return 1;
+                case GL_TEXTURE_CUBE_MAP: return 2;
+                default: return -1;
+            }
+        }
+
+        static int IndexedSlot(const GLenum target) {
+            switch (target) {
+                case GL_UNIFORM_BUFFER: return 0;
+                case GL_SHADER_STORAGE_BUFFER: return 1;
+                default: return -1;
+            }
+        }
+
+        static unsigned int Program;
+        static unsigned int VertexArray;
+        static unsigned int ActiveUnit;
+        static std::unordered_map<GLenum, unsigned int> Buffers;
+        static std::array<std::array<IndexedBinding, MaxIndexedBindings>, 2> IndexedBindings;
+        static std::array<std::array<unsigned int, TextureTargetCount>, MaxTextureUnits> Textures;
+        static std::array<unsigned int, MaxTextureUnits> Samplers;
+        static std::unordered_map<GLenum, bool> Capabilities;
+        static int DepthWrite;
+        static GLenum BlendSrc, BlendDst;
+    };
+
+    unsigned int GLState::Program = GLState::Unknown;
+    unsigned int GLState::VertexArray = GLState::Unknown;
+    unsigned int GLState::ActiveUnit = GLState::Unknown;
+    std::unordered_map<GLenum, unsigned int> GLState::Buffers;
+    std::array<std::array<GLState::IndexedBinding, GLState::MaxIndexedBindings>, 2> GLState::IndexedBindings = [] {
+        std::array<std::array<IndexedBinding, MaxIndexedBindings>, 2> bindings{};
+        for (auto &b: bindings) b.fill(IndexedBinding{Unknown, -1, -1});
+        return bindings;
+    }();
+    std::array<std::array<unsigned int, GLState::TextureTargetCount>, GLState::MaxTextureUnits> GLState::Textures = [] {
+        std::array<std::array<unsigned int, TextureTargetCount>, MaxTextureUnits> textures{};
+        for (auto &unit: textures) unit.fill(Unknown);
+        return textures;
+    }();
+    std::array<unsigned int, GLState::MaxTextureUnits> GLState::Samplers = [] {
+        std::array<unsigned int, MaxTextureUnits> samplers{};
+        samplers.fill(Unknown);
+        return samplers;
+    }();
+    std::unordered_map<GLenum, bool> GLState::Capabilities;
+    int GLState::DepthWrite = -1;
+    GLenum GLState::BlendSrc = GLState::Unknown;
+    GLenum GLState::BlendDst = GLState::Unknown;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file GPUProfiler.ixx
+ * @brief GPU计时
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+export module CEngine.Render:GPUProfiler;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /// 一个计时区间的结果
+    export struct GPUTiming {
+        std::string Name;
+        /// @brief 嵌套深度（0为整帧）
+        std::uint32_t Depth = 0;
+        /// @brief 相对于帧开始的时间(ms)
+        double Start = 0;
+        /// @brief 用时(ms)
+        double Duration = 0;
+    };
+
+    /**
+     * @brief GPU计时器
+     * @remark 每个区间的开始与结束各放置一个GL_TIMESTAMP查询（可任意嵌套），查询按帧放在FrameCount个轮换的集合中，\n
+     * 再次轮到某一帧时才读取其结果，读取前检查GL_QUERY_RESULT_AVAILABLE，结果未就绪时丢弃该帧而不等待；\n
+     * 区间同时以glPushDebugGroup/glPopDebugGroup（KHR_debug）标记，外部调试工具可见相同的结构
+     */
+    export class GPUProfiler {
+    public:
+        const static char *TAG;
+
+        GPUProfiler() = delete;
+
+        /// 同时在途的帧数
+        static constexpr std::uint32_t FrameCount = 3;
+
+        /// 是否计时（在下一次BeginFrame生效）
+        static void SetEnabled(const bool enabled) { Enabled = enabled; }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /// 是否输出调试组（默认关闭，仅在计时启用时生效；在下一次BeginFrame生效）
+        static void SetDebugGroupsEnabled(const bool enabled) { DebugGroupsEnabled = enabled; }
+
+        static bool IsDebugGroupsEnabled() { return DebugGroupsEnabled; }
+
+        /// 是否按绘制组（相同ShaderProgram的连续批次）计时，见RenderQueue::Flush
+        static void SetDrawGroupTiming(const bool enabled) { DrawGroupTiming = enabled; }
+
+        static bool IsDrawGroupTiming() { return DrawGroupTiming; }
+
+        /**
+         * 开始一帧
+         * @remark 读取已就绪的较早帧的结果，并开始名为Frame的最外层区间
+         */
+        static void BeginFrame() {
+            FrameActive = Enabled;
+            FrameDebugGroups = Enabled && DebugGroupsEnabled;
+            Stack.clear();
+            // 从最早的帧（即将复用的集合）开始读取已就绪的帧，复用的集合未就绪时丢弃
+            Current = (Current + 1) % FrameCount;
+            for (std::uint32_t i = 0; i < FrameCount; ++i) {
+                auto &frame = Frames[(Current + i) % FrameCount];
+                if (!frame.Pending) continue;
+                if (IsAvailable(frame)) Resolve(frame);
+                else if (i == 0) {
+                    frame.Pending = false;
+                    ++DroppedFrames;
+                }
+            }
+            auto &frame = Frames[Current];
+            frame.Markers.clear();
+            frame.Used = 0;
+            frame.Number = ++FrameNumber;
+            Push("Frame");
+        }
+
+        /// 结束一帧
+        static void EndFrame() {
+            if (FrameActive && Stack.size() > 1) LogW(TAG) << "GPU计时区间未闭合: " << Frames[Current].Markers[Stack.back()].Name;
+            while (Stack.size() > 1) Pop();
+            Pop();
+            Frames[Current].Pending = FrameActive && !Frames[Current].Markers.empty();
+            FrameActive = false;
+        }
+
+        /**
+         * 开始一个区间
+         * @remark 须与Pop成对调用，建议使用GPUProfileScope
+         * @param name 名称
+         */
+        static void Push(const std::string_view name) {
+            if (FrameDebugGroups) glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, static_cast<GLsizei>(name.size()), name.data());
+            if (!FrameActive) return;
+            auto &frame = Frames[Current];
+            Stack.push_back(static_cast<std::uint32_t>(frame.Markers.size()));
+            auto &marker = frame.Markers.emplace_back();
+            marker.Name = name;
+            marker.Depth = static_cast<std::uint32_t>(Stack.size() - 1);
+            marker.Begin = Timestamp(frame);
+        }
+
+        /// 结束最近的区间
+        static void Pop() {
+            if (FrameDebugGroups) glPopDebugGroup();
+            if (!FrameActive || Stack.empty()) return;
+            auto &frame = Frames[Current];
+            frame.Markers[Stack.back()].End = Timestamp(frame);
+            Stack.pop_back();
+        }
+
+        /**
+         * 最近读取的一帧的结果
+         * @remark 按区间开始的顺序排列，第一项为整帧；通常落后当前帧FrameCount - 1帧
+         */
+        static const std::vector<GPUTiming> &GetResults() { return Results; }
+
+        /// 结果所属的帧序号（尚无结果时为0）
+        static std::uint64_t GetResultFrame() { return ResultFrame; }
+
+        /// 结果中整帧的GPU用时(ms)
+        static double GetFrameTime() { return Results.empty() ? 0.0 : Results.front().Duration; }
+
+        /**
+         * 结果中指定区间的用时
+         * @param name 名称（同名区间累加）
+         * @return 不存在返回<code>std::nullopt</code>
+         */
+        static std::optional<double> GetTime(const std::string_view name) {
+            std::optional<double> time;
+            for (const auto &timing: Results)
+                if (timing.Name == name) time = time.value_or(0.0) + timing.Duration;
+            return time;
+        }
+
+        /// 因结果未及时就绪而丢弃的帧数
+        static std::uint64_t GetDroppedFrames() { return DroppedFrames; }
+
+        /**
+         * 释放查询对象
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        static void Release() {
+            for (auto &frame: Frames) {
+                if (!frame.Queries.empty()) glDeleteQueries(static_cast<GLsizei>(frame.Queries.size()), frame.Queries.data());
+                frame = {};
+            }
+        }
+
+    private:
+        struct Marker {
+            std::string Name;
+            std::uint32_t Depth = 0;
+            /// @brief 开始与结束的查询在Queries中的下标
+            std::uint32_t Begin = 0;
+            std::uint32_t End = 0;
+        };
+
+        struct FrameQueries {
+            std::vector<GLuint> Queries;
+            std::uint32_t Used = 0;
+            std::vector<Marker> Markers;
+            std::uint64_t Number = 0;
+            /// @brief 已提交、等待读取
+            bool Pending = false;
+        };
+
+        /// 放置一个时间戳查询，返回其下标
+        static std::uint32_t Timestamp(FrameQueries &frame) {
+            if (frame.Used == frame.Queries.size()) {
+                const auto grow = std::max<std::size_t>(frame.Queries.size(), 32);
+                frame.Queries.resize(frame.Queries.size() + grow);
+                glGenQueries(static_cast<GLsizei>(grow), frame.Queries.data() + frame.Used);
+            }
+            glQueryCounter(frame.Queries[frame.Used], GL_TIMESTAMP);
+            return frame.Used++;
+        }
+
+        /// 查询按提交顺序完成，最后一个就绪即全部就绪
+        static bool IsAvailable(const FrameQueries &frame) {
+            if (frame.Used == 0) return true;
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(frame.Queries[frame.Used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            return available == GL_TRUE;
+        }
+
+        static void Resolve(FrameQueries &frame) {
+            frame.Pending = false;
+            std::vector<GLuint64> stamps(frame.Used);
+            for (std::uint32_t i = 0; i < frame.Used; ++i)
+                glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &stamps[i]);
+            const auto origin = stamps[frame.Markers.front().Begin];
+            const auto to_ms = [](const GLuint64 ns) { return static_cast<double>(ns) / 1e6; };
+            Results.clear();
+            for (const auto &marker: frame.Markers) {
+                const auto begin = stamps[marker.Begin];
+                const auto end = std::max(stamps[marker.End], begin);
+                Results.push_back({marker.Name, marker.Depth, to_ms(begin - origin), to_ms(end - begin)});
+            }
+            ResultFrame = frame.Number;
+        }
+
+        static bool Enabled;
+        static bool DebugGroupsEnabled;
+        static bool DrawGroupTiming;
+        /// @brief 当前帧是否计时/输出调试组（BeginFrame时确定，保证Push/Pop成对）
+        static bool FrameActive;
+        static bool FrameDebugGroups;
+        static std::array<FrameQueries, FrameCount> Frames;
+        static std::uint32_t Current;
+        static std::uint64_t FrameNumber;
+        /// @brief 未闭合区间在Markers中的下标
+        static std::vector<std::uint32_t> Stack;
+        static std::vector<GPUTiming> Results;
+        static std::uint64_t ResultFrame;
+        static std::uint64_t DroppedFrames;
+    };
+
+    /**
+     * @brief GPU计时区间
+     * @remark 构造时GPUProfiler::Push，析构时GPUProfiler::Pop
+     */
+    export class GPUProfileScope {
+    public:
+        explicit GPUProfileScope(const std::string_view name) {
+            GPUProfiler::Push(name);
+        }
+
+        ~GPUProfileScope() {
+            GPUProfiler::Pop();
+        }
+
+        GPUProfileScope(const GPUProfileScope &) = delete;
+        GPUProfileScope &operator=(const GPUProfileScope &) = delete;
+    };
+
+    const char *GPUProfiler::TAG = "GPUProfiler";
+    bool GPUProfiler::Enabled = true;
+    bool GPUProfiler::DebugGroupsEnabled = false;
+    bool GPUProfiler::DrawGroupTiming = false;
+    bool GPUProfiler::FrameActive = false;
+    bool GPUProfiler::FrameDebugGroups = false;
+    std::array<GPUProfiler::FrameQueries, GPUProfiler::FrameCount> GPUProfiler::Frames;
+    std::uint32_t GPUProfiler::Current = 0;
+    std::uint64_t GPUProfiler::FrameNumber = 0;
+    std::vector<std::uint32_t> GPUProfiler::Stack;
+    std::vector<GPUTiming> GPUProfiler::Results;
+    std::uint64_t GPUProfiler::ResultFrame = 0;
+    std::uint64_t GPUProfiler::DroppedFrames = 0;
+}
@@ -13,47 +13,121 @@ module;
 export module CEngine.Render:Material;
 import :Texture;
 import :ShaderProgram;
+import :MaterialPool;
+import :TextureAtlas;
+import :GLState;
+import CEngine.Image;
 
 namespace CEngine {
     export class Material {
     public:
+        /// 无效的参数池索引
+        static constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+        struct Description;
+
+        Material() : Index(MaterialPool::Allocate(&Parameters)) {
+        }
+
+        Material(const Material &other) : Textures(other.Textures), Parameters(other.Parameters), Index(MaterialPool::Allocate(&Parameters)),
+                                          PendingTextures(other.PendingTextures) {
+        }
+
+        Material(Material &&other) noexcept : Textures(std::move(other.Textures)), Parameters(other.Parameters), Index(other.Index), ID(other.ID),
+                                              PendingTextures(other.PendingTextures) {
+            other.Index = InvalidIndex;
+        }
+
+        Material &operator=(const Material &other) {
+            if (this == &other) return *this;
+            Textures = other.Textures;
+            Parameters = other.Parameters;
+            PendingTextures = other.PendingTextures;
+            UpdateParameters();
+            return *this;
+        }
+
+        Material &operator=(Material &&other) noexcept {
+            if (this == &other) return *this;
+            if (Index != InvalidIndex) MaterialPool::Free(Index);
+            Textures = std::move(other.Textures);
+            Parameters = other.Parameters;
+            Index = other.Index;
+            ID = other.ID;
+            PendingTextures = other.PendingTextures;
+            other.Index = InvalidIndex;
+            return *this;
+        }
+
+        ~Material() {
+            if (Index != InvalidIndex) MaterialPool::Free(Index);
+        }
+
+        /**
+         * 由Assimp材质创建
+         * @param material Assimp材质
+         * @param model_file_path 模型文件路径（纹理路径相对其所在目录）
+         */
         static Material ProcessAssimpMaterial(const aiMaterial *material, const char *model_file_path) {
+            return FromDescription(DescribeAssimpMaterial(material), model_file_path);
+        }
+
+        /**
+         * 读取Assimp材质的纹理路径与参数
+         * @remark 不加载纹理，结果可写入模型缓存
+         */
+        static Description DescribeAssimpMaterial(const aiMaterial *material) {
+            Description desc;
+            for (const auto type: TextureUniformTypes) {
+                if (material->GetTextureCount(type) == 0) continue;
+                aiString tex_path;
+                material->GetTexture(type, 0, &tex_path);
+                if (tex_path.length > 0) desc.Textures.emplace_back(type, tex_path.data);
+            }
+            const auto has_texture = [&](const aiTextureType type) {
+                return std::ranges::any_of(desc.Textures, [type](const auto &texture) { return texture.first == type; });
+            };
+            // 读取参数
+            auto &params = desc.Parameters;
+            material->Get(AI_MATKEY_EMISSIVE_INTENSITY, params.EMISSIVE_INTENSITY);
+            if (!has_texture(aiTextureType_METALNESS))
+                material->Get(AI_MATKEY_METALLIC_FACTOR, params.METALLIC);
+            if (!has_texture(aiTextureType_DIFFUSE_ROUGHNESS))
+                material->Get(AI_MATKEY_ROUGHNESS_FACTOR, params.ROUGHNESS);
+            material->Get(AI_MATKEY_OPACITY, params.OPACITY);
+            if (!has_texture(aiTextureType_DIFFUSE))
+                material->Get(AI_MATKEY_COLOR_DIFFUSE, params.DIFFUSE_COLOR);
+            if (!has_texture(aiTextureType_SPECULAR))
+                material->Get(AI_MATKEY_COLOR_SPECULAR, params.SPECULAR_COLOR);
+            if (!has_texture(aiTextureType_EMISSION_COLOR))
+                material->Get(AI_MATKEY_COLOR_EMISSIVE, params.EMISSION_COLOR);
+            if (!has_texture(aiTextureType_REFLECTION))
+                material->Get(AI_MATKEY_COLOR_REFLECTIVE, params.REFLECTIVE_COLOR);
+            material->Get(AI_MATKEY_COLOR_TRANSPARENT, params.TRANSPARENT_COLOR);
+            return desc;
+        }
+
+        /**
+         * 由材质描述创建
+         * @param desc 材质描述
+         * @param model_file_path 模型文件路径（纹理路径相对其所在目录）
+         */
+        static Material FromDescription(const Description &desc, const char *model_file_path) {
             // 切割文本获取目录
             auto file_dir = std::string(model_file_path);
             if (const size_t pos = file_dir.find_last_of("/\\"); pos != std::string::npos)
                 file_dir = file_dir.substr(0, pos + 1);
             Material mat;
+            mat.Parameters = desc.Parameters;
             // 读取、上传贴图
-            for (auto &[key, value]: mat.Textures) {
-                if (!value.second) continue;
-                if (material->GetTextureCount(key) > 0) {
-                    aiString tex_path;
-                    material->GetTexture(key, 0, &tex_path);
-                    if (tex_path.length > 0)
-                        value.first = Texture::FromFile(std::format("{}{}", file_dir, tex_path.data).c_str());
-                }
+            for (const auto &[type, path]: desc.Textures) {
+                const auto it = mat.Textures.find(type);
+                if (it == mat.Textures.end() || !it->second.second) continue;
+                auto &texture = it->second.first;
+                texture = Texture::FromFileAsync(std::format("{}{}", file_dir, path).c_str(), IsAtlasTextureType(type), GetTextureUsage(type));
+                if (texture != nullptr && !texture->IsReady()) mat.PendingTextures = true;
             }
-            // 读取参数
-            material->Get(AI_MATKEY_EMISSIVE_INTENSITY, mat.Parameters.EMISSIVE_INTENSITY);
-            if (mat.Textures[aiTextureType_METALNESS].first == nullptr)
-                material->Get(AI_MATKEY_METALLIC_FACTOR, mat.Parameters.METALLIC);
-            if (mat.Textures[aiTextureType_DIFFUSE_ROUGHNESS].first == nullptr)
-                material->Get(AI_MATKEY_ROUGHNESS_FACTOR, mat.Parameters.ROUGHNESS);
-            material->Get(AI_MATKEY_OPACITY, mat.Parameters.OPACITY);
-            if (mat.Textures[aiTextureType_DIFFUSE].first == nullptr)
-                material->Get(AI_MATKEY_COLOR_DIFFUSE, mat.Parameters.DIFFUSE_COLOR);
-            if (mat.Textures[aiTextureType_SPECULAR].first == nullptr)
-                material->Get(AI_MATKEY_COLOR_SPECULAR, mat.Parameters.SPECULAR_COLOR);
-            if (mat.Textures[aiTextureType_EMISSION_COLOR].first == nullptr)
-                material->Get(AI_MATKEY_COLOR_EMISSIVE, mat.Parameters.EMISSION_COLOR);
-            if (mat.Textures[aiTextureType_REFLECTION].first == nullptr)
-                material->Get(AI_MATKEY_COLOR_REFLECTIVE, mat.Parameters.REFLECTIVE_COLOR);
-            material->Get(AI_MATKEY_COLOR_TRANSPARENT, mat.Parameters.TRANSPARENT_COLOR);
-            // 上传参数
-            glGenBuffers(1, &mat.UBO_Parameters);
-            glBindBuffer(GL_UNIFORM_BUFFER, mat.UBO_Parameters);
-            glBufferData(GL_UNIFORM_BUFFER, sizeof(MParameters), &mat.Parameters, GL_STATIC_DRAW);
-            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            mat.UpdateParameters();
             return std::move(mat);
         }
 
@@ -84,6 +158,13 @@ namespace CEngine {
             {aiTextureType_TRANSMISSION,        {nullptr, false}}   // 透射纹理
         };
 
+        /// 图集纹理引用（与GLSL中Atlas_Ref对应）
+        struct MAtlasRef {
+            float RECT[4] = {1.0f, 1.0f, 0.0f, 0.0f}; // UV缩放与偏移
+            std::int32_t LAYER = -1;                  // 图集层号，-1表示不在图集中
+            std::int32_t PADDING[3] = {};
+        };
+
         /// @remark 请据此顺序在GLSL中构建结构体
         struct MParameters {
             float EMISSIVE_INTENSITY    = 1.0f; // 发射强度
@@ -95,81 +176,149 @@ namespace CEngine {
             aiColor4D EMISSION_COLOR    = {1.0f, 1.0f, 1.0f, 1.0f}; // 发射颜色
             aiColor4D REFLECTIVE_COLOR  = {1.0f, 1.0f, 1.0f, 1.0f}; // 反射颜色
             aiColor4D TRANSPARENT_COLOR = {1.0f, 1.0f, 1.0f, 1.0f}; // 透明度（无对应纹理）（不知道是啥）
+            MAtlasRef ATLAS[4];                                     // 图集中的纹理（顺序同AtlasTextureTypes）
         };
         // @formatter:on
+        static_assert(sizeof(MParameters) == MaterialPool::RecordSize, "MParameters与MaterialPool记录大小不一致");
+
+        /// 材质描述（纹理路径与参数，可写入模型缓存）
+        struct Description {
+            /// @brief { 纹理类型, 相对模型文件所在目录的路径 }
+            std::vector<std::pair<aiTextureType, std::string> > Textures;
+            MParameters Parameters;
+        };
 
         MParameters Parameters;
 
+        /// 纹理类型与GLSL中Uniform名称的对应（两表顺序一致）
+        // @formatter:off
+        static constexpr std::array<aiTextureType, 20> TextureUniformTypes = {
+            aiTextureType_DIFFUSE,          aiTextureType_SPECULAR,         aiTextureType_AMBIENT,          aiTextureType_EMISSIVE,
+            aiTextureType_HEIGHT,           aiTextureType_NORMALS,          aiTextureType_SHININESS,        aiTextureType_OPACITY,
+            aiTextureType_DISPLACEMENT,     aiTextureType_LIGHTMAP,         aiTextureType_REFLECTION,       aiTextureType_BASE_COLOR,
+            aiTextureType_NORMAL_CAMERA,    aiTextureType_EMISSION_COLOR,   aiTextureType_METALNESS,        aiTextureType_DIFFUSE_ROUGHNESS,
+            aiTextureType_AMBIENT_OCCLUSION,aiTextureType_SHEEN,            aiTextureType_CLEARCOAT,        aiTextureType_TRANSMISSION
+        };
+        static constexpr std::array<const char *, 20> TextureUniformNames = {
+            "Tex_Diffuse",                  "Tex_Specular",                 "Tex_Ambient",                  "Tex_Emissive",
+            "Tex_Height",                   "Tex_Normals",                  "Tex_Shininess",                "Tex_Opacity",
+            "Tex_Displacement",             "Tex_Lightmap",                 "Tex_Reflection",               "Tex_BaseColor",
+            "Tex_NormalCamera",             "Tex_EmissionColor",            "Tex_Metalness",                "Tex_DiffuseRoughness",
+            "Tex_AmbientOcclusion",         "Tex_Sheen",                    "Tex_Clearcoat",                "Tex_Transmission"
+        };
+        // @formatter:on
+        /// 材质参数索引Uniform名称
+        static constexpr std::array<const char *, 2> MaterialUniformNames = {"Material_Index", "Tex_Atlas"};
+        /// 可放入纹理图集的纹理类型（着色器按Materials[i].Atlas[n]读取）
+        static constexpr std::array<aiTextureType, 4> AtlasTextureTypes = {
+            aiTextureType_DIFFUSE, aiTextureType_NORMALS, aiTextureType_METALNESS, aiTextureType_DIFFUSE_ROUGHNESS
+        };
+
+        static bool IsAtlasTextureType(const aiTextureType type) {
+            return std::ranges::find(AtlasTextureTypes, type) != AtlasTextureTypes.end();
+        }
+
+        /// 纹理类型对应的用途（决定块压缩格式）
+        static TextureUsage GetTextureUsage(const aiTextureType type) {
+            switch (type) {
+                case aiTextureType_NORMALS:
+                case aiTextureType_NORMAL_CAMERA: return TextureUsage::Normal;
+                case aiTextureType_DIFFUSE_ROUGHNESS: return TextureUsage::Roughness;
+                case aiTextureType_METALNESS: return TextureUsage::Metalness;
+                case aiTextureType_AMBIENT_OCCLUSION:
+                case aiTextureType_OPACITY:
+                case aiTextureType_SHININESS:
+                case aiTextureType_DISPLACEMENT: return TextureUsage::Mask;
+                default: return TextureUsage::Color;
+            }
+        }
+
+        /**
+         * 批次ID（用于渲染队列排序与合并）
+         * @remark 所有启用的纹理都在图集中（或没有纹理）的材质无需单独绑定，返回0，可与其它这样的材质合并绘制
+         */
+        std::uint32_t GetBatchID() const {
+            for (const auto &[texture, enabled]: Textures | std::views::values)
+                if (texture != nullptr && enabled && !texture->IsInAtlas()) return ID;
+            return 0;
+        }
+
+        /// @property ID
+        std::uint32_t getID() const { return ID; }
+
+        /// @property Index
+        std::uint32_t getIndex() const { return Index; }
+
+        /**
+         * 提交参数修改
+         * @remark 修改Parameters后调用，仅该材质的记录会在下一帧上传
+         */
+        void UpdateParameters() {
+            for (std::size_t i = 0; i < AtlasTextureTypes.size(); ++i) {
+                auto &ref = Parameters.ATLAS[i];
+                ref = {};
+                const auto it = Textures.find(AtlasTextureTypes[i]);
+                if (it == Textures.end() || it->second.first == nullptr || !it->second.second) continue;
+                if (const auto &region = it->second.first->getAtlasRegion()) {
+                    std::ranges::copy(TextureAtlas::GetRect(*region), ref.RECT);
+                    ref.LAYER = static_cast<std::int32_t>(region->Layer);
+                }
+            }
+            if (Index != InvalidIndex) MaterialPool::Update(Index, &Parameters);
+        }
+
+        /**
+         * 检查异步加载中的纹理
+         * @remark 每帧提交前调用：有纹理仍在加载时重新填写图集引用（纹理可能刚放入图集），全部完成后不再检查
+         */
+        void RefreshPendingTextures() {
+            if (!PendingTextures) return;
+            PendingTextures = std::ranges::any_of(Textures | std::views::values, [](const auto &texture) {
+                return texture.first != nullptr && !texture.first->IsReady();
+            });
+            UpdateParameters();
+        }
+
+        /// 是否需要透明混合
+        bool IsTransparent() const {
+            return Parameters.OPACITY < 1.0f;
+        }
+
 
         /**
          * 使用材质
          * @remark 请先<code>Use</code>ShaderProgram
-         * @remark 请保证GLSL中材质参数结构体与MParameters结构相同
-         * @remark 请保证在第一个材质贴图
+         * @remark 请保证GLSL中材质参数结构体与MParameters结构相同，参数从MaterialPool的SSBO中按<code>Material_Index</code>读取
+         * @remark Uniform地址在每个程序首次使用时解析并缓存于程序内
          * @param shader \n
          * ShaderProgram指针
-         * @param material_parameters_uniform_block_index \n
-         * 材质参数Uniform结构索引 (使用函数<code>glGetUniformBlockIndex()</code>) \n
-         * 若不传参，则自动搜索结构<code>Material_Parameters</code>
-         * @param uniform_tex_start_location \n
-         * 材质贴图的<b>第一个</b>Uniform变量的地址 (使用函数<code>glGetUniformLocation()</code>) \n
-         * 若不传参，则自动搜索<code>Tex_Diffuse</code>
          */
-        void Use(const ShaderProgram *shader, const int material_parameters_uniform_block_index = -1, const int uniform_tex_start_location = -1) const {
-            const auto shader_id = shader->getShaderProgramID();
-            const unsigned int i = material_parameters_uniform_block_index < 0
-                                       ? glGetUniformBlockIndex(shader_id, "Material_Parameters")
-                                       : material_parameters_uniform_block_index;
-            glUniformBlockBinding(shader_id, i, UBO_Parameters);
-
-            /* 顺序法（需保证GLSL中uniform顺序与Textures顺序相同，且保证所有变量被使用已避免被编译器优化） */
-            // int uniform_location = uniform_tex_start_location < 0
-            //                            ? glGetUniformLocation(shader_id, "Tex_Diffuse")
-            //                            : uniform_tex_start_location;
-            // uniform_location--;
-            // for (const auto &[fst, snd]: Textures | std::views::values) {
-            //     uniform_location++; // 不管有没有纹理 地址都会往下走
-            //     if (fst == nullptr || !snd) continue;
-            //     glUniform1i(uniform_location, fst->Use());
-            // }
-
-            /* 寻址法 */
-            for (auto &[type, value]: Textures) {
-                if (value.first == nullptr || !value.second) return;
-                const char *name = nullptr;
-                // @formatter:off
-                switch (type) {
-                    case aiTextureType_DIFFUSE:             name = "Tex_Diffuse";           break;
-                    case aiTextureType_SPECULAR:            name = "Tex_Specular";          break;
-                    case aiTextureType_AMBIENT:             name = "Tex_Ambient";           break;
-                    case aiTextureType_EMISSIVE:            name = "Tex_Emissive";          break;
-                    case aiTextureType_HEIGHT:              name = "Tex_Height";            break;
-                    case aiTextureType_NORMALS:             name = "Tex_Normals";           break;
-                    case aiTextureType_SHININESS:           name = "Tex_Shininess";         break;
-                    case aiTextureType_OPACITY:             name = "Tex_Opacity";           break;
-                    case aiTextureType_DISPLACEMENT:        name = "Tex_Displacement";      break;
-                    case aiTextureType_LIGHTMAP:            name = "Tex_Lightmap";          break;
-                    case aiTextureType_REFLECTION:          name = "Tex_Reflection";        break;
-                    case aiTextureType_BASE_COLOR:          name = "Tex_BaseColor";         break;
-                    case aiTextureType_NORMAL_CAMERA:       name = "Tex_NormalCamera";      break;
-                    case aiTextureType_EMISSION_COLOR:      name = "Tex_EmissionColor";     break;
-                    case aiTextureType_METALNESS:           name = "Tex_Metalness";         break;
-                    case aiTextureType_DIFFUSE_ROUGHNESS:   name = "Tex_DiffuseRoughness";  break;
-                    case aiTextureType_AMBIENT_OCCLUSION:   name = "Tex_AmbientOcclusion";  break;
-                    case aiTextureType_SHEEN:               name = "Tex_Sheen";             break;
-                    case aiTextureType_CLEARCOAT:           name = "Tex_Clearcoat";         break;
-                    case aiTextureType_TRANSMISSION:        name = "Tex_Transmission";      break;
-                    default:                                name = "Unknown_Texture";       break;
-                }
-                if(const auto location = glGetUniformLocation(shader_id, name); location >= 0) {
-                    glUniform1i(location, value.first->Use());
-                }
-                // @formatter:on
+        void Use(const ShaderProgram *shader) const {
+            const auto &material_locations = shader->ResolveLocations(MaterialUniformNames);
+            if (material_locations[0] >= 0)
+                glUniform1ui(material_locations[0], Index);
+            if (material_locations[1] >= 0 && TextureAtlas::GetArray() != 0)
+                glUniform1i(material_locations[1], TextureAtlas::Bind());
+
+            const auto &locations = shader->ResolveLocations(TextureUniformNames);
+            for (std::size_t i = 0; i < TextureUniformTypes.size(); ++i) {
+                if (locations[i] < 0) continue;
+                const auto it = Textures.find(TextureUniformTypes[i]);
+                if (it == Textures.end() || it->second.first == nullptr || !it->second.second || it->second.first->IsInAtlas()) continue;
+                glUniform1i(locations[i], it->second.first->Use());
             }
         }
 
     private
     :
-        unsigned int UBO_Parameters = 0;
+        /// @brief 参数在MaterialPool中的索引
+        std::uint32_t Index = InvalidIndex;
+        /// @brief 材质ID（用于渲染队列排序）
+        std::uint32_t ID = ++IDCounter;
+        /// @brief 是否有异步加载中的纹理
+        bool PendingTextures = false;
+        static std::uint32_t IDCounter;
     };
+
+    std::uint32_t Material::IDCounter = 0;
 }
@@ -0,0 +1,155 @@
+/**
+ * @file MaterialPool.ixx
+ * @brief 材质参数池
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+export module CEngine.Render:MaterialPool;
+import :GLState;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /**
+     * @brief 材质参数池
+     * @remark 所有材质的参数保存在同一个SSBO数组中，每个材质持有固定的索引，着色器按Material_Index读取；\n
+     * CPU端保存一份副本，修改只记录脏区间，每帧Bind时以一次glBufferSubData上传；\n
+     * 容量不足时按两倍扩容并重新上传全部记录
+     */
+    export class MaterialPool {
+    public:
+        const static char *TAG;
+
+        MaterialPool() = delete;
+
+        /// 每条记录的大小（字节，std430下须为16的倍数）
+        static constexpr std::uint32_t RecordSize = 224;
+        /// 初始容量（记录数）
+        static constexpr std::uint32_t InitialCapacity = 256;
+
+        /**
+         * 分配记录
+         * @param data 初始参数（RecordSize字节）
+         * @return 记录索引
+         */
+        static std::uint32_t Allocate(const void *data) {
+            std::lock_guard lock(Mutex);
+            std::uint32_t index;
+            if (!FreeIndices.empty()) {
+                index = FreeIndices.back();
+                FreeIndices.pop_back();
+            } else {
+                index = Count++;
+                Records.resize(static_cast<std::size_t>(Count) * RecordSize);
+            }
+            Write(index, data);
+            return index;
+        }
+
+        /// 释放记录
+        static void Free(const std::uint32_t index) {
+            std::lock_guard lock(Mutex);
+            if (index >= Count) return;
+            FreeIndices.push_back(index);
+        }
+
+        /**
+         * 更新记录
+         * @remark 只标记脏区间，Bind时上传
+         * @param index 记录索引
+         * @param data 参数（RecordSize字节）
+         */
+        static void Update(const std::uint32_t index, const void *data) {
+            std::lock_guard lock(Mutex);
+            if (index >= Count) return;
+            Write(index, data);
+        }
+
+        /**
+         * 上传脏区间并绑定到SSBO绑定点
+         * @remark 每帧绘制前调用一次
+         * @param binding SSBO绑定点
+         */
+        static void Bind(const unsigned int binding) {
+            std::lock_guard lock(Mutex);
+            if (Count > Capacity) Grow();
+            if (DirtyBegin < DirtyEnd) {
+                GLState::BindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+                glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(DirtyBegin) * RecordSize,
+                                static_cast<GLsizeiptr>(DirtyEnd - DirtyBegin) * RecordSize, Records.data() + static_cast<std::size_t>(DirtyBegin) * RecordSize);
+                UploadedRecords += DirtyEnd - DirtyBegin;
+                DirtyBegin = std::numeric_limits<std::uint32_t>::max();
+                DirtyEnd = 0;
+            }
+            if (Buffer != 0) GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, Buffer);
+        }
+
+        /// 已分配的记录数（含空闲）
+        static std::uint32_t GetCount() { return Count; }
+
+        /// @property Capacity
+        static std::uint32_t GetCapacity() { return Capacity; }
+
+        /// 累计上传的记录数
+        static std::uint64_t GetUploadedRecords() { return UploadedRecords; }
+
+        /**
+         * 释放GPU资源
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        static void Release() {
+            std::lock_guard lock(Mutex);
+            if (Buffer != 0) GLState::DeleteBuffer(Buffer);
+            Buffer = 0;
+            Capacity = 0;
+            MarkDirty(0, Count);
+        }
+
+    private:
+        static void Write(const std::uint32_t index, const void *data) {
+            std::memcpy(Records.data() + static_cast<std::size_t>(index) * RecordSize, data, RecordSize);
+            MarkDirty(index, index + 1);
+        }
+
+        static void MarkDirty(const std::uint32_t begin, const std::uint32_t end) {
+            DirtyBegin = std::min(DirtyBegin, begin);
+            DirtyEnd = std::max(DirtyEnd, end);
+        }
+
+        static void Grow() {
+            auto capacity = std::max(Capacity, InitialCapacity);
+            while (capacity < Count) capacity *= 2;
+            if (Buffer != 0) GLState::DeleteBuffer(Buffer);
+            glGenBuffers(1, &Buffer);
+            GLState::BindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+            glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity) * RecordSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+            Capacity = capacity;
+            MarkDirty(0, Count);
+            LogD(TAG) << "材质参数池扩容: " << capacity;
+        }
+
+        static std::mutex Mutex;
+        static std::vector<std::byte> Records;
+        static std::vector<std::uint32_t> FreeIndices;
+        static std::uint32_t Count;
+        static std::uint32_t Capacity;
+        static std::uint32_t DirtyBegin, DirtyEnd;
+        static std::uint64_t UploadedRecords;
+        static unsigned int Buffer;
+    };
+
+    const char *MaterialPool::TAG = "MaterialPool";
+    std::mutex MaterialPool::Mutex;
+    std::vector<std::byte> MaterialPool::Records;
+    std::vector<std::uint32_t> MaterialPool::FreeIndices;
+    std::uint32_t MaterialPool::Count = 0;
+    std::uint32_t MaterialPool::Capacity = 0;
+    std::uint32_t MaterialPool::DirtyBegin = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t MaterialPool::DirtyEnd = 0;
+    std::uint64_t MaterialPool::UploadedRecords = 0;
+    unsigned int MaterialPool::Buffer = 0;
+}
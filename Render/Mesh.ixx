@@ -11,34 +11,48 @@ module;
 #include <glm/glm.hpp>
 export module CEngine.Render:Mesh;
 import :Texture;
+import :GLState;
+import :MeshArena;
+import :VertexLayout;
 import std;
 import CEngine.Base;
 import CEngine.Logger;
 
 namespace CEngine {
     /**
-     * @brief 顶点信息
+     * @brief 网格数据（已编码，不持有内存）
      */
-    export struct VertexInfo {
-        /// @brief 顶点位置
-        glm::vec3 Position;
-        /// @brief 法线
-        glm::vec3 Normal;
-        /// @brief 纹理坐标
-        glm::vec2 TexCoord;
-        /**
-        * 比较运算符
-        */
-        bool operator==(const VertexInfo &other) const {
-            return Position == other.Position && Normal == other.Normal && TexCoord == other.TexCoord;
-        }
+    export struct MeshData {
+        VertexLayout Layout;
+        std::uint32_t VertexCount = 0;
+        /// @brief 交错顶点数据（VertexCount x Layout.GetStride()）
+        std::span<const std::byte> Vertices;
+        /// @brief 位置流（可为空）
+        std::span<const std::byte> Positions;
+        /// @brief 索引数据（IndexCount x IndexSize）
+        std::span<const std::byte> Indices;
+        std::uint32_t IndexCount = 0;
+        /// @brief 索引大小（2或4字节）
+        std::uint32_t IndexSize = sizeof(unsigned int);
+        glm::mat4 Dequantize{1.0f};
+    };
+
+    /**
+     * @brief 编码后的网格（持有内存）
+     */
+    export struct EncodedMesh {
+        VertexLayout Layout;
+        std::uint32_t VertexCount = 0;
+        EncodedVertices Vertices;
+        std::vector<std::byte> Indices;
+        std::uint32_t IndexCount = 0;
+        std::uint32_t IndexSize = sizeof(unsigned int);
 
-        void Print(Logger &logger) const {
-            logger << "{" << Position << "," << Normal << "," << TexCoord << "}";
+        MeshData View() const {
+            return {Layout, VertexCount, Vertices.Data, Vertices.Positions, Indices, IndexCount, IndexSize, Vertices.Dequantize};
         }
     };
 
-
     /**
     * @class Mesh
     * @brief 网格基类
@@ -47,7 +61,7 @@ namespace CEngine {
     export class Mesh final : public Object {
     public:
         const static char *TAG;
-        static std::vector<Mesh *> All_Instances;
+        static std::vector<Handle<Mesh> > All_Instances;
 
         Mesh(const Mesh &other) = delete;
         Mesh(Mesh &&other) = delete;
@@ -55,17 +69,62 @@ namespace CEngine {
         Mesh &operator=(Mesh &&other) = delete;
 
         ~Mesh() override {
-            glDeleteVertexArrays(1, &VAO);
-            glDeleteBuffers(1, &VBO);
-            glDeleteBuffers(1, &EBO);
+            std::erase(All_Instances, Handle(this));
+            if (Arena) {
+                MeshArena::Free(*Arena);
+                return;
+            }
+            GLState::DeleteVertexArray(VAO);
+            GLState::DeleteVertexArray(DepthVAO);
+            GLState::DeleteBuffer(VBO);
+            GLState::DeleteBuffer(PositionVBO);
+            GLState::DeleteBuffer(EBO);
         };
 
         /**
          * @param vbi 顶点信息数据
          * @param ebi 索引数据
+         * @param layout 顶点布局（默认与VertexInfo相同，见VertexEncoder::ChooseLayout）
+         */
+        static Mesh *Create(const std::vector<VertexInfo> &vbi, const std::vector<unsigned int> &ebi, const VertexLayout &layout = {}) {
+            return new Mesh(Encode(vbi, ebi, layout).View());
+        }
+
+        /**
+         * 由已编码的数据创建
+         * @remark 数据可直接来自映射的文件（见CookedModel），上传后不再引用
+         * @param data 网格数据
+         */
+        static Mesh *Create(const MeshData &data) {
+            return new Mesh(data);
+        }
+
+        /**
+         * 编码网格数据
+         * @remark 按布局编码顶点；顶点数不超过ShortIndexLimit时使用16位索引
+         * @param vbi 顶点信息数据
+         * @param ebi 索引数据
+         * @param layout 顶点布局
          */
-        static Mesh *Create(const std::vector<VertexInfo> &vbi, const std::vector<unsigned int> &ebi) {
-            return new Mesh(vbi, ebi);
+        static EncodedMesh Encode(const std::vector<VertexInfo> &vbi, const std::vector<unsigned int> &ebi, const VertexLayout &layout = {}) {
+            EncodedMesh mesh;
+            mesh.Layout = layout;
+            mesh.VertexCount = static_cast<std::uint32_t>(vbi.size());
+            mesh.Vertices = VertexEncoder::Encode(vbi, layout);
+            mesh.IndexCount = static_cast<std::uint32_t>(ebi.size());
+            if (vbi.size() <= ShortIndexLimit) {
+                mesh.IndexSize = sizeof(std::uint16_t);
+                mesh.Indices.resize(ebi.size() * sizeof(std::uint16_t));
+                for (std::size_t i = 0; i < ebi.size(); ++i) {
+                    const auto index = static_cast<std::uint16_t>(ebi[i]);
+                    std::memcpy(mesh.Indices.data() + i * sizeof(std::uint16_t), &index, sizeof(std::uint16_t));
+                }
+            } else {
+                mesh.IndexSize = sizeof(unsigned int);
+                mesh.Indices.resize(ebi.size() * sizeof(unsigned int));
+                std::memcpy(mesh.Indices.data(), ebi.data(), mesh.Indices.size());
+            }
+            return mesh;
         }
 
         /**
@@ -73,58 +132,176 @@ namespace CEngine {
         * @remark 请先设置Shader
         */
         void Render() const {
-            glBindVertexArray(VAO);
-            glDrawElements(GL_TRIANGLES, static_cast<int>(indices_size), GL_UNSIGNED_INT, nullptr);
+            Bind();
+            Draw();
+        }
+
+        /// 绑定VAO
+        void Bind() const {
+            GLState::BindVertexArray(VAO);
         }
 
+        /**
+         * 绑定仅含位置的VAO
+         * @remark 用于仅深度的通道，之后同样使用Draw绘制；无位置流时绑定完整的VAO
+         */
+        void BindDepth() const {
+            GLState::BindVertexArray(getDepthVAO());
+        }
+
+        /**
+         * 绘制
+         * @remark 请先绑定VAO
+         */
+        void Draw() const {
+            if (Arena)
+                glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<int>(indices_size), IndexType, GetIndexOffset(),
+                                         static_cast<GLint>(Arena->BaseVertex));
+            else
+                glDrawElements(GL_TRIANGLES, static_cast<int>(indices_size), IndexType, nullptr);
+        }
+
+        /**
+         * 实例化绘制
+         * @remark 请先绑定VAO
+         * @param instances 实例数量
+         * @param base_instance 第一个实例的gl_BaseInstance
+         */
+        void DrawInstanced(const std::uint32_t instances, const std::uint32_t base_instance) const {
+            if (Arena)
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<int>(indices_size), IndexType, GetIndexOffset(),
+                                                              static_cast<GLsizei>(instances), static_cast<GLint>(Arena->BaseVertex), base_instance);
+            else
+                glDrawElementsInstancedBaseInstance(GL_TRIANGLES, static_cast<int>(indices_size), IndexType, nullptr,
+                                                    static_cast<GLsizei>(instances), base_instance);
+        }
+
+        /// @property VAO
+        unsigned int getVAO() const { return VAO; }
+
+        /// 排序用的网格标识（按创建顺序分配；共享缓冲中同一页的网格共用VAO，不能以VAO区分）
+        std::uint32_t getSortID() const { return SortID; }
+
+        /// 仅含位置的VAO（无位置流时为完整的VAO）
+        unsigned int getDepthVAO() const { return DepthVAO != 0 ? DepthVAO : VAO; }
+
+        /// @property Layout
+        const VertexLayout &getLayout() const { return Layout; }
+
+        /// 位置是否量化（绘制时需将getDequantizeMatrix并入变换）
+        bool IsPositionQuantized() const { return Layout.Position != PositionFormat::Float3; }
+
+        /// @property Dequantize
+        const glm::mat4 &getDequantizeMatrix() const { return Dequantize; }
+
+        /// 是否分配自网格共享缓冲
+        bool IsInArena() const { return Arena.has_value(); }
+
+        /// 在网格共享缓冲中的分配（IsInArena为<code>true</code>时有效）
+        const MeshArena::Allocation &getArenaAllocation() const { return *Arena; }
+
+        /// @property indices_size
+        std::uint32_t getIndexCount() const { return static_cast<std::uint32_t>(indices_size); }
+
+        /// @property IndexType
+        GLenum getIndexType() const { return IndexType; }
+
+        /// 顶点数不超过此值时使用16位索引
+        static constexpr std::size_t ShortIndexLimit = 0x10000;
+
         /// 不重要
         std::string Name;
 
     protected:
         /**
-         * @param vbi 顶点信息数据
-         * @param ebi 索引数据
+         * @param data 已编码的网格数据
          */
-        Mesh(const std::vector<VertexInfo> &vbi, const std::vector<unsigned int> &ebi) {
-            indices_size = ebi.size();
-            const auto vbi_size = vbi.size() * sizeof(VertexInfo);
-            LogD(TAG) << "向GPU传输数据(顶点信息: " << vbi_size << "字节, 索引: " << indices_size << "组)";
+        explicit Mesh(const MeshData &data) : Layout(data.Layout), Dequantize(data.Dequantize) {
+            indices_size = data.IndexCount;
+            IndexType = data.IndexSize == sizeof(std::uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            const auto &layout = data.Layout;
+            const auto stride = layout.GetStride();
+            const auto has_positions = layout.PositionStream && !data.Positions.empty();
+            const auto position_setup = has_positions ? layout.GetPositionSetup() : nullptr;
+            LogD(TAG) << "向GPU传输数据(顶点信息: " << data.Vertices.size() << "字节, " << stride << "字节/顶点, 索引: " << indices_size << "组 x "
+                      << data.IndexSize << "字节)";
+            All_Instances.push_back(this);
+            SortID = NextSortID++;
+            // 从网格共享缓冲中分配
+            if (MeshArena::IsEnabled()) {
+                Arena = MeshArena::Allocate(data.Vertices.data(), data.VertexCount, stride, data.Indices.data(), data.IndexCount, data.IndexSize,
+                                            layout.GetSetup(), has_positions ? data.Positions.data() : nullptr,
+                                            has_positions ? layout.GetPositionSize() : 0, position_setup);
+                if (Arena) {
+                    VAO = MeshArena::GetVAO(Arena->Page);
+                    DepthVAO = MeshArena::GetDepthVAO(Arena->Page);
+                    return;
+                }
+                LogW(TAG) << "网格共享缓冲分配失败，使用独立缓冲";
+            }
             /// 生成VAO
             glGenVertexArrays(1, &VAO);
-            glBindVertexArray(VAO);
+            GLState::BindVertexArray(VAO);
             // 处理顶点信息数据
             /// 生成VBO
             glGenBuffers(1, &VBO);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
             /// 传入VBO数据
-            glBufferData(GL_ARRAY_BUFFER, vbi_size, vbi.data(), GL_STATIC_DRAW);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.Vertices.size()), data.Vertices.data(), GL_STATIC_DRAW);
             /// 设置锚定点
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexInfo), reinterpret_cast<void *>(offsetof(VertexInfo, Position)));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexInfo), reinterpret_cast<void *>(offsetof(VertexInfo, Normal)));
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexInfo), reinterpret_cast<void *>(offsetof(VertexInfo, TexCoord)));
-            glEnableVertexAttribArray(2);
+            layout.GetSetup()();
             // 处理索引数据
             /// 生成EBO
             glGenBuffers(1, &EBO);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
             /// 传入EBO数据
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_size * sizeof(unsigned int), ebi.data(), GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.Indices.size()), data.Indices.data(), GL_STATIC_DRAW);
+            // 位置流：独立的顶点缓冲与VAO，共用EBO
+            if (has_positions) {
+                glGenVertexArrays(1, &DepthVAO);
+                GLState::BindVertexArray(DepthVAO);
+                glGenBuffers(1, &PositionVBO);
+                GLState::BindBuffer(GL_ARRAY_BUFFER, PositionVBO);
+                glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.Positions.size()), data.Positions.data(), GL_STATIC_DRAW);
+                position_setup();
+                GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            }
             // 解绑VAO
-            glBindVertexArray(0);
-            All_Instances.push_back(this);
+            GLState::BindVertexArray(0);
         };
+
+        /// 索引在共享索引缓冲中的字节偏移
+        const void *GetIndexOffset() const {
+            return reinterpret_cast<const void *>(static_cast<std::uintptr_t>(Arena->FirstIndex) * (IndexType == GL_UNSIGNED_SHORT ? 2 : 4));
+        }
+
         /// @brief VAO
         unsigned int VAO = 0;
         /// @brief VBO
         unsigned int VBO = 0;
         /// @brief EBO
         unsigned int EBO = 0;
+        /// @brief 仅含位置的VAO
+        unsigned int DepthVAO = 0;
+        /// @brief 位置流
+        unsigned int PositionVBO = 0;
+        /// @brief 顶点布局
+        VertexLayout Layout;
+        /// @brief 反量化变换
+        glm::mat4 Dequantize{1.0f};
         /// @brief 索引总数
         size_t indices_size = 0;
+        /// @brief 索引类型（GL_UNSIGNED_SHORT或GL_UNSIGNED_INT）
+        GLenum IndexType = GL_UNSIGNED_INT;
+        /// @brief 在网格共享缓冲中的分配（独立缓冲时为空）
+        std::optional<MeshArena::Allocation> Arena;
+        /// @brief 排序用的网格标识
+        std::uint32_t SortID = 0;
+
+        static std::uint32_t NextSortID;
     };
 
     const char *Mesh::TAG = "Mesh";
-    std::vector<Mesh *> Mesh::All_Instances;
+    std::vector<Handle<Mesh> > Mesh::All_Instances;
+    std::uint32_t Mesh::NextSortID = 0;
 }
@@ -0,0 +1,319 @@
+/**
+ * @file MeshArena.ixx
+ * @brief 网格共享缓冲
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+export module CEngine.Render:MeshArena;
+import :GLState;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /**
+     * @brief 偏移分配器
+     * @remark 在[0, Capacity)区间内分配连续区域，最佳适配；释放时与相邻空闲块合并
+     */
+    export class OffsetAllocator {
+    public:
+        explicit OffsetAllocator(const std::uint32_t capacity) : Capacity(capacity) {
+            if (capacity > 0) InsertBlock(0, capacity);
+        }
+
+        /**
+         * 分配
+         * @param size 大小
+         * @return 起始偏移，空间不足返回<code>std::nullopt</code>
+         */
+        std::optional<std::uint32_t> Allocate(std::uint32_t size) {
+            size = std::max(size, 1u);
+            const auto it = BySize.lower_bound(size);
+            if (it == BySize.end()) return std::nullopt;
+            const auto [block_size, offset] = *it;
+            BySize.erase(it);
+            ByOffset.erase(offset);
+            if (block_size > size) InsertBlock(offset + size, block_size - size);
+            Used += size;
+            return offset;
+        }
+
+        /**
+         * 释放
+         * @param offset Allocate返回的偏移
+         * @param size 分配时的大小
+         */
+        void Free(std::uint32_t offset, std::uint32_t size) {
+            size = std::max(size, 1u);
+            Used -= size;
+            // 与后一个空闲块合并
+            if (const auto next = ByOffset.find(offset + size); next != ByOffset.end()) {
+                size += next->second;
+                EraseBlock(next);
+            }
+            // 与前一个空闲块合并
+            if (auto prev = ByOffset.lower_bound(offset); prev != ByOffset.begin()) {
+                --prev;
+                if (prev->first + prev->second == offset) {
+                    offset = prev->first;
+                    size += prev->second;
+                    EraseBlock(prev);
+                }
+            }
+            InsertBlock(offset, size);
+        }
+
+        /// @property Capacity
+        std::uint32_t GetCapacity() const { return Capacity; }
+
+        /// @property Used
+        std::uint32_t GetUsed() const { return Used; }
+
+        /// 空闲块数量（碎片程度）
+        std::size_t GetFreeBlockCount() const { return ByOffset.size(); }
+
+    private:
+        void InsertBlock(const std::uint32_t offset, const std::uint32_t size) {
+            ByOffset.emplace(offset, size);
+            BySize.emplace(size, offset);
+        }
+
+        void EraseBlock(const std::map<std::uint32_t, std::uint32_t>::iterator it) {
+            auto [first, last] = BySize.equal_range(it->second);
+            for (; first != last; ++first)
+                if (first->second == it->first) {
+                    BySize.erase(first);
+                    break;
+                }
+            ByOffset.erase(it);
+        }
+
+        std::uint32_t Capacity;
+        std::uint32_t Used = 0;
+        /// @brief 空闲块：偏移 -> 大小
+        std::map<std::uint32_t, std::uint32_t> ByOffset;
+        /// @brief 空闲块：大小 -> 偏移
+        std::multimap<std::uint32_t, std::uint32_t> BySize;
+    };
+
+    /**
+     * @brief 网格共享缓冲
+     * @remark 启用后新建的Mesh从少数几块不可变（glBufferStorage）的大顶点/索引缓冲中分配，\n
+     * 同一页内的网格共享一个VAO，可使用glMultiDrawElementsIndirect一次提交；\n
+     * 页满时新建一页，不同顶点布局与索引类型使用不同的页；带位置流的页另有一个仅含位置的顶点缓冲与VAO（与主缓冲共用偏移和索引）
+     */
+    export class MeshArena {
+    public:
+        const static char *TAG;
+
+        MeshArena() = delete;
+
+        /// 顶点布局设置函数（在VAO与顶点缓冲绑定时调用，设置glVertexAttribPointer）
+        using LayoutSetup = void (*)();
+
+        static constexpr std::uint32_t DefaultVertexCapacity = 1u << 20;
+        static constexpr std::uint32_t DefaultIndexCapacity = 3u << 20;
+
+        /// 分配结果
+        struct Allocation {
+            std::uint32_t Page = 0;
+            /// @brief 顶点偏移（glDraw*BaseVertex的basevertex）
+            std::uint32_t BaseVertex = 0;
+            std::uint32_t VertexCount = 0;
+            /// @brief 索引偏移（以索引为单位）
+            std::uint32_t FirstIndex = 0;
+            std::uint32_t IndexCount = 0;
+        };
+
+        /**
+         * 启用共享缓冲
+         * @remark 仅对之后创建的Mesh生效
+         * @param vertex_capacity 每页顶点数
+         * @param index_capacity 每页索引数
+         */
+        static void Enable(const std::uint32_t vertex_capacity = DefaultVertexCapacity, const std::uint32_t index_capacity = DefaultIndexCapacity) {
+            VertexCapacity = vertex_capacity;
+            IndexCapacity = index_capacity;
+            Enabled = true;
+            LogI(TAG) << "已启用网格共享缓冲 (每页顶点: " << vertex_capacity << ", 索引: " << index_capacity << ")";
+        }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /**
+         * 分配并上传网格数据
+         * @param vertices 顶点数据
+         * @param vertex_count 顶点数量
+         * @param stride 顶点大小（字节）
+         * @param indices 索引数据
+         * @param index_count 索引数量
+         * @param index_size 索引大小（2或4字节）
+         * @param setup 顶点布局设置函数
+         * @param positions 位置流数据（可为空）
+         * @param position_stride 位置流顶点大小（字节）
+         * @param position_setup 位置流布局设置函数
+         */
+        static std::optional<Allocation> Allocate(const void *vertices, const std::uint32_t vertex_count, const std::uint32_t stride,
+                                                  const void *indices, const std::uint32_t index_count, const std::uint32_t index_size,
+                                                  const LayoutSetup setup,
+                                                  const void *positions = nullptr, const std::uint32_t position_stride = 0,
+                                                  const LayoutSetup position_setup = nullptr) {
+            const Stream position{position_stride, position_setup};
+            for (std::uint32_t i = 0; i < Pages.size(); ++i) {
+                auto &page = *Pages[i];
+                if (page.Stride != stride || page.Setup != setup || page.Position != position || page.IndexSize != index_size) continue;
+                if (auto alloc = TryAllocate(page, i, vertex_count, index_count)) {
+                    Upload(page, *alloc, vertices, indices, positions);
+                    return alloc;
+                }
+            }
+            // 新建一页（超大网格单独成页）
+            const auto index = static_cast<std::uint32_t>(Pages.size());
+            Pages.push_back(CreatePage(std::max(VertexCapacity, vertex_count), std::max(IndexCapacity, index_count), stride, setup, position,
+                                       index_size));
+            auto alloc = TryAllocate(*Pages.back(), index, vertex_count, index_count);
+            if (alloc) Upload(*Pages.back(), *alloc, vertices, indices, positions);
+            return alloc;
+        }
+
+        /// 释放分配
+        static void Free(const Allocation &alloc) {
+            if (alloc.Page >= Pages.size()) return;
+            auto &page = *Pages[alloc.Page];
+            page.Vertices.Free(alloc.BaseVertex, alloc.VertexCount);
+            page.Indices.Free(alloc.FirstIndex, alloc.IndexCount);
+        }
+
+        /// 获取页的VAO
+        static unsigned int GetVAO(const std::uint32_t page) {
+            return page < Pages.size() ? Pages[page]->VAO : 0;
+        }
+
+        /// 获取页的位置流VAO（页无位置流时返回0）
+        static unsigned int GetDepthVAO(const std::uint32_t page) {
+            return page < Pages.size() ? Pages[page]->DepthVAO : 0;
+        }
+
+        /// 页数
+        static std::size_t GetPageCount() { return Pages.size(); }
+
+        /// 获取页的顶点分配器（用于统计）
+        static const OffsetAllocator &GetVertexAllocator(const std::uint32_t page) { return Pages[page]->Vertices; }
+
+        /// 获取页的索引分配器（用于统计）
+        static const OffsetAllocator &GetIndexAllocator(const std::uint32_t page) { return Pages[page]->Indices; }
+
+        /**
+         * 释放全部GPU资源
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        static void Release() {
+            for (const auto &page: Pages) {
+                GLState::DeleteVertexArray(page->VAO);
+                GLState::DeleteVertexArray(page->DepthVAO);
+                GLState::DeleteBuffer(page->VBO);
+                GLState::DeleteBuffer(page->PositionVBO);
+                GLState::DeleteBuffer(page->EBO);
+            }
+            Pages.clear();
+        }
+
+    private:
+        /// 附加顶点流
+        struct Stream {
+            std::uint32_t Stride = 0;
+            LayoutSetup Setup = nullptr;
+
+            bool operator==(const Stream &) const = default;
+        };
+
+        struct Page {
+            unsigned int VAO = 0, VBO = 0, EBO = 0;
+            /// @brief 位置流（无位置流时为0）
+            unsigned int DepthVAO = 0, PositionVBO = 0;
+            std::uint32_t Stride = 0;
+            LayoutSetup Setup = nullptr;
+            Stream Position;
+            /// @brief 索引大小（字节）
+            std::uint32_t IndexSize = sizeof(unsigned int);
+            OffsetAllocator Vertices;
+            OffsetAllocator Indices;
+
+            Page(const std::uint32_t vertex_capacity, const std::uint32_t index_capacity)
+                : Vertices(vertex_capacity), Indices(index_capacity) {
+            }
+        };
+
+        static std::unique_ptr<Page> CreatePage(const std::uint32_t vertex_capacity, const std::uint32_t index_capacity, const std::uint32_t stride,
+                                                const LayoutSetup setup, const Stream &position, const std::uint32_t index_size) {
+            auto page = std::make_unique<Page>(vertex_capacity, index_capacity);
+            page->IndexSize = index_size;
+            page->Stride = stride;
+            page->Setup = setup;
+            page->Position = position;
+            glGenVertexArrays(1, &page->VAO);
+            GLState::BindVertexArray(page->VAO);
+            glGenBuffers(1, &page->VBO);
+            GLState::BindBuffer(GL_ARRAY_BUFFER, page->VBO);
+            glBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_capacity) * stride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+            setup();
+            glGenBuffers(1, &page->EBO);
+            GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, page->EBO);
+            glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(index_capacity) * index_size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+            if (position.Setup != nullptr) {
+                glGenVertexArrays(1, &page->DepthVAO);
+                GLState::BindVertexArray(page->DepthVAO);
+                glGenBuffers(1, &page->PositionVBO);
+                GLState::BindBuffer(GL_ARRAY_BUFFER, page->PositionVBO);
+                glBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_capacity) * position.Stride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+                position.Setup();
+                GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, page->EBO);
+            }
+            GLState::BindVertexArray(0);
+            LogD(TAG) << "新建网格共享缓冲页 (顶点: " << vertex_capacity << " x " << stride << "字节, 索引: " << index_capacity << " x " << index_size
+                      << "字节)";
+            return page;
+        }
+
+        static std::optional<Allocation> TryAllocate(Page &page, const std::uint32_t page_index, const std::uint32_t vertex_count,
+                                                     const std::uint32_t index_count) {
+            const auto base_vertex = page.Vertices.Allocate(vertex_count);
+            if (!base_vertex) return std::nullopt;
+            const auto first_index = page.Indices.Allocate(index_count);
+            if (!first_index) {
+                page.Vertices.Free(*base_vertex, vertex_count);
+                return std::nullopt;
+            }
+            return Allocation{page_index, *base_vertex, vertex_count, *first_index, index_count};
+        }
+
+        static void Upload(const Page &page, const Allocation &alloc, const void *vertices, const void *indices, const void *positions) {
+            // 使用COPY_WRITE绑定点上传，避免修改VAO的索引缓冲绑定
+            GLState::BindBuffer(GL_COPY_WRITE_BUFFER, page.VBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(alloc.BaseVertex) * page.Stride,
+                            static_cast<GLsizeiptr>(alloc.VertexCount) * page.Stride, vertices);
+            GLState::BindBuffer(GL_COPY_WRITE_BUFFER, page.EBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(alloc.FirstIndex) * page.IndexSize,
+                            static_cast<GLsizeiptr>(alloc.IndexCount) * page.IndexSize, indices);
+            if (page.PositionVBO != 0 && positions != nullptr) {
+                GLState::BindBuffer(GL_COPY_WRITE_BUFFER, page.PositionVBO);
+                glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(alloc.BaseVertex) * page.Position.Stride,
+                                static_cast<GLsizeiptr>(alloc.VertexCount) * page.Position.Stride, positions);
+            }
+        }
+
+        static bool Enabled;
+        static std::uint32_t VertexCapacity;
+        static std::uint32_t IndexCapacity;
+        static std::vector<std::unique_ptr<Page> > Pages;
+    };
+
+    const char *MeshArena::TAG = "MeshArena";
+    bool MeshArena::Enabled = false;
+    std::uint32_t MeshArena::VertexCapacity = MeshArena::DefaultVertexCapacity;
+    std::uint32_t MeshArena::IndexCapacity = MeshArena::DefaultIndexCapacity;
+    std::vector<std::unique_ptr<MeshArena::Page> > MeshArena::Pages;
+}
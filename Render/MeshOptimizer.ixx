@@ -0,0 +1,356 @@
+/**
+ * @file MeshOptimizer.ixx
+ * @brief 网格优化（导入时）
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glm/glm.hpp>
+export module CEngine.Render:MeshOptimizer;
+import :VertexLayout;
+import std;
+import CEngine.Hash;
+
+namespace CEngine {
+    /// 网格优化结果
+    export struct MeshOptimizeStats {
+        std::uint32_t VerticesBefore = 0;
+        std::uint32_t VerticesAfter = 0;
+        /// @brief 平均每个三角形的顶点缓存未命中数（FIFO模拟）
+        float ACMRBefore = 0.0f;
+        float ACMRAfter = 0.0f;
+        /// @brief 按遮挡排序的簇数（为0表示未进行过绘制排序或已回退）
+        std::uint32_t OverdrawClusters = 0;
+    };
+
+    /**
+     * @brief 网格优化器
+     * @remark 依次进行：合并相同顶点 -> 顶点缓存优化（Forsyth） -> 过度绘制排序（按簇，由外向内） -> 按首次使用重排顶点\n
+     * 仅处理三角形列表，索引数不是3的倍数时跳过
+     */
+    export class MeshOptimizer {
+    public:
+        MeshOptimizer() = delete;
+
+        /// 模拟ACMR所用的FIFO缓存大小
+        static constexpr std::uint32_t DefaultCacheSize = 16;
+        /// 过度绘制排序允许的ACMR增幅
+        static constexpr float DefaultOverdrawThreshold = 1.05f;
+
+        /// 启用导入时优化（默认开启）
+        static void SetEnabled(const bool enabled) { Enabled = enabled; }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /**
+         * 优化网格
+         * @param vertices 顶点（会被合并与重排）
+         * @param indices 索引（会被重写）
+         * @param overdraw_threshold 过度绘制排序允许的ACMR增幅，小于1时不排序
+         */
+        static MeshOptimizeStats Optimize(std::vector<VertexInfo> &vertices, std::vector<unsigned int> &indices,
+                                          const float overdraw_threshold = DefaultOverdrawThreshold) {
+            MeshOptimizeStats stats;
+            stats.VerticesBefore = static_cast<std::uint32_t>(vertices.size());
+            stats.ACMRBefore = ComputeACMR(indices, stats.VerticesBefore);
+            if (indices.size() % 3 != 0 || indices.empty()) {
+                stats.VerticesAfter = stats.VerticesBefore;
+                stats.ACMRAfter = stats.ACMRBefore;
+                return stats;
+            }
+            WeldVertices(vertices, indices);
+            OptimizeVertexCache(indices, static_cast<std::uint32_t>(vertices.size()));
+            if (overdraw_threshold >= 1.0f) stats.OverdrawClusters = OptimizeOverdraw(indices, vertices, overdraw_threshold);
+            OptimizeVertexFetch(vertices, indices);
+            stats.VerticesAfter = static_cast<std::uint32_t>(vertices.size());
+            stats.ACMRAfter = ComputeACMR(indices, stats.VerticesAfter);
+            return stats;
+        }
+
+        /**
+         * 合并相同的顶点（VertexInfo::operator==）
+         * @return 合并后的顶点数
+         */
+        static std::uint32_t WeldVertices(std::vector<VertexInfo> &vertices, std::vector<unsigned int> &indices) {
+            std::unordered_map<VertexInfo, unsigned int, VertexInfoHasher> unique;
+            unique.reserve(vertices.size());
+            std::vector<unsigned int> remap(vertices.size());
+            std::vector<VertexInfo> welded;
+            welded.reserve(vertices.size());
+            for (std::size_t i = 0; i < vertices.size(); ++i) {
+                const auto [it, inserted] = unique.try_emplace(vertices[i], static_cast<unsigned int>(welded.size()));
+                if (inserted) welded.push_back(vertices[i]);
+                remap[i] = it->second;
+            }
+            for (auto &index: indices)
+                index = remap[index];
+            vertices = std::move(welded);
+            return static_cast<std::uint32_t>(vertices.size());
+        }
+
+        /**
+         * 按顶点缓存命中率重排三角形
+         * @remark Tom Forsyth, Linear-Speed Vertex Cache Optimisation
+         * @param indices 三角形列表
+         * @param vertex_count 顶点数
+         */
+        static void OptimizeVertexCache(std::vector<unsigned int> &indices, const std::uint32_t vertex_count) {
+            const auto triangle_count = indices.size() / 3;
+            if (triangle_count == 0) return;
+            // 每个顶点引用的三角形
+            std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+            for (const auto index: indices)
+                ++offsets[index + 1];
+            for (std::uint32_t v = 0; v < vertex_count; ++v)
+                offsets[v + 1] += offsets[v];
+            std::vector<std::uint32_t> remaining(vertex_count);
+            for (std::uint32_t v = 0; v < vertex_count; ++v)
+                remaining[v] = offsets[v + 1] - offsets[v];
+            std::vector<std::uint32_t> adjacency(indices.size());
+            {
+                auto fill = offsets;
+                for (std::size_t i = 0; i < indices.size(); ++i)
+                    adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+            std::vector<int> cache_position(vertex_count, -1);
+            std::vector<float> vertex_score(vertex_count);
+            for (std::uint32_t v = 0; v < vertex_count; ++v)
+                vertex_score[v] = VertexScore(-1, remaining[v]);
+            std::vector<float> triangle_score(triangle_count);
+            std::vector<bool> emitted(triangle_count, false);
+            for (std::size_t t = 0; t < triangle_count; ++t)
+                triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+
+            std::vector<unsigned int> output;
+            output.reserve(indices.size());
+            std::vector<std::uint32_t> cache, next_cache;
+            cache.reserve(ForsythCacheSize + 3);
+            next_cache.reserve(ForsythCacheSize + 3);
+            std::size_t best = std::ranges::max_element(triangle_score) - triangle_score.begin();
+            std::size_t cursor = 0;
+            for (std::size_t n = 0; n < triangle_count; ++n) {
+                if (best == triangle_count) {
+                    // 缓存中没有可用的三角形，取下一个未输出的
+                    while (emitted[cursor]) ++cursor;
+                    best = cursor;
+                }
+                emitted[best] = true;
+                const std::array tri = {indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2]};
+                output.insert(output.end(), tri.begin(), tri.end());
+                // 从顶点的邻接表中移除
+                for (const auto v: tri) {
+                    const auto begin = adjacency.begin() + offsets[v];
+                    const auto end = begin + remaining[v];
+                    std::iter_swap(std::find(begin, end, static_cast<std::uint32_t>(best)), end - 1);
+                    --remaining[v];
+                }
+                // 更新LRU缓存
+                next_cache.assign(tri.begin(), tri.end());
+                for (const auto v: cache)
+                    if (v != tri[0] && v != tri[1] && v != tri[2]) next_cache.push_back(v);
+                for (std::size_t i = 0; i < next_cache.size(); ++i)
+                    cache_position[next_cache[i]] = i < ForsythCacheSize ? static_cast<int>(i) : -1;
+                // 更新分数
+                for (const auto v: next_cache) {
+                    const float score = VertexScore(cache_position[v], remaining[v]);
+                    const float delta = score - vertex_score[v];
+                    vertex_score[v] = score;
+                    for (std::uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; ++i)
+                        triangle_score[adjacency[i]] += delta;
+                }
+                // 在缓存内的顶点相邻的三角形中找下一个最佳三角形
+                best = triangle_count;
+                float best_score = -1.0f;
+                for (const auto v: next_cache) {
+                    if (cache_position[v] < 0) continue;
+                    for (std::uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; ++i)
+                        if (const auto t = adjacency[i]; triangle_score[t] > best_score) {
+                            best_score = triangle_score[t];
+                            best = t;
+                        }
+                }
+                if (next_cache.size() > ForsythCacheSize) next_cache.resize(ForsythCacheSize);
+                std::swap(cache, next_cache);
+            }
+            indices = std::move(output);
+        }
+
+        /**
+         * 按遮挡关系重排三角形簇以减少过度绘制
+         * @remark Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw：\n
+         * 在顶点缓存冷启动处（硬边界）与局部ACMR不超过阈值处（软边界）切分簇，\n
+         * 按簇中心相对网格中心在簇法线上的投影从大到小排序（朝外的簇先画）；ACMR增幅超过阈值时回退
+         * @param indices 已做顶点缓存优化的三角形列表
+         * @param vertices 顶点
+         * @param threshold 允许的ACMR增幅
+         * @return 簇数，回退时为0
+         */
+        static std::uint32_t OptimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<VertexInfo> &vertices, const float threshold) {
+            const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+            const auto vertex_count = static_cast<std::uint32_t>(vertices.size());
+            if (triangle_count < 2) return 0;
+            const float acmr = ComputeACMR(indices, vertex_count);
+            // 硬边界：三个顶点都未命中
+            std::vector<std::uint32_t> hard{0};
+            {
+                FifoCache cache(vertex_count, DefaultCacheSize);
+                for (std::uint32_t t = 0; t < triangle_count; ++t)
+                    if (cache.Access(indices[t * 3]) + cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]) == 3 && t > 0)
+                        hard.push_back(t);
+                hard.push_back(triangle_count);
+            }
+            // 软边界：在硬边界之间，局部ACMR已不超过整体ACMR * threshold时切分
+            std::vector<std::uint32_t> clusters;
+            for (std::size_t h = 0; h + 1 < hard.size(); ++h) {
+                FifoCache cache(vertex_count, DefaultCacheSize);
+                std::uint32_t start = hard[h], misses = 0;
+                clusters.push_back(start);
+                for (auto t = hard[h]; t < hard[h + 1]; ++t) {
+                    misses += cache.Access(indices[t * 3]) + cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]);
+                    const auto count = t - start + 1;
+                    if (t + 1 < hard[h + 1] && count >= MinClusterTriangles && static_cast<float>(misses) <= acmr * threshold * static_cast<float>(count)) {
+                        start = t + 1;
+                        misses = 0;
+                        cache.Reset();
+                        clusters.push_back(start);
+                    }
+                }
+            }
+            clusters.push_back(triangle_count);
+            const auto cluster_count = static_cast<std::uint32_t>(clusters.size() - 1);
+            if (cluster_count < 2) return 0;
+            // 网格中心（按面积加权）
+            glm::vec3 mesh_center(0.0f);
+            float mesh_area = 0.0f;
+            std::vector<glm::vec3> centers(cluster_count), normals(cluster_count);
+            for (std::uint32_t c = 0; c < cluster_count; ++c) {
+                glm::vec3 center(0.0f), normal(0.0f);
+                float area = 0.0f;
+                for (auto t = clusters[c]; t < clusters[c + 1]; ++t) {
+                    const auto &p0 = vertices[indices[t * 3]].Position;
+                    const auto &p1 = vertices[indices[t * 3 + 1]].Position;
+                    const auto &p2 = vertices[indices[t * 3 + 2]].Position;
+                    const auto cross = glm::cross(p1 - p0, p2 - p0);
+                    const float a = glm::length(cross);
+                    center += (p0 + p1 + p2) * (a / 3.0f);
+                    normal += cross;
+                    area += a;
+                }
+                mesh_center += center;
+                mesh_area += area;
+                centers[c] = area > 0.0f ? center / area : vertices[indices[clusters[c] * 3]].Position;
+                normals[c] = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f);
+            }
+            if (mesh_area > 0.0f) mesh_center /= mesh_area;
+            std::vector<float> sort_keys(cluster_count);
+            std::vector<std::uint32_t> order(cluster_count);
+            for (std::uint32_t c = 0; c < cluster_count; ++c) {
+                sort_keys[c] = glm::dot(centers[c] - mesh_center, normals[c]);
+                order[c] = c;
+            }
+            std::ranges::stable_sort(order, [&](const auto a, const auto b) { return sort_keys[a] > sort_keys[b]; });
+            std::vector<unsigned int> sorted;
+            sorted.reserve(indices.size());
+            for (const auto c: order)
+                sorted.insert(sorted.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+            if (ComputeACMR(sorted, vertex_count) > acmr * threshold) return 0;
+            indices = std::move(sorted);
+            return cluster_count;
+        }
+
+        /**
+         * 按索引中首次出现的顺序重排顶点，提高顶点读取的局部性（未被引用的顶点被移除）
+         */
+        static void OptimizeVertexFetch(std::vector<VertexInfo> &vertices, std::vector<unsigned int> &indices) {
+            constexpr auto unused = std::numeric_limits<unsigned int>::max();
+            std::vector<unsigned int> remap(vertices.size(), unused);
+            std::vector<VertexInfo> reordered;
+            reordered.reserve(vertices.size());
+            for (auto &index: indices) {
+                if (remap[index] == unused) {
+                    remap[index] = static_cast<unsigned int>(reordered.size());
+                    reordered.push_back(vertices[index]);
+                }
+                index = remap[index];
+            }
+            vertices = std::move(reordered);
+        }
+
+        /**
+         * 平均缓存未命中率（ACMR）
+         * @param indices 三角形列表
+         * @param vertex_count 顶点数
+         * @param cache_size FIFO缓存大小
+         * @return 每个三角形的平均未命中数（0.5 ~ 3）
+         */
+        static float ComputeACMR(const std::vector<unsigned int> &indices, const std::uint32_t vertex_count,
+                                 const std::uint32_t cache_size = DefaultCacheSize) {
+            const auto triangle_count = indices.size() / 3;
+            if (triangle_count == 0) return 0.0f;
+            FifoCache cache(vertex_count, cache_size);
+            std::size_t misses = 0;
+            for (std::size_t i = 0; i < triangle_count * 3; ++i)
+                misses += cache.Access(indices[i]);
+            return static_cast<float>(misses) / static_cast<float>(triangle_count);
+        }
+
+    private:
+        /// 按值哈希VertexInfo（与operator==一致：-0.0f视为0.0f）
+        struct VertexInfoHasher {
+            std::size_t operator()(const VertexInfo &vertex) const {
+                std::array values{
+                    vertex.Position.x, vertex.Position.y, vertex.Position.z, vertex.Normal.x, vertex.Normal.y, vertex.Normal.z,
+                    vertex.TexCoord.x, vertex.TexCoord.y
+                };
+                for (auto &value: values)
+                    if (value == 0.0f) value = 0.0f;
+                return static_cast<std::size_t>(Hasher::Hash(values.data(), sizeof(values)).Low);
+            }
+        };
+
+        /// 模拟GPU的FIFO顶点缓存
+        class FifoCache {
+        public:
+            FifoCache(const std::uint32_t vertex_count, const std::uint32_t size) : Timestamps(vertex_count, 0), Size(size) {
+            }
+
+            /// 访问顶点，未命中返回1
+            std::uint32_t Access(const unsigned int vertex) {
+                if (Time - Timestamps[vertex] < Size && Timestamps[vertex] != 0) return 0;
+                Timestamps[vertex] = ++Time;
+                return 1;
+            }
+
+            void Reset() {
+                // 推进时间使所有条目过期
+                Time += Size + 1;
+            }
+
+        private:
+            std::vector<std::uint64_t> Timestamps;
+            std::uint64_t Time = 0;
+            std::uint32_t Size;
+        };
+
+        static constexpr std::uint32_t ForsythCacheSize = 32;
+        static constexpr std::uint32_t MinClusterTriangles = 16;
+
+        static float VertexScore(const int cache_position, const std::uint32_t remaining) {
+            if (remaining == 0) return -1.0f;
+            float score = 0.0f;
+            if (cache_position >= 0) {
+                if (cache_position < 3)
+                    score = 0.75f;
+                else
+                    score = std::pow(1.0f - static_cast<float>(cache_position - 3) / (ForsythCacheSize - 3), 1.5f);
+            }
+            return score + 2.0f / std::sqrt(static_cast<float>(remaining));
+        }
+
+        static bool Enabled;
+    };
+
+    bool MeshOptimizer::Enabled = true;
+}
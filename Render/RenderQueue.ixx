@@ -0,0 +1,491 @@
+/**
+ * @file RenderQueue.ixx
+ * @brief 渲染队列
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Utils/Profiler.h"
+export module CEngine.Render:RenderQueue;
+import :ShaderProgram;
+import :ShaderUniformVar;
+import :UniformOverrides;
+import :Material;
+import :MaterialPool;
+import :Mesh;
+import :MeshArena;
+import :VertexLayout;
+import :Texture;
+import :GLState;
+import :FrameRingBuffer;
+import :GPUProfiler;
+import std;
+import CEngine.Base;
+import CEngine.Logger;
+import CEngine.Profiler;
+
+namespace CEngine {
+    /// 渲染通道（数值越小越先绘制）
+    export enum class RenderPass : std::uint8_t {
+        Opaque = 0,
+        Transparent = 1,
+    };
+
+    /**
+     * @brief 渲染包
+     * @remark 一次绘制所需的全部信息
+     */
+    export struct RenderPacket {
+        /// @brief 排序键
+        std::uint64_t Key = 0;
+        ShaderProgram *Program = nullptr;
+        /// @brief 材质（可为空）
+        const Material *Mat = nullptr;
+        const Mesh *MeshPtr = nullptr;
+        /// @brief 材质批次ID（0表示可与其它材质合并，见Material::GetBatchID）
+        std::uint32_t MaterialBatch = 0;
+        glm::mat4 MVP{1.0f};
+        /// @brief 覆盖的Shader Uniform（可为空）
+        UniformOverrides *Uniforms = nullptr;
+    };
+
+    /**
+     * @brief 帧常量
+     * @remark 与GLSL中Frame_Constants（std140）对应，每帧绑定一次
+     */
+    export struct FrameConstants {
+        glm::mat4 View{1.0f};
+        glm::mat4 Projection{1.0f};
+        glm::mat4 ViewProjection{1.0f};
+        glm::vec4 CameraPosition{0.0f};
+        glm::vec2 ScreenSize{0.0f};
+        /// @brief 运行时间（秒）
+        float Time = 0.0f;
+        /// @brief 上一帧耗时（毫秒）
+        float DeltaTime = 0.0f;
+    };
+
+    /**
+     * @brief 渲染队列统计
+     * @remark 每次Flush后更新
+     */
+    export struct RenderQueueStats {
+        std::uint32_t Packets = 0;
+        std::uint32_t DrawCalls = 0;
+        std::uint32_t InstancedBatches = 0;
+        std::uint32_t InstancedPackets = 0;
+        std::uint32_t MultiDrawCalls = 0;
+        std::uint32_t MultiDrawCommands = 0;
+        std::uint32_t ProgramBinds = 0;
+        std::uint32_t ProgramSwitchesAvoided = 0;
+        std::uint32_t VAOBinds = 0;
+        std::uint32_t VAOSwitchesAvoided = 0;
+        std::uint32_t TextureBinds = 0;
+        std::uint32_t TextureSwitchesAvoided = 0;
+        /// @brief 上传的覆盖Uniform数
+        std::uint32_t UniformUploads = 0;
+        /// @brief 写入帧环形缓冲的字节数
+        std::uint32_t FrameDataBytes = 0;
+    };
+
+    /**
+     * @brief 渲染队列
+     * @remark 渲染单位每帧提交渲染包，按64位排序键进行基数排序后顺序提交，\n
+     * 相邻渲染包相同的ShaderProgram、材质、VAO不再重复绑定，可合并的渲染包使用实例化绘制，\n
+     * 网格位于同一共享缓冲页时整组使用glMultiDrawElementsIndirect提交；\n
+     * 帧常量、变换矩阵、绘制数据与间接命令每帧写入持久映射的帧环形缓冲\n
+     * 不透明键：通道(2) | ShaderProgram(12) | 材质批次(14) | 网格标识(16，Mesh::getSortID) | 深度(20，由近到远)\n
+     * 透明键：通道(2) | 反转深度(24，由远到近) | ShaderProgram(12) | 材质批次(14) | 网格(12)
+     */
+    export class RenderQueue {
+    public:
+        const static char *TAG;
+
+        RenderQueue() = default;
+        RenderQueue(const RenderQueue &) = delete;
+        RenderQueue &operator=(const RenderQueue &) = delete;
+
+        /// 清空队列（每帧开始时调用）
+        void Clear() {
+            Packets.clear();
+        }
+
+        /**
+         * 设置帧常量
+         * @remark 在Flush时写入帧环形缓冲并绑定到FrameConstantsBinding
+         */
+        void SetFrameConstants(const FrameConstants &constants) {
+            Constants = constants;
+        }
+
+        /**
+         * 提交渲染包
+         * @remark 网格使用紧凑顶点时自动选择对应的着色器变体，量化位置的反量化变换并入MVP；\n
+         * 着色器程序（或所需的变体）仍在编译时跳过
+         * @param pass 渲染通道
+         * @param program ShaderProgram
+         * @param mat 材质（可为空）
+         * @param mesh 网格
+         * @param mvp MVP矩阵
+         * @param uniforms 覆盖的Shader Uniform（可为空）
+         */
+        void Submit(const RenderPass pass, ShaderProgram *program, const Material *mat, const Mesh *mesh, const glm::mat4 &mvp,
+                    UniformOverrides *uniforms = nullptr) {
+            if (program == nullptr || mesh == nullptr) return;
+            if (mesh->getLayout().Normal == NormalFormat::Octahedral16)
+                if (const auto variant = program->GetVariant(ShaderProgram::Variant_OctahedralNormal);
+                    variant != nullptr && variant->getBuildState() != ShaderProgram::BuildState::Failed)
+                    program = variant;
+            if (!program->IsReady()) return;
+            // 物体原点的裁剪空间深度，透视与正交投影下均随距离单调递增
+            const float depth = std::max((mvp * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)).z, 0.0f);
+            const std::uint64_t program_id = program->getShaderProgramID();
+            const std::uint32_t material_batch = mat == nullptr ? 0 : mat->GetBatchID();
+            const std::uint64_t material_id = material_batch;
+            const std::uint64_t mesh_id = mesh->getSortID();
+            std::uint64_t key = static_cast<std::uint64_t>(pass) << 62;
+            if (pass == RenderPass::Opaque) {
+                key |= (program_id & 0xFFF) << 50 | (material_id & 0x3FFF) << 36 | (mesh_id & 0xFFFF) << 20 | QuantizeDepth(depth, 20);
+            } else {
+                const std::uint64_t inverted_depth = ~QuantizeDepth(depth, 24) & 0xFFFFFF;
+                key |= inverted_depth << 38 | (program_id & 0xFFF) << 26 | (material_id & 0x3FFF) << 12 | (mesh_id & 0xFFF);
+            }
+            Packets.push_back({key, program, mat, mesh, material_batch, mesh->IsPositionQuantized() ? mvp * mesh->getDequantizeMatrix() : mvp,
+                               uniforms != nullptr && !uniforms->empty() ? uniforms : nullptr});
+        }
+
+        /// 按排序键进行基数排序
+        void Sort() {
+            CE_PROFILE_ZONE("RenderQueue::Sort");
+            const auto count = Packets.size();
+            Keys.resize(count);
+            KeysScratch.resize(count);
+            Order.resize(count);
+            OrderScratch.resize(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                Keys[i] = Packets[i].Key;
+                Order[i] = static_cast<std::uint32_t>(i);
+            }
+            if (count < 2) return;
+            // LSD基数排序：每次处理8位，共8趟（稳定排序）
+            for (unsigned shift = 0; shift < 64; shift += 8) {
+                std::array<std::uint32_t, 256> offsets{};
+                for (const auto key: Keys)
+                    ++offsets[key >> shift & 0xFF];
+                // 所有键在该字节上相同，跳过本趟
+                if (offsets[Keys[0] >> shift & 0xFF] == count) continue;
+                std::uint32_t sum = 0;
+                for (auto &offset: offsets) {
+                    const auto c = offset;
+                    offset = sum;
+                    sum += c;
+                }
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto dst = offsets[Keys[i] >> shift & 0xFF]++;
+                    KeysScratch[dst] = Keys[i];
+                    OrderScratch[dst] = Order[i];
+                }
+                std::swap(Keys, KeysScratch);
+                std::swap(Order, OrderScratch);
+            }
+        }
+
+        /**
+         * 按排序结果提交绘制
+         * @remark 请先调用Sort\n
+         * 相邻且ShaderProgram、材质、网格均相同、无Uniform覆盖的渲染包合并为一次实例化绘制，
+         * 变换矩阵写入实例SSBO，使用ShaderProgram的CE_INSTANCED变体；单个渲染包同样以实例数1绘制，
+         * 仅在变体不可用时使用地址0的Uniform\n
+         * 各通道以GPUProfiler计时，启用绘制组计时时相同ShaderProgram的连续批次另计一个区间
+         */
+        void Flush() {
+            CE_PROFILE_ZONE("RenderQueue::Flush");
+            Stats = {};
+            Stats.Packets = static_cast<std::uint32_t>(Order.size());
+            BuildBatches();
+            UploadFrameData();
+            MaterialPool::Bind(ShaderProgram::MaterialBufferBinding);
+            const ShaderProgram *current_program = nullptr;
+            const Material *current_material = nullptr;
+            unsigned int current_vao = 0;
+            int material_texture_slots = 0;
+            bool blending = false;
+            const bool group_timing = GPUProfiler::IsDrawGroupTiming();
+            bool group_open = false;
+            GPUProfiler::Push("Opaque");
+            for (const auto &batch: Batches) {
+                const auto &packet = Packets[Order[batch.First]];
+                const auto program = batch.MultiDraw
+                                         ? packet.Program->GetReadyVariant(ShaderProgram::Variant_MultiDraw)
+                                         : batch.Instanced
+                                               ? packet.Program->GetReadyVariant(ShaderProgram::Variant_Instanced)
+                                               : packet.Program;
+                // 进入透明通道
+                if (!blending && packet.Key >> 62 == static_cast<std::uint64_t>(RenderPass::Transparent)) {
+                    if (group_open) GPUProfiler::Pop();
+                    group_open = false;
+                    GPUProfiler::Pop();
+                    GPUProfiler::Push("Transparent");
+                    GLState::Enable(GL_BLEND);
+                    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    GLState::DepthMask(false);
+                    blending = true;
+                }
+                bool program_changed = false;
+                if (program != current_program) {
+                    program->Use();
+                    current_program = program;
+                    program_changed = true;
+                    ++Stats.ProgramBinds;
+                } else {
+                    ++Stats.ProgramSwitchesAvoided;
+                }
+                if (group_timing && (program_changed || !group_open)) {
+                    if (group_open) GPUProfiler::Pop();
+                    GPUProfiler::Push(program->getName());
+                    group_open = true;
+                }
+                if (batch.MultiDraw)
+                    program->SetUniform(ShaderProgram::DrawOffsetLocation, batch.FirstCommand);
+                else if (!batch.Instanced)
+                    program->SetUniform(0, packet.MVP);
+                // 纹理单元与采样器Uniform随ShaderProgram保存，切换程序后需重新设置
+                if (packet.Mat != current_material || program_changed) {
+                    Texture::ResetTextureSlot();
+                    if (packet.Mat != nullptr) packet.Mat->Use(program);
+                    material_texture_slots = Texture::GetUsedTextureSlots();
+                    Stats.TextureBinds += material_texture_slots;
+                    current_material = packet.Mat;
+                } else {
+                    Stats.TextureSwitchesAvoided += material_texture_slots;
+                }
+                if (packet.Uniforms != nullptr) {
+                    Stats.UniformUploads += packet.Uniforms->Upload(program);
+                    // 覆盖的纹理占用材质之后的纹理槽，下一个渲染包重新使用
+                    Texture::SetUsedTextureSlots(material_texture_slots);
+                }
+                if (const auto vao = packet.MeshPtr->getVAO(); vao != current_vao) {
+                    packet.MeshPtr->Bind();
+                    current_vao = vao;
+                    ++Stats.VAOBinds;
+                } else {
+                    ++Stats.VAOSwitchesAvoided;
+                }
+                if (batch.MultiDraw) {
+                    glMultiDrawElementsIndirect(GL_TRIANGLES, packet.MeshPtr->getIndexType(),
+                                                reinterpret_cast<const void *>(CommandsOffset + batch.FirstCommand * sizeof(DrawCommand)),
+                                                static_cast<GLsizei>(batch.CommandCount), 0);
+                    ++Stats.MultiDrawCalls;
+                    Stats.MultiDrawCommands += batch.CommandCount;
+                } else if (batch.Instanced) {
+                    packet.MeshPtr->DrawInstanced(batch.Count, batch.BaseInstance);
+                    if (batch.Count >= MinInstanceCount) {
+                        ++Stats.InstancedBatches;
+                        Stats.InstancedPackets += batch.Count;
+                    }
+                } else {
+                    packet.MeshPtr->Draw();
+                }
+                ++Stats.DrawCalls;
+            }
+            if (group_open) GPUProfiler::Pop();
+            GPUProfiler::Pop();
+            if (blending) {
+                GLState::DepthMask(true);
+                GLState::Disable(GL_BLEND);
+            }
+            Ring.EndFrame();
+        }
+
+        /**
+         * 释放GPU资源
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        void Release() {
+            Ring.Release();
+        }
+
+        /// @property Stats
+        const RenderQueueStats &GetStats() const { return Stats; }
+
+        /// @property Packets
+        const std::vector<RenderPacket> &GetPackets() const { return Packets; }
+
+    private:
+        /**
+         * 量化深度
+         * @remark 非负浮点数的位模式与其数值单调一致，取高位即可
+         * @param depth 非负深度
+         * @param bits 保留位数
+         */
+        static std::uint64_t QuantizeDepth(const float depth, const unsigned bits) {
+            return std::bit_cast<std::uint32_t>(depth) >> (31 - bits);
+        }
+
+        /// 绘制批次
+        struct Batch {
+            /// @brief 在Order中的起始位置
+            std::uint32_t First = 0;
+            /// @brief 渲染包数量
+            std::uint32_t Count = 1;
+            /// @brief 实例数据起始位置
+            std::uint32_t BaseInstance = 0;
+            bool Instanced = false;
+            /// @brief 是否使用多重间接绘制
+            bool MultiDraw = false;
+            /// @brief 第一条间接绘制命令
+            std::uint32_t FirstCommand = 0;
+            /// @brief 间接绘制命令数量
+            std::uint32_t CommandCount = 0;
+        };
+
+        /// glMultiDrawElementsIndirect的命令结构
+        struct DrawCommand {
+            std::uint32_t Count;
+            std::uint32_t InstanceCount;
+            std::uint32_t FirstIndex;
+            std::int32_t BaseVertex;
+            std::uint32_t BaseInstance;
+        };
+
+        /// 绘制数据（与GLSL中Draw_Record对应）
+        struct DrawRecord {
+            std::uint32_t InstanceOffset;
+            std::uint32_t InstanceCount;
+        };
+
+        /// 两个渲染包的材质能否在同一次绘制中使用（相同，或均无需单独绑定纹理）
+        static bool SameMaterialBatch(const RenderPacket &a, const RenderPacket &b) {
+            return a.Mat == b.Mat || (a.Mat != nullptr && b.Mat != nullptr && a.MaterialBatch == 0 && b.MaterialBatch == 0);
+        }
+
+        /// 两个渲染包能否合并到同一次多重间接绘制
+        static bool CanMultiDraw(const RenderPacket &a, const RenderPacket &b) {
+            return a.Program == b.Program && SameMaterialBatch(a, b) && a.MeshPtr->getVAO() == b.MeshPtr->getVAO() && a.Uniforms == nullptr &&
+                   b.Uniforms == nullptr && a.Key >> 62 == b.Key >> 62;
+        }
+
+        /// 两个渲染包能否合并为一次实例化绘制（须为同一网格，共享缓冲中的不同网格VAO相同）
+        static bool CanInstance(const RenderPacket &a, const RenderPacket &b) {
+            return a.Program == b.Program && SameMaterialBatch(a, b) && a.MeshPtr->getSortID() == b.MeshPtr->getSortID() && b.Uniforms == nullptr &&
+                   a.Key >> 62 == b.Key >> 62;
+        }
+
+        /// 划分绘制批次
+        void BuildBatches() {
+            Batches.clear();
+            InstanceData.clear();
+            InstanceMaterials.clear();
+            Commands.clear();
+            DrawRecords.clear();
+            const auto count = static_cast<std::uint32_t>(Order.size());
+            for (std::uint32_t i = 0; i < count;) {
+                const auto &packet = Packets[Order[i]];
+                auto j = i + 1;
+                if (packet.Uniforms == nullptr)
+                    while (j < count && CanInstance(packet, Packets[Order[j]])) ++j;
+                // 共享缓冲中的网格：每组生成一条间接绘制命令，同一页的相邻组合并为一次多重绘制
+                if (packet.Uniforms == nullptr && packet.MeshPtr->IsInArena() &&
+                    packet.Program->GetReadyVariant(ShaderProgram::Variant_MultiDraw) != nullptr) {
+                    const auto instance_offset = static_cast<std::uint32_t>(InstanceData.size());
+                    for (auto k = i; k < j; ++k)
+                        PushInstance(Packets[Order[k]]);
+                    const auto &alloc = packet.MeshPtr->getArenaAllocation();
+                    Commands.push_back({alloc.IndexCount, j - i, alloc.FirstIndex, static_cast<std::int32_t>(alloc.BaseVertex), instance_offset});
+                    DrawRecords.push_back({instance_offset, j - i});
+                    if (!Batches.empty() && Batches.back().MultiDraw && CanMultiDraw(Packets[Order[Batches.back().First]], packet)) {
+                        Batches.back().Count += j - i;
+                        ++Batches.back().CommandCount;
+                    } else {
+                        Batches.push_back({i, j - i, instance_offset, false, true, static_cast<std::uint32_t>(Commands.size() - 1), 1});
+                    }
+                    i = j;
+                    continue;
+                }
+                if (packet.Program->GetReadyVariant(ShaderProgram::Variant_Instanced) != nullptr) {
+                    Batches.push_back({i, j - i, static_cast<std::uint32_t>(InstanceData.size()), true});
+                    for (auto k = i; k < j; ++k)
+                        PushInstance(Packets[Order[k]]);
+                } else {
+                    for (auto k = i; k < j; ++k)
+                        Batches.push_back({k, 1, 0, false});
+                }
+                i = j;
+            }
+        }
+
+        /// 追加实例数据
+        void PushInstance(const RenderPacket &packet) {
+            InstanceData.push_back(packet.MVP);
+            InstanceMaterials.push_back(packet.Mat == nullptr ? 0 : packet.Mat->getIndex());
+        }
+
+        /**
+         * 将帧常量、实例数据、绘制数据与间接命令写入帧环形缓冲并绑定
+         */
+        void UploadFrameData() {
+            if (UniformAlignment == 0) {
+                glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformAlignment);
+                glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &StorageAlignment);
+            }
+            const std::size_t ubo_align = UniformAlignment, ssbo_align = StorageAlignment;
+            const auto instance_bytes = InstanceData.size() * sizeof(glm::mat4);
+            const auto instance_material_bytes = InstanceMaterials.size() * sizeof(std::uint32_t);
+            const auto record_bytes = DrawRecords.size() * sizeof(DrawRecord);
+            const auto command_bytes = Commands.size() * sizeof(DrawCommand);
+            Ring.BeginFrame(sizeof(FrameConstants) + instance_bytes + instance_material_bytes + record_bytes + command_bytes + ubo_align + ssbo_align * 3 +
+                            alignof(DrawCommand));
+            const auto buffer = Ring.getBuffer();
+            if (const auto offset = Ring.Write(&Constants, sizeof(FrameConstants), ubo_align))
+                GLState::BindBufferRange(GL_UNIFORM_BUFFER, ShaderProgram::FrameConstantsBinding, buffer, *offset, sizeof(FrameConstants));
+            if (instance_bytes > 0)
+                if (const auto offset = Ring.Write(InstanceData.data(), instance_bytes, ssbo_align))
+                    GLState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, ShaderProgram::InstanceBufferBinding, buffer, *offset,
+                                             static_cast<GLsizeiptr>(instance_bytes));
+            if (instance_material_bytes > 0)
+                if (const auto offset = Ring.Write(InstanceMaterials.data(), instance_material_bytes, ssbo_align))
+                    GLState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, ShaderProgram::InstanceMaterialBufferBinding, buffer, *offset,
+                                             static_cast<GLsizeiptr>(instance_material_bytes));
+            if (command_bytes > 0) {
+                if (const auto offset = Ring.Write(DrawRecords.data(), record_bytes, ssbo_align))
+                    GLState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, ShaderProgram::DrawDataBufferBinding, buffer, *offset,
+                                             static_cast<GLsizeiptr>(record_bytes));
+                if (const auto offset = Ring.Write(Commands.data(), command_bytes, alignof(DrawCommand)))
+                    CommandsOffset = static_cast<std::uintptr_t>(*offset);
+                GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+            }
+            Stats.FrameDataBytes = static_cast<std::uint32_t>(sizeof(FrameConstants) + instance_bytes + instance_material_bytes + record_bytes + command_bytes);
+        }
+
+        /// 计入实例化合并统计的最少渲染包数量
+        static constexpr std::uint32_t MinInstanceCount = 2;
+
+        std::vector<RenderPacket> Packets;
+        std::vector<std::uint64_t> Keys, KeysScratch;
+        std::vector<std::uint32_t> Order, OrderScratch;
+        std::vector<Batch> Batches;
+        /// @brief 实例变换矩阵（每帧重新填充）
+        std::vector<glm::mat4> InstanceData;
+        /// @brief 实例材质索引（与InstanceData一一对应）
+        std::vector<std::uint32_t> InstanceMaterials;
+        /// @brief 间接绘制命令（每帧重新填充）
+        std::vector<DrawCommand> Commands;
+        /// @brief 绘制数据（每帧重新填充）
+        std::vector<DrawRecord> DrawRecords;
+        /// @brief 帧常量
+        FrameConstants Constants;
+        /// @brief 帧环形缓冲（实例数据、绘制数据、间接命令、帧常量）
+        FrameRingBuffer Ring;
+        /// @brief 本帧间接命令在环形缓冲中的偏移
+        std::uintptr_t CommandsOffset = 0;
+        /// @brief UBO/SSBO偏移对齐
+        GLint UniformAlignment = 0, StorageAlignment = 0;
+        RenderQueueStats Stats;
+    };
+
+    const char *RenderQueue::TAG = "RenderQueue";
+}
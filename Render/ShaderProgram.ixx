@@ -13,16 +13,107 @@ module;
 export module CEngine.Render:ShaderProgram;
 import :GLSL;
 import :ShaderUniformVar;
+import :GLState;
 import std;
 import CEngine.Base;
 import CEngine.Logger;
 import CEngine.Utils;
+import CEngine.Hash;
 
 namespace CEngine {
+    /**
+     * @brief 预解析的Uniform地址
+     * @remark 通过ShaderProgram::GetUniform获取，类型在获取时校验，设置时不再查询
+     * @tparam T 值类型
+     */
+    export template<typename T>
+    struct UniformLocation {
+        int Location = -1;
+
+        explicit operator bool() const { return Location >= 0; }
+    };
+
     export class ShaderProgram final : public Object {
     public:
         const static char *TAG;
-        static std::unordered_map<std::string, ShaderProgram *> All_Instances;
+        static std::unordered_map<std::string, Handle<ShaderProgram> > All_Instances;
+
+        /**
+         * @brief 变体标志
+         * @remark 每个标志对应一个在#version之后注入的宏
+         */
+        enum VariantFlags : unsigned int {
+            Variant_None = 0,
+            /// CE_INSTANCED：从实例SSBO读取变换矩阵
+            Variant_Instanced = 1u << 0,
+            /// CE_MULTI_DRAW：按Draw_Offset + gl_DrawID从绘制数据SSBO读取实例偏移
+            Variant_MultiDraw = 1u << 1,
+            /// CE_OCT_NORMAL：法线属性为八面体编码的vec2（见NormalFormat::Octahedral16）
+            Variant_OctahedralNormal = 1u << 2,
+        };
+
+        /// 实例材质索引SSBO的绑定点
+        static constexpr unsigned int InstanceMaterialBufferBinding = 3;
+        /// 帧常量UBO（Frame_Constants）的绑定点
+        static constexpr unsigned int FrameConstantsBinding = 0;
+        /// 实例数据SSBO的绑定点
+        static constexpr unsigned int InstanceBufferBinding = 0;
+        /// 绘制数据SSBO的绑定点
+        static constexpr unsigned int DrawDataBufferBinding = 1;
+        /// 材质参数SSBO的绑定点
+        static constexpr unsigned int MaterialBufferBinding = 2;
+        /// 多重绘制批次起始记录（Draw_Offset）的Uniform地址
+        static constexpr int DrawOffsetLocation = 1;
+
+        /// 构建状态
+        enum class BuildState {
+            /// 已链接，可以使用
+            Ready,
+            /// 编译或链接中（见ProcessPendingPrograms）
+            Pending,
+            /// 编译或链接失败
+            Failed
+        };
+
+        /// 链接后反射得到的Uniform信息
+        struct UniformInfo {
+            int Location = -1;
+            ShaderUniformVar::Type Type = ShaderUniformVar::Type::UNKNOWN;
+            GLenum GLType = 0;
+            int ArraySize = 1;
+        };
+
+        /// 名称 -> Uniform，支持以std::string_view、const char*查找（不分配内存）
+        using UniformMap = std::unordered_map<std::string, UniformInfo, StringHasher, std::equal_to<> >;
+
+        /// 单个阶段的源码
+        struct StageSource {
+            GLSL::ShaderType Type;
+            std::string Source;
+            /// @brief 调试输出用的名称（如文件路径）
+            std::string Name;
+        };
+
+        /// 链接后反射得到的UBO/SSBO信息
+        struct BlockInfo {
+            unsigned int Index = 0;
+            int Binding = 0;
+            int DataSize = 0;
+        };
+
+        /**
+         * 通过名称获取ShaderProgram
+         * @param name 名称
+         * @remark 句柄已失效（程序已销毁）的条目随即移除
+         * @return 不存在或已销毁时返回<code>nullptr</code>
+         */
+        static ShaderProgram *Find(const std::string &name) {
+            const auto it = All_Instances.find(name);
+            if (it == All_Instances.end()) return nullptr;
+            if (const auto program = it->second.Get(); program != nullptr) return program;
+            All_Instances.erase(it);
+            return nullptr;
+        }
 
 
         ShaderProgram(const ShaderProgram &) = delete;
@@ -31,8 +122,10 @@ namespace CEngine {
         ShaderProgram &operator=(ShaderProgram &&) = delete;
 
         ~ShaderProgram() override {
-            glDeleteProgram(shader_program_id);
-            All_Instances.erase(Name);
+            for (const auto variant: Variants | std::views::values)
+                delete variant;
+            GLState::DeleteProgram(shader_program_id);
+            if (Parent == nullptr) Unregister();
         }
 
         /**
@@ -52,6 +145,117 @@ namespace CEngine {
             return new ShaderProgram(name);
         }
 
+        /**
+         * 由源码创建ShaderProgram
+         * @remark 启用程序二进制缓存时优先以glProgramBinary加载缓存，驱动拒绝或未命中时编译源码并链接，\n
+         * 成功后以glGetProgramBinary写入缓存；缓存以源码与GL_RENDERER/GL_VERSION的哈希命名
+         * @param name 名称(可通过All_Instances获取实例)
+         * @param stages 各阶段源码
+         * @return 编译或链接失败返回<code>nullptr</code>
+         */
+        static ShaderProgram *CreateFromSource(const std::string &name, const std::vector<StageSource> &stages) {
+            const auto program = new ShaderProgram(name);
+            for (const auto &stage: stages) {
+                program->glsl_list.push_back(stage.Name);
+                program->Sources.emplace_back(stage.Type, stage.Source);
+            }
+            return program->Build(false);
+        }
+
+        /**
+         * 由源码异步创建ShaderProgram
+         * @remark 与CreateFromSource相同，但只提交编译与链接而不等待结果，程序立即注册到All_Instances；\n
+         * 由<code>ProcessPendingPrograms</code>在之后的帧中取得结果，此前IsReady为<code>false</code>，\n
+         * 失败时状态变为Failed并从All_Instances移除
+         * @param name 名称(可通过All_Instances获取实例)
+         * @param stages 各阶段源码
+         */
+        static ShaderProgram *CreateFromSourceAsync(const std::string &name, const std::vector<StageSource> &stages) {
+            const auto program = new ShaderProgram(name);
+            for (const auto &stage: stages) {
+                program->glsl_list.push_back(stage.Name);
+                program->Sources.emplace_back(stage.Type, stage.Source);
+            }
+            return program->Build(true);
+        }
+
+        /**
+         * 检测并行着色器编译（GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile）
+         * @remark 需在OpenGL上下文创建后调用；可用时由驱动自行决定编译线程数，\n
+         * 并以GL_COMPLETION_STATUS轮询异步程序，不可用时异步程序的结果在帧间按时间预算取得
+         * @param load 函数地址加载器
+         */
+        static void DetectParallelCompileSupport(const GLADloadproc load) {
+            int count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            const char *proc_name = nullptr;
+            for (int i = 0; i < count && proc_name == nullptr; ++i) {
+                const std::string_view extension(reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i)));
+                if (extension == "GL_KHR_parallel_shader_compile") proc_name = "glMaxShaderCompilerThreadsKHR";
+                else if (extension == "GL_ARB_parallel_shader_compile") proc_name = "glMaxShaderCompilerThreadsARB";
+            }
+            ParallelCompileAvailable = proc_name != nullptr;
+            if (ParallelCompileAvailable)
+                if (const auto max_threads = reinterpret_cast<MaxShaderCompilerThreadsProc>(load(proc_name)); max_threads != nullptr)
+                    max_threads(0xFFFFFFFF);
+            LogI(TAG) << "并行着色器编译" << (ParallelCompileAvailable ? "可用" : "不可用");
+        }
+
+        static bool IsParallelCompileAvailable() { return ParallelCompileAvailable; }
+
+        /**
+         * 处理异步编译的程序
+         * @remark 在渲染线程每帧调用一次：取得已完成程序的结果（反射、写入程序二进制缓存）；\n
+         * 并行编译不可用时无法得知是否完成，按提交顺序在时间预算内逐个等待（每帧至少处理一个）
+         * @param budget_ms 每帧的时间预算（毫秒）
+         */
+        static void ProcessPendingPrograms(const double budget_ms) {
+            const auto start = std::chrono::steady_clock::now();
+            bool first = true;
+            std::erase_if(PendingPrograms, [&](const Handle<ShaderProgram> &handle) {
+                const auto program = handle.Get();
+                if (program == nullptr) return true;
+                if (!program->IsCompletionReady()) return false;
+                if (!first && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >= budget_ms)
+                    return false;
+                first = false;
+                program->Finish();
+                return true;
+            });
+        }
+
+        /// 等待所有异步编译的程序完成
+        static void FinishPendingPrograms() {
+            for (const auto &handle: PendingPrograms)
+                if (const auto program = handle.Get(); program != nullptr) program->Finish();
+            PendingPrograms.clear();
+        }
+
+        /// 尚未完成的异步程序数
+        static std::size_t GetPendingPrograms() {
+            return PendingPrograms.size();
+        }
+
+        /// 是否启用程序二进制缓存（驱动不支持任何二进制格式时始终不启用）
+        static void SetBinaryCacheEnabled(const bool enabled) { BinaryCacheEnabled = enabled; }
+
+        static bool IsBinaryCacheEnabled() {
+            if (!BinaryCacheEnabled) return false;
+            static const bool supported = [] {
+                GLint formats = 0;
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+                if (formats == 0) LogW(TAG) << "驱动不支持程序二进制，不使用程序二进制缓存";
+                return formats > 0;
+            }();
+            return supported;
+        }
+
+        /// @property BinaryCacheDirectory
+        static void SetBinaryCacheDirectory(const std::filesystem::path &dir) { BinaryCacheDirectory = dir; }
+
+        /// @property BinaryCacheDirectory
+        static const std::filesystem::path &GetBinaryCacheDirectory() { return BinaryCacheDirectory; }
+
         /**
          * 添加Shader
          * @param shader GLSL对象
@@ -59,7 +263,7 @@ namespace CEngine {
          */
         ShaderProgram *AddShader(GLSL *shader) {
             glsl_list.push_back(shader->getName());
-            UniformsList.insert(shader->getUniformsList().begin(), shader->getUniformsList().end());
+            Sources.emplace_back(shader->getType(), shader->getSource());
             glAttachShader(shader_program_id, shader->getShaderID());
             return this;
         }
@@ -69,38 +273,155 @@ namespace CEngine {
          */
         ShaderProgram *Link() {
             glLinkProgram(shader_program_id);
-            int success_flag = 0;
-            glGetProgramiv(shader_program_id, GL_LINK_STATUS, &success_flag);
-            if (success_flag == GL_FALSE) {
-                char info_log[512];
-                glGetProgramInfoLog(shader_program_id, 512, nullptr, info_log);
-                auto logger = LogE(TAG);
-                logger << "着色器链接错误! " << Name << " (";
-                for (const auto file: glsl_list) {
-                    logger << file << ", ";
-                }
-                logger << "\b\b) \n";
-                logger << "InfoLog: " << info_log;
+            if (!CheckLink()) {
                 delete this;
                 return nullptr;
             }
-            auto logger = LogS(TAG);
-            logger << "着色器链接成功: " << Name << " (";
-            for (const auto file: glsl_list) {
-                logger << file << ", ";
-            }
-            logger << "\b\b) ";
-            All_Instances[Name] = this;
+            if (Parent == nullptr) All_Instances.insert_or_assign(Name, Handle(this));
             return this;
         }
 
+        /**
+         * 获取着色器变体
+         * @remark 首次调用时以注入宏的源码异步编译并缓存，完成前IsReady为<code>false</code>（见GetReadyVariant）\n
+         * 变体不会注册到All_Instances，随原程序一同销毁
+         * @param flags 变体标志（VariantFlags按位或）
+         * @return 变体程序指针，flags为Variant_None时返回自身，无源码时返回<code>nullptr</code>
+         */
+        ShaderProgram *GetVariant(const unsigned int flags) {
+            if (Parent != nullptr) return Parent->GetVariant(Flags | flags);
+            if (flags == Variant_None) return this;
+            if (const auto it = Variants.find(flags); it != Variants.end()) return it->second;
+            auto &variant = Variants[flags];
+            if (Sources.empty()) return nullptr;
+            std::vector<std::string> defines;
+            if (flags & Variant_Instanced) defines.emplace_back("CE_INSTANCED");
+            if (flags & Variant_MultiDraw) defines.emplace_back("CE_MULTI_DRAW");
+            if (flags & Variant_OctahedralNormal) defines.emplace_back("CE_OCT_NORMAL");
+            const auto program = new ShaderProgram(std::format("{}#{}", Name, flags));
+            program->Parent = this;
+            program->Flags = flags;
+            program->glsl_list = glsl_list;
+            for (const auto &[type, source]: Sources)
+                program->Sources.emplace_back(type, GLSL::InjectDefines(source, defines));
+            variant = program->Build(true);
+            return variant;
+        }
+
+        /**
+         * 获取已就绪的着色器变体
+         * @remark 变体编译中或失败时返回<code>nullptr</code>，调用方可退回不使用变体的路径
+         * @param flags 变体标志（VariantFlags按位或）
+         */
+        ShaderProgram *GetReadyVariant(const unsigned int flags) {
+            const auto variant = GetVariant(flags);
+            return variant != nullptr && variant->IsReady() ? variant : nullptr;
+        }
+
+        /// @property Flags
+        unsigned int getVariantFlags() const { return Flags; }
+
+        /// @property State
+        BuildState getBuildState() const { return State; }
+
+        /// 是否已链接、可以使用
+        bool IsReady() const { return State == BuildState::Ready; }
+
         void Use() const {
-            glUseProgram(shader_program_id);
+            GLState::UseProgram(shader_program_id);
+        }
+
+        /**
+         * 获取Uniform地址
+         * @remark 查询链接时建立的表，不调用glGetUniformLocation
+         * @param name 名称（数组可省略[0]）
+         * @return 不存在时返回-1
+         */
+        int GetUniformLocation(const std::string_view name) const {
+            const auto it = Uniforms.find(name);
+            return it == Uniforms.end() ? -1 : it->second.Location;
+        }
+
+        /**
+         * 获取类型化的Uniform地址
+         * @remark 类型不符时输出警告并返回无效地址；sampler2D可使用int（纹理单元）
+         * @tparam T 值类型
+         * @param name 名称
+         */
+        template<typename T>
+        UniformLocation<T> GetUniform(const std::string_view name) const {
+            const auto it = Uniforms.find(name);
+            if (it == Uniforms.end()) return {};
+            constexpr auto type = ShaderUniformVar::TypeOf<T>();
+            if (it->second.Type != type && !(type == ShaderUniformVar::Type::INT && it->second.Type == ShaderUniformVar::Type::SAMPLER2D)) {
+                LogW(TAG) << "Uniform类型不匹配: " << Name << "." << name << " (" << ShaderUniformVar::TypeToString(it->second.Type) << ")";
+                return {};
+            }
+            return {it->second.Location};
+        }
+
+        /**
+         * 批量解析Uniform地址
+         * @remark 结果以names的地址为键缓存在程序内，names须为静态存储；之后的调用不再进行字符串查找
+         * @param names 名称表
+         * @return 与names一一对应的地址，不存在为-1
+         */
+        const std::vector<int> &ResolveLocations(const std::span<const char *const> names) const {
+            auto &locations = LocationSets[names.data()];
+            if (locations.size() != names.size()) {
+                locations.resize(names.size());
+                for (std::size_t i = 0; i < names.size(); ++i)
+                    locations[i] = GetUniformLocation(names[i]);
+            }
+            return locations;
+        }
+
+        /**
+         * 批量解析Uniform块索引
+         * @remark 同ResolveLocations，names须为静态存储
+         * @param names 块名称表
+         * @return 与names一一对应的块索引，不存在为-1
+         */
+        const std::vector<int> &ResolveUniformBlocks(const std::span<const char *const> names) const {
+            auto &indices = BlockIndexSets[names.data()];
+            if (indices.size() != names.size()) {
+                indices.resize(names.size());
+                for (std::size_t i = 0; i < names.size(); ++i) {
+                    const auto block = GetUniformBlock(names[i]);
+                    indices[i] = block == nullptr ? -1 : static_cast<int>(block->Index);
+                }
+            }
+            return indices;
+        }
+
+        /**
+         * 获取Uniform块信息
+         * @param name 块名称
+         * @return 不存在时返回<code>nullptr</code>
+         */
+        const BlockInfo *GetUniformBlock(const std::string &name) const {
+            const auto it = UniformBlocks.find(name);
+            return it == UniformBlocks.end() ? nullptr : &it->second;
+        }
+
+        /**
+         * 获取SSBO块信息
+         * @param name 块名称
+         * @return 不存在时返回<code>nullptr</code>
+         */
+        const BlockInfo *GetStorageBlock(const std::string &name) const {
+            const auto it = StorageBlocks.find(name);
+            return it == StorageBlocks.end() ? nullptr : &it->second;
+        }
+
+        template<typename T>
+        void SetUniform(const UniformLocation<T> &uniform, const T &value) {
+            SetUniform(uniform.Location, value);
         }
 
         template<typename T>
         void SetUniform(const char *name, const T &value) {
-            SetUniform(glGetUniformLocation(shader_program_id, name), value);
+            SetUniform(GetUniformLocation(name), value);
         }
 
         template<typename T>
@@ -137,7 +458,7 @@ namespace CEngine {
 
         template<typename T>
         void SetUniform(const char *name, const T &value_x, const T &value_y) {
-            SetUniform(glGetUniformLocation(shader_program_id, name), value_x, value_y);
+            SetUniform(GetUniformLocation(name), value_x, value_y);
         }
 
         template<typename T>
@@ -156,7 +477,7 @@ namespace CEngine {
 
         template<typename T>
         void SetUniform(const char *name, const T &value_x, const T &value_y, const T &value_z) {
-            SetUniform(glGetUniformLocation(shader_program_id, name), value_x, value_y, value_z);
+            SetUniform(GetUniformLocation(name), value_x, value_y, value_z);
         }
 
         template<typename T>
@@ -175,7 +496,7 @@ namespace CEngine {
 
         template<typename T>
         void SetUniform(const char *name, const T &value_x, const T &value_y, const T &value_z, const T &value_w) {
-            SetUniform(glGetUniformLocation(shader_program_id, name), value_x, value_y, value_z, value_w);
+            SetUniform(GetUniformLocation(name), value_x, value_y, value_z, value_w);
         }
 
         template<typename T>
@@ -193,27 +514,32 @@ namespace CEngine {
         }
 
         void SetShaderUniformVar(const char *name, ShaderUniformVar &uniform) {
+            SetShaderUniformVar(GetUniformLocation(name), uniform);
+        }
+
+        void SetShaderUniformVar(const int location, ShaderUniformVar &uniform) {
+            if (location < 0) return;
             if (const auto type = uniform.GetType(); type == ShaderUniformVar::Type::INT)
-                SetUniform(name, uniform.GetValue<int>());
+                SetUniform(location, uniform.GetValue<int>());
             else if (type == ShaderUniformVar::Type::UINT)
-                SetUniform(name, uniform.GetValue<unsigned int>());
+                SetUniform(location, uniform.GetValue<unsigned int>());
             else if (type == ShaderUniformVar::Type::FLOAT)
-                SetUniform(name, uniform.GetValue<float>());
+                SetUniform(location, uniform.GetValue<float>());
             else if (type == ShaderUniformVar::Type::DOUBLE)
-                SetUniform(name, uniform.GetValue<double>());
+                SetUniform(location, uniform.GetValue<double>());
             else if (type == ShaderUniformVar::Type::VEC2)
-                SetUniform(name, uniform.GetValue<glm::vec2>());
+                SetUniform(location, uniform.GetValue<glm::vec2>());
             else if (type == ShaderUniformVar::Type::VEC3)
-                SetUniform(name, uniform.GetValue<glm::vec3>());
+                SetUniform(location, uniform.GetValue<glm::vec3>());
             else if (type == ShaderUniformVar::Type::VEC4)
-                SetUniform(name, uniform.GetValue<glm::vec4>());
+                SetUniform(location, uniform.GetValue<glm::vec4>());
             else if (type == ShaderUniformVar::Type::MAT3)
-                SetUniform(name, uniform.GetValue<glm::mat3>());
+                SetUniform(location, uniform.GetValue<glm::mat3>());
             else if (type == ShaderUniformVar::Type::MAT4)
-                SetUniform(name, uniform.GetValue<glm::mat4>());
+                SetUniform(location, uniform.GetValue<glm::mat4>());
             else if (type == ShaderUniformVar::Type::SAMPLER2D) {
                 if (const auto tex = uniform.GetValue<Texture *>(); tex != nullptr)
-                    SetUniform(name, tex->Use());
+                    SetUniform(location, tex->Use());
             }
         }
 
@@ -225,25 +551,322 @@ namespace CEngine {
         /// @property UniformsList
         std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > &getUniformsList() { return UniformsList; }
 
+        /// @property Uniforms
+        const UniformMap &getUniforms() const { return Uniforms; }
+
+        /// @property UniformBlocks
+        const std::unordered_map<std::string, BlockInfo> &getUniformBlocks() const { return UniformBlocks; }
+
+        /// @property StorageBlocks
+        const std::unordered_map<std::string, BlockInfo> &getStorageBlocks() const { return StorageBlocks; }
+
+        /// @property UniformOwner
+        const void *getUniformOwner() const { return UniformOwner; }
+
+        /// @property UniformOwner
+        void setUniformOwner(const void *owner) { UniformOwner = owner; }
+
     private:
         ShaderProgram() : ShaderProgram(Utils::GenerateUUID()) {
         }
 
+        /// 从All_Instances移除自身（同名条目已指向其他程序时保留，已失效的条目一并移除）
+        void Unregister() const {
+            if (const auto it = All_Instances.find(Name); it != All_Instances.end()) {
+                if (const auto program = it->second.Get(); program == nullptr || program == this) All_Instances.erase(it);
+            }
+        }
+
         explicit ShaderProgram(const std::string &name) {
             shader_program_id = glCreateProgram();
             Name = name;
         }
 
+        /// 程序二进制缓存格式版本，格式变化时递增以使旧缓存失效
+        static constexpr std::uint32_t ProgramBinaryVersion = 1;
+
+        /// 程序二进制缓存文件头
+        struct ProgramBinaryHeader {
+            char Magic[4] = {'C', 'E', 'P', 'B'};
+            std::uint32_t Version = ProgramBinaryVersion;
+            std::uint32_t Format = 0;
+            std::uint32_t Size = 0;
+        };
+
+        /// GL_COMPLETION_STATUS_KHR（GLAD未生成并行编译扩展）
+        static constexpr GLenum CompletionStatus = 0x91B1;
+
+        using MaxShaderCompilerThreadsProc = void (APIENTRY *)(GLuint count);
+
+        /**
+         * 由Sources构建程序
+         * @remark 优先加载程序二进制缓存，否则提交所有阶段的编译与链接；\n
+         * 同步构建立即取得结果（失败时销毁自身），异步构建加入PendingPrograms
+         * @param async 是否异步
+         * @return 同步构建失败返回<code>nullptr</code>
+         */
+        ShaderProgram *Build(const bool async) {
+            const bool use_cache = IsBinaryCacheEnabled();
+            CachePath = use_cache ? GetBinaryCachePath() : std::filesystem::path();
+            if (use_cache && LoadBinary(CachePath)) {
+                LogS(TAG) << "着色器程序从二进制缓存加载: " << Name;
+                CachePath.clear();
+                Reflect();
+                if (Parent == nullptr) All_Instances.insert_or_assign(Name, Handle(this));
+                return this;
+            }
+            // 先提交全部编译再链接，中间不查询状态，驱动可并行处理
+            for (const auto &[type, source]: Sources) {
+                auto glsl = GLSL::Submit(source, type, Name.c_str());
+                glAttachShader(shader_program_id, glsl->getShaderID());
+                PendingShaders.push_back(std::move(glsl));
+            }
+            if (use_cache) glProgramParameteri(shader_program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            glLinkProgram(shader_program_id);
+            if (!async) {
+                if (Finish()) return this;
+                delete this;
+                return nullptr;
+            }
+            State = BuildState::Pending;
+            if (Parent == nullptr) All_Instances.insert_or_assign(Name, Handle(this));
+            PendingPrograms.push_back(Handle(this));
+            return this;
+        }
+
+        /// 编译与链接是否已完成（不等待；并行编译不可用时总是<code>true</code>）
+        bool IsCompletionReady() const {
+            if (!ParallelCompileAvailable) return true;
+            GLint done = GL_FALSE;
+            glGetProgramiv(shader_program_id, CompletionStatus, &done);
+            return done == GL_TRUE;
+        }
+
+        /**
+         * 取得编译与链接结果
+         * @remark 未完成时等待；成功后反射并写入程序二进制缓存
+         * @return 是否成功
+         */
+        bool Finish() {
+            bool compiled = true;
+            for (const auto &glsl: PendingShaders)
+                compiled = glsl->CheckCompile() && compiled;
+            const bool linked = compiled && CheckLink();
+            for (const auto &glsl: PendingShaders)
+                glDetachShader(shader_program_id, glsl->getShaderID());
+            PendingShaders.clear();
+            if (!linked) {
+                State = BuildState::Failed;
+                if (Parent == nullptr) Unregister();
+                return false;
+            }
+            if (!CachePath.empty()) SaveBinary(CachePath);
+            CachePath.clear();
+            State = BuildState::Ready;
+            if (Parent == nullptr) All_Instances.insert_or_assign(Name, Handle(this));
+            return true;
+        }
+
+        /**
+         * 检查链接结果
+         * @remark 输出日志，成功时反射
+         * @return 是否链接成功
+         */
+        bool CheckLink() {
+            int success_flag = 0;
+            glGetProgramiv(shader_program_id, GL_LINK_STATUS, &success_flag);
+            if (success_flag == GL_FALSE) {
+                char info_log[512];
+                glGetProgramInfoLog(shader_program_id, 512, nullptr, info_log);
+                auto logger = LogE(TAG);
+                logger << "着色器链接错误! " << Name << " (";
+                for (const auto file: glsl_list) {
+                    logger << file << ", ";
+                }
+                logger << "\b\b) \n";
+                logger << "InfoLog: " << info_log;
+                return false;
+            }
+            auto logger = LogS(TAG);
+            logger << "着色器链接成功: " << Name << " (";
+            for (const auto file: glsl_list) {
+                logger << file << ", ";
+            }
+            logger << "\b\b) ";
+            Reflect();
+            return true;
+        }
+
+        /// 缓存文件路径（以源码与驱动标识的哈希命名）
+        std::filesystem::path GetBinaryCachePath() const {
+            static const std::string driver = [] {
+                const auto renderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+                const auto version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+                return std::format("{}\n{}", renderer != nullptr ? renderer : "", version != nullptr ? version : "");
+            }();
+            Hasher hasher;
+            hasher.UpdateValue(ProgramBinaryVersion).Update(driver);
+            for (const auto &[type, source]: Sources)
+                hasher.UpdateValue(type).UpdateValue(source.size()).Update(source);
+            return BinaryCacheDirectory / (hasher.Finish().ToString() + ".ceprog");
+        }
+
+        /**
+         * 加载程序二进制
+         * @remark 驱动拒绝时删除缓存文件并重建程序对象，之后可从源码链接
+         * @return 是否成功链接
+         */
+        bool LoadBinary(const std::filesystem::path &path) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) return false;
+            ProgramBinaryHeader header;
+            in.read(reinterpret_cast<char *>(&header), sizeof(header));
+            if (!in || std::memcmp(header.Magic, ProgramBinaryHeader{}.Magic, sizeof(header.Magic)) != 0 || header.Version != ProgramBinaryVersion)
+                return false;
+            std::vector<char> binary(header.Size);
+            in.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+            if (!in) return false;
+            in.close();
+            glProgramBinary(shader_program_id, header.Format, binary.data(), static_cast<GLsizei>(binary.size()));
+            int success_flag = 0;
+            glGetProgramiv(shader_program_id, GL_LINK_STATUS, &success_flag);
+            if (success_flag == GL_TRUE) return true;
+            LogW(TAG) << "驱动拒绝程序二进制缓存，重新编译: " << Name;
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            GLState::DeleteProgram(shader_program_id);
+            shader_program_id = glCreateProgram();
+            return false;
+        }
+
+        /**
+         * 写入程序二进制
+         * @remark 先写入临时文件再重命名，写入中途失败不会留下损坏的缓存
+         */
+        void SaveBinary(const std::filesystem::path &path) const {
+            GLint length = 0;
+            glGetProgramiv(shader_program_id, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length <= 0) return;
+            std::vector<char> binary(length);
+            ProgramBinaryHeader header;
+            GLenum format = 0;
+            glGetProgramBinary(shader_program_id, length, &length, &format, binary.data());
+            header.Format = format;
+            header.Size = static_cast<std::uint32_t>(length);
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            auto temp = path;
+            temp += ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                out.write(binary.data(), length);
+                if (!out) {
+                    LogW(TAG) << "程序二进制缓存写入失败: " << temp.string();
+                    out.close();
+                    std::filesystem::remove(temp, ec);
+                    return;
+                }
+            }
+            std::filesystem::rename(temp, path, ec);
+            if (ec) std::filesystem::remove(temp, ec);
+        }
+
+        /**
+         * 反射已链接的程序
+         * @remark 通过glGetProgramResource*枚举Uniform、Uniform块与SSBO，建立地址/类型表
+         */
+        void Reflect() {
+            Uniforms.clear();
+            UniformBlocks.clear();
+            StorageBlocks.clear();
+            UniformsList.clear();
+            LocationSets.clear();
+            BlockIndexSets.clear();
+            UniformOwner = nullptr;
+
+            GLint count = 0, max_length = 0;
+            glGetProgramInterfaceiv(shader_program_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+            glGetProgramInterfaceiv(shader_program_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_length);
+            std::string buffer(std::max(max_length, 1), '\0');
+            constexpr GLenum uniform_props[] = {GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX};
+            for (GLint i = 0; i < count; ++i) {
+                GLint values[4];
+                glGetProgramResourceiv(shader_program_id, GL_UNIFORM, i, 4, uniform_props, 4, nullptr, values);
+                if (values[3] != -1) continue; // 块成员没有地址
+                GLsizei length = 0;
+                glGetProgramResourceName(shader_program_id, GL_UNIFORM, i, max_length, &length, buffer.data());
+                std::string name(buffer.data(), length);
+                if (name.ends_with("[0]")) name.resize(name.size() - 3);
+                const auto type = ShaderUniformVar::FromGLType(values[0]);
+                Uniforms.insert_or_assign(name, UniformInfo{values[1], type, static_cast<GLenum>(values[0]), values[2]});
+                if (type != ShaderUniformVar::Type::UNKNOWN) UniformsList.insert({type, std::move(name)});
+            }
+            ReflectBlocks(GL_UNIFORM_BLOCK, UniformBlocks);
+            ReflectBlocks(GL_SHADER_STORAGE_BLOCK, StorageBlocks);
+        }
+
+        void ReflectBlocks(const GLenum interface, std::unordered_map<std::string, BlockInfo> &blocks) const {
+            GLint count = 0, max_length = 0;
+            glGetProgramInterfaceiv(shader_program_id, interface, GL_ACTIVE_RESOURCES, &count);
+            glGetProgramInterfaceiv(shader_program_id, interface, GL_MAX_NAME_LENGTH, &max_length);
+            std::string buffer(std::max(max_length, 1), '\0');
+            constexpr GLenum block_props[] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+            for (GLint i = 0; i < count; ++i) {
+                GLint values[2];
+                glGetProgramResourceiv(shader_program_id, interface, i, 2, block_props, 2, nullptr, values);
+                GLsizei length = 0;
+                glGetProgramResourceName(shader_program_id, interface, i, max_length, &length, buffer.data());
+                blocks.insert_or_assign(std::string(buffer.data(), length), BlockInfo{static_cast<unsigned int>(i), values[0], values[1]});
+            }
+        }
+
         /// @brief 着色器程序ID
         unsigned int shader_program_id = 0;
         /// @brief 用于通过All_Instances调用的key
         std::string Name;
-        /// @brief UniformsList
+        /// @brief UniformsList（由反射生成，供编辑器使用）
         std::unordered_set<std::pair<ShaderUniformVar::Type, std::string> > UniformsList;
+        /// @brief 反射得到的Uniform表（不含块成员）
+        UniformMap Uniforms;
+        /// @brief 反射得到的Uniform块
+        std::unordered_map<std::string, BlockInfo> UniformBlocks;
+        /// @brief 反射得到的SSBO
+        std::unordered_map<std::string, BlockInfo> StorageBlocks;
+        /// @brief ResolveLocations的缓存（名称表地址 -> 地址表）
+        mutable std::unordered_map<const void *, std::vector<int> > LocationSets;
+        /// @brief ResolveUniformBlocks的缓存
+        mutable std::unordered_map<const void *, std::vector<int> > BlockIndexSets;
+        /// @brief 上一次向该程序上传覆盖Uniform的对象（UniformOverrides）
+        const void *UniformOwner = nullptr;
         /// @brief 该着色器程序所链接的GLSL，仅用于调试输出
         std::vector<std::string> glsl_list;
+        /// @brief 各阶段源码（用于编译变体）
+        std::vector<std::pair<GLSL::ShaderType, std::string> > Sources;
+        /// @brief 已编译的变体
+        std::unordered_map<unsigned int, ShaderProgram *> Variants;
+        /// @brief 变体所属的原程序（原程序为空）
+        ShaderProgram *Parent = nullptr;
+        /// @brief 变体标志
+        unsigned int Flags = Variant_None;
+
+        /// @brief 构建状态
+        BuildState State = BuildState::Ready;
+        /// @brief 编译中的各阶段（异步构建完成前）
+        std::vector<std::shared_ptr<GLSL> > PendingShaders;
+        /// @brief 完成后写入的程序二进制缓存路径（不写入时为空）
+        std::filesystem::path CachePath;
+
+        static bool BinaryCacheEnabled;
+        static std::filesystem::path BinaryCacheDirectory;
+        static bool ParallelCompileAvailable;
+        static std::vector<Handle<ShaderProgram> > PendingPrograms;
     };
 
     const char *ShaderProgram::TAG = "ShaderProgram";
-    std::unordered_map<std::string, ShaderProgram *> ShaderProgram::All_Instances;
+    std::unordered_map<std::string, Handle<ShaderProgram> > ShaderProgram::All_Instances;
+    bool ShaderProgram::BinaryCacheEnabled = true;
+    std::filesystem::path ShaderProgram::BinaryCacheDirectory = "Cache/Shaders";
+    bool ShaderProgram::ParallelCompileAvailable = false;
+    std::vector<Handle<ShaderProgram> > ShaderProgram::PendingPrograms;
 }
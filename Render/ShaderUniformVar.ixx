@@ -7,6 +7,7 @@
  */
 
 module;
+#include <glad/glad.h>
 #include <glm/glm.hpp>
 export module CEngine.Render:ShaderUniformVar;
 import :Texture;
@@ -36,6 +37,28 @@ namespace CEngine {
         static Type StringToType(const std::string &str);
         static const char *TypeToString(const Type &type);
 
+        /**
+         * OpenGL类型转换为Type
+         * @param gl_type glGetProgramResourceiv(GL_TYPE)的结果
+         */
+        static Type FromGLType(GLenum gl_type);
+
+        /// C++类型对应的Type
+        template<typename T>
+        static constexpr Type TypeOf() {
+            if constexpr (std::is_same_v<T, int>) return Type::INT;
+            else if constexpr (std::is_same_v<T, unsigned int>) return Type::UINT;
+            else if constexpr (std::is_same_v<T, float>) return Type::FLOAT;
+            else if constexpr (std::is_same_v<T, double>) return Type::DOUBLE;
+            else if constexpr (std::is_same_v<T, glm::vec2>) return Type::VEC2;
+            else if constexpr (std::is_same_v<T, glm::vec3>) return Type::VEC3;
+            else if constexpr (std::is_same_v<T, glm::vec4>) return Type::VEC4;
+            else if constexpr (std::is_same_v<T, glm::mat3>) return Type::MAT3;
+            else if constexpr (std::is_same_v<T, glm::mat4>) return Type::MAT4;
+            else if constexpr (std::is_same_v<T, Texture *>) return Type::SAMPLER2D;
+            else return Type::UNKNOWN;
+        }
+
         ShaderUniformVar(const ShaderUniformVar &) = default;
         ShaderUniformVar &operator=(const ShaderUniformVar &) = default;
         ShaderUniformVar(ShaderUniformVar &&) = default;
@@ -109,6 +132,22 @@ namespace CEngine {
         return Type::UNKNOWN;
     }
 
+    ShaderUniformVar::Type ShaderUniformVar::FromGLType(const GLenum gl_type) {
+        switch (gl_type) {
+            case GL_INT: return Type::INT;
+            case GL_UNSIGNED_INT: return Type::UINT;
+            case GL_FLOAT: return Type::FLOAT;
+            case GL_DOUBLE: return Type::DOUBLE;
+            case GL_FLOAT_VEC2: return Type::VEC2;
+            case GL_FLOAT_VEC3: return Type::VEC3;
+            case GL_FLOAT_VEC4: return Type::VEC4;
+            case GL_FLOAT_MAT3: return Type::MAT3;
+            case GL_FLOAT_MAT4: return Type::MAT4;
+            case GL_SAMPLER_2D: return Type::SAMPLER2D;
+            default: return Type::UNKNOWN;
+        }
+    }
+
     const char *ShaderUniformVar::TypeToString(const Type &type) {
         switch (type) {
             case Type::INT: return "int";
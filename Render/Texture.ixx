@@ -10,79 +10,267 @@ module;
 #include <glad/glad.h>
 
 #include <utility>
-#include "md5.hpp"
+
+#include "Utils/Profiler.h"
+
+// S3TC不在核心规范中，glad未生成其常量
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
 export module CEngine.Render:Texture;
+import :GLState;
+import :TextureAtlas;
 import std;
 import CEngine.Base;
+import CEngine.Hash;
 import CEngine.Image;
 import CEngine.Logger;
+import CEngine.ThreadPool;
 import CEngine.Utils;
+import CEngine.Profiler;
 
 namespace CEngine {
     export class Texture final : public Object {
     public:
         static const char *TAG;
-        static std::unordered_map<std::string, Texture *> All_Instances;
+        static std::unordered_map<Hash128, Handle<Texture>, Hash128Hasher> All_Instances;
+
+        /**
+         * 检测块压缩格式的支持情况
+         * @remark 需在OpenGL上下文创建后调用；BC4/BC5/BC7为核心功能，BC1/BC3需要GL_EXT_texture_compression_s3tc
+         */
+        static void DetectCompressionSupport() {
+            int count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            bool s3tc = false;
+            for (int i = 0; i < count && !s3tc; ++i)
+                s3tc = std::string_view(reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i))) == "GL_EXT_texture_compression_s3tc";
+            BlockCompressor::SetS3TCAvailable(s3tc);
+            LogI(TAG) << "S3TC纹理压缩" << (s3tc ? "可用" : "不可用，RGB纹理改用BC7");
+#ifndef NDEBUG
+            // 调试构建中校验块压缩编码器
+            BlockCompressor::SelfTest();
+#endif
+        }
 
         /// 重置纹理槽，需要在每次DrawCall后调用
         static void ResetTextureSlot() {
             CurrentTextureSlot = 0;
         }
 
-        static Texture *Create(const ImageBuffer &img) {
-            // 计算MD5
-            const auto _md5 = md5::digestString(img.GetBuffer(), img.GetHeight() * img.GetWidth());
-            if (All_Instances.contains(_md5)) return All_Instances[_md5];
-            // 上传GPU
-            unsigned int id = 0;
-            glGenTextures(1, &id);
-            glBindTexture(GL_TEXTURE_2D, id);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            int internalFormat = GL_RGBA8;
-            int dataFormat = GL_RGBA;
-            switch (img.GetColorMode()) {
-                case ColorMode::GRAY:
-                    internalFormat = GL_R8;
-                    dataFormat = GL_RED;
-                    break;
-                case ColorMode::GRAY_A:
-                    internalFormat = GL_RG8;
-                    dataFormat = GL_RG;
-                    break;
-                case ColorMode::RGB:
-                    internalFormat = GL_RGB8;
-                    dataFormat = GL_RGB;
-                    break;
-                case ColorMode::RGBA:
-                    internalFormat = GL_RGBA8;
-                    dataFormat = GL_RGBA;
-                    break;
-                default: break;
+        /// 当前已占用的纹理槽数量
+        static int GetUsedTextureSlots() {
+            return CurrentTextureSlot;
+        }
+
+        /// 回退纹理槽（之后的纹理从该槽开始绑定）
+        static void SetUsedTextureSlots(const int slots) {
+            CurrentTextureSlot = slots;
+        }
+
+        /**
+         * 创建纹理
+         * @remark 启用BlockCompressor时按用途压缩为BCn格式（放入图集的纹理除外）
+         * @param img 图片
+         * @param allow_atlas 允许放入纹理图集（需启用TextureAtlas，放入后只能通过图集采样）
+         * @param usage 用途（决定压缩格式）
+         */
+        static Texture *Create(const ImageBuffer &img, const bool allow_atlas = false, const TextureUsage usage = TextureUsage::Color) {
+            CE_PROFILE_ZONE("Texture::Create");
+            // 内容哈希在解码时已计算
+            const bool compress = ShouldCompress(allow_atlas);
+            const bool use_atlas = allow_atlas && TextureAtlas::Accepts(img.GetWidth(), img.GetHeight());
+            const auto key = MakeKey(img.GetHash(), compress && !use_atlas, usage, use_atlas);
+            if (const auto tex = FindInstance(key)) return tex;
+            if (use_atlas) {
+                if (const auto region = TextureAtlas::Allocate(img.GetBuffer(), img.GetWidth(), img.GetHeight(),
+                                                               ColorMode_GetChannelCount(img.GetColorMode()))) {
+                    auto tex = new Texture(0, key, GL_RGBA8, GL_RGBA, img.GetWidth(), img.GetHeight());
+                    tex->AtlasRegion = region;
+                    All_Instances.insert_or_assign(key, Handle(tex));
+                    return tex;
+                }
+                LogW(TAG) << "纹理图集分配失败，使用独立纹理";
             }
-            // internalFormat = GL_RGB;
-            // dataFormat = GL_RGB;
+            if (compress) {
+                const auto cooked = CookedTexture::FromImage(img, BlockCompressor::ChooseEncoding(ColorMode_GetChannelCount(img.GetColorMode()), usage));
+                return Create(cooked, img.GetHash(), false, usage);
+            }
+            // 上传GPU
+            const auto [internalFormat, dataFormat] = GetFormats(img.GetColorMode());
+            const auto id = NewTextureObject(true);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
             glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, static_cast<GLsizei>(img.GetWidth()), static_cast<GLsizei>(img.GetHeight()), 0, dataFormat,
                          GL_UNSIGNED_BYTE, img.GetBuffer());
-            glBindTexture(GL_TEXTURE_2D, 0);
-            auto tex = new Texture(id, _md5, internalFormat, dataFormat, img.GetWidth(), img.GetHeight());
-            All_Instances.emplace(_md5, tex);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            auto tex = new Texture(id, key, internalFormat, dataFormat, img.GetWidth(), img.GetHeight());
+            All_Instances.insert_or_assign(key, Handle(tex));
+            return tex;
+        }
+
+        /**
+         * 由烘焙后的纹理创建
+         * @remark 按级上传预先生成的Mip链，压缩格式以glCompressedTexSubImage2D上传
+         * @param cooked 烘焙后的纹理
+         * @param content 内容哈希（源文件或图片数据）
+         * @param allow_atlas 允许放入纹理图集（仅未压缩的纹理，使用第0级）
+         * @param usage 用途（参与纹理标识）
+         */
+        static Texture *Create(const CookedTexture &cooked, const Hash128 &content, const bool allow_atlas = false,
+                               const TextureUsage usage = TextureUsage::Color) {
+            CE_PROFILE_ZONE("Texture::Create");
+            const bool use_atlas = allow_atlas && !cooked.IsCompressed() && TextureAtlas::Accepts(cooked.GetWidth(), cooked.GetHeight());
+            const auto key = MakeKey(content, cooked.IsCompressed(), usage, use_atlas);
+            if (const auto tex = FindInstance(key)) return tex;
+            if (use_atlas) {
+                if (const auto region = TextureAtlas::Allocate(cooked.GetLevelData(0), cooked.GetWidth(), cooked.GetHeight(),
+                                                               static_cast<int>(cooked.GetChannels()))) {
+                    auto tex = new Texture(0, key, GL_RGBA8, GL_RGBA, cooked.GetWidth(), cooked.GetHeight());
+                    tex->AtlasRegion = region;
+                    All_Instances.insert_or_assign(key, Handle(tex));
+                    return tex;
+                }
+                LogW(TAG) << "纹理图集分配失败，使用独立纹理";
+            }
+            const auto [internalFormat, dataFormat] = GetFormats(cooked);
+            const auto id = NewTextureObject(cooked.GetLevels().size() > 1);
+            SetChannelSwizzle(cooked, usage);
+            UploadLevels(cooked, internalFormat, dataFormat, cooked.GetData());
+            auto tex = new Texture(id, key, internalFormat, dataFormat, cooked.GetWidth(), cooked.GetHeight());
+            All_Instances.insert_or_assign(key, Handle(tex));
             return tex;
         }
 
-        static Texture *FromFile(const char *img_path) {
+        /**
+         * 从文件加载纹理
+         * @remark 启用TextureCooker时映射缓存中的.cetex文件（不存在则先烘焙），否则解码图片后创建
+         * @param img_path 图片路径
+         * @param allow_atlas 允许放入纹理图集
+         * @param usage 用途（决定压缩格式）
+         */
+        static Texture *FromFile(const char *img_path, const bool allow_atlas = false, const TextureUsage usage = TextureUsage::Color) {
             if (!Utils::FileExists(img_path)) {
                 LogE(TAG) << "文件不存在: " << img_path;
                 return nullptr;
             }
+            // 记录首次加载的源文件
+            const auto named = [img_path](Texture *tex) {
+                if (tex != nullptr && tex->Name.empty()) tex->Name = img_path;
+                return tex;
+            };
+            if (TextureCooker::IsEnabled()) {
+                if (const auto hash = TextureCooker::HashFile(img_path)) {
+                    const bool compress = ShouldCompress(allow_atlas);
+                    // 已加载过相同内容的文件时无需映射
+                    if (const auto tex = FindInstance(MakeKey(*hash, compress, usage, allow_atlas && !compress))) return named(tex);
+                    if (const auto cooked = TextureCooker::Load(img_path, *hash, compress, usage))
+                        return named(Create(*cooked, *hash, allow_atlas, usage));
+                }
+            }
             const auto img = ImageBuffer(img_path);
-            return Create(img);
+            return named(Create(img, allow_atlas, usage));
+        }
+
+        /**
+         * 异步加载纹理
+         * @remark 解码（或映射烘焙缓存）与内容哈希在线程池中进行，完成后由<code>ProcessUploads</code>经PBO上传；\n
+         * 返回的纹理立即可用，上传栅栏触发之前绑定的是1x1的白色占位纹理（<code>IsReady</code>为false）；\n
+         * 同一路径只会加载一次；解码后内容与已有纹理相同时不再上传，返回的纹理改为指向已有纹理
+         * @param img_path 图片路径
+         * @param allow_atlas 允许放入纹理图集
+         * @param usage 用途（决定压缩格式）
+         * @return 文件不存在返回<code>nullptr</code>
+         */
+        static Texture *FromFileAsync(const char *img_path, const bool allow_atlas = false, const TextureUsage usage = TextureUsage::Color) {
+            if (!Utils::FileExists(img_path)) {
+                LogE(TAG) << "文件不存在: " << img_path;
+                return nullptr;
+            }
+            const auto key = Hasher(LoadingKeySeed).Update(std::string_view(img_path)).Finish();
+            if (const auto tex = FindInstance(key)) return tex;
+            auto tex = new Texture(GetPlaceholder(), key, GL_RGBA8, GL_RGBA, 1, 1);
+            tex->Name = img_path;
+            tex->Ready = false;
+            All_Instances.insert_or_assign(key, Handle(tex));
+            ++PendingDecodes;
+            const bool compress = ShouldCompress(allow_atlas);
+            ThreadPool::Global().Submit([target = Handle(tex), path = std::string(img_path), allow_atlas, compress, usage] {
+                CookedTexture cooked;
+                Hash128 content;
+                if (TextureCooker::IsEnabled()) {
+                    if (const auto hash = TextureCooker::HashFile(path)) {
+                        content = *hash;
+                        if (auto loaded = TextureCooker::Load(path, *hash, compress, usage)) cooked = std::move(*loaded);
+                    }
+                } else if (const ImageBuffer img(path.c_str()); img.IsValid()) {
+                    content = img.GetHash();
+                    cooked = CookedTexture::FromImage(img, compress
+                                                               ? BlockCompressor::ChooseEncoding(ColorMode_GetChannelCount(img.GetColorMode()), usage)
+                                                               : BlockEncoding{});
+                }
+                std::lock_guard lock(DecodedMutex);
+                Decoded.push_back({target, std::move(cooked), content, path, allow_atlas, usage});
+            });
+            return tex;
+        }
+
+        /**
+         * 处理异步纹理的上传
+         * @remark 在渲染线程每帧调用一次：先检查已提交上传的栅栏，触发的纹理切换为真实纹理；\n
+         * 再在时间预算内把解码完成的图片写入PBO并逐级提交glTexSubImage2D（每帧至少处理一张）
+         * @param budget_ms 每帧上传的时间预算（毫秒）
+         */
+        static void ProcessUploads(const double budget_ms) {
+            // 栅栏已触发的上传
+            std::erase_if(Uploads, [](const PendingUpload &upload) {
+                if (glClientWaitSync(upload.Fence, 0, 0) == GL_TIMEOUT_EXPIRED) return false;
+                glDeleteSync(upload.Fence);
+                GLState::DeleteBuffer(upload.PBO);
+                if (const auto tex = upload.Target.Get(); tex != nullptr) {
+                    tex->TextureID = upload.TextureID;
+                    tex->Ready = true;
+                } else GLState::DeleteTexture(upload.TextureID);
+                return true;
+            });
+            // 解码完成的图片
+            const auto start = std::chrono::steady_clock::now();
+            bool first = true;
+            while (first || std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < budget_ms) {
+                DecodedImage decoded;
+                {
+                    std::lock_guard lock(DecodedMutex);
+                    if (Decoded.empty()) break;
+                    decoded = std::move(Decoded.front());
+                    Decoded.pop_front();
+                }
+                --PendingDecodes;
+                first = false;
+                Stage(decoded);
+            }
+        }
+
+        /// 尚未完成（解码或上传中）的异步纹理数
+        static std::size_t GetPendingUploads() {
+            return PendingDecodes + Uploads.size();
+        }
+
+        /**
+         * 释放异步上传的GPU资源
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        static void ReleaseUploads() {
+            for (const auto &upload: Uploads) {
+                glDeleteSync(upload.Fence);
+                GLState::DeleteBuffer(upload.PBO);
+                GLState::DeleteTexture(upload.TextureID);
+            }
+            Uploads.clear();
+            if (PlaceholderID != 0) GLState::DeleteTexture(PlaceholderID);
+            PlaceholderID = 0;
         }
 
-        Texture(const unsigned int id, std::string _md5, const int internal_format, const int data_format, const unsigned int width, const unsigned int height)
-            : TextureID(id), InternalFormat(internal_format), DataFormat(data_format), Width(width), Height(height), Md5(std::move(_md5)) {
+        Texture(const unsigned int id, const Hash128 &key, const int internal_format, const int data_format, const unsigned int width, const unsigned int height)
+            : TextureID(id), InternalFormat(internal_format), DataFormat(data_format), Width(width), Height(height), Key(key) {
         }
 
         Texture(const Texture &) = delete;
@@ -91,53 +279,309 @@ namespace CEngine {
         Texture &operator=(Texture &tex) = delete;
 
         ~Texture() override {
-            glDeleteTextures(1, &TextureID);
-            All_Instances.erase(Md5);
+            if (TextureID != 0 && TextureID != PlaceholderID) GLState::DeleteTexture(TextureID);
+            // 只移除仍指向自身的条目（同一标识可能已登记了其他纹理）
+            EraseInstance(Key);
+            if (LoadingKey) EraseInstance(*LoadingKey);
         }
 
         int Use() const {
+            const auto &tex = Resolve();
+            if (tex.AtlasRegion) {
+                LogE(TAG) << "图集中的纹理不能单独绑定: " << Key.ToString();
+                return -1;
+            }
             if (CurrentTextureSlot > 15) {
                 LogE(TAG) << "当前纹理槽已满！";
                 return -1;
             }
-            glActiveTexture(GL_TEXTURE0 + CurrentTextureSlot);
-            glBindTexture(GL_TEXTURE_2D, TextureID);
+            GLState::BindTexture(CurrentTextureSlot, GL_TEXTURE_2D, tex.TextureID);
             return CurrentTextureSlot++;
         }
 
         static void UnUse() {
-            glBindTexture(GL_TEXTURE_2D, 0);
+            GLState::BindTexture(GL_TEXTURE_2D, 0);
         }
 
         /// @property TextureID
-        unsigned int getTextureID() const { return TextureID; }
+        unsigned int getTextureID() const { return Resolve().TextureID; }
 
         /// @property InternalFormat
-        int getInternalFormat() const { return InternalFormat; }
+        int getInternalFormat() const { return Resolve().InternalFormat; }
 
         /// @property DataFormat
-        int getDataFormat() const { return DataFormat; }
+        int getDataFormat() const { return Resolve().DataFormat; }
 
-        /// @property Md5
-        std::string getMd5() const { return Md5; }
+        /// @property Key
+        const Hash128 &getKey() const { return Key; }
+
+        /// @property Name 源文件路径（非从文件加载时为空）
+        const std::string &getName() const { return Name; }
+
+        /// 显示用的名称：有源文件时为其路径，否则为纹理标识
+        std::string GetDisplayName() const { return Name.empty() ? Key.ToString() : Name; }
 
         /// @property Width
-        unsigned int getWidth() const { return Width; }
+        unsigned int getWidth() const { return Resolve().Width; }
 
         /// @property Height
-        unsigned int getHeight() const { return Height; }
+        unsigned int getHeight() const { return Resolve().Height; }
+
+        /// 是否已上传完成（异步加载的纹理在此之前绑定占位纹理）
+        bool IsReady() const { return Resolve().Ready; }
+
+        /// 是否位于纹理图集中
+        bool IsInAtlas() const { return Resolve().AtlasRegion.has_value(); }
+
+        /// @property AtlasRegion
+        const std::optional<TextureAtlas::Region> &getAtlasRegion() const { return Resolve().AtlasRegion; }
+
+        /// 是否指向内容相同的已有纹理（本身不持有GPU资源）
+        bool IsAlias() const { return Source.Get() != nullptr; }
 
     private:
+        /// 解码完成、等待上传的图片
+        struct DecodedImage {
+            Handle<Texture> Target;
+            CookedTexture Image;
+            /// @brief 内容哈希
+            Hash128 Content;
+            std::string Path;
+            bool AllowAtlas = false;
+            TextureUsage Usage = TextureUsage::Color;
+        };
+
+        /// 已提交、等待栅栏的上传
+        struct PendingUpload {
+            Handle<Texture> Target;
+            unsigned int TextureID = 0;
+            unsigned int PBO = 0;
+            GLsync Fence = nullptr;
+        };
+
+        /// 加载中纹理的标识种子（以路径哈希）
+        static constexpr std::uint64_t LoadingKeySeed = 1;
+
+        /**
+         * 纹理标识
+         * @param content 内容哈希
+         * @param compressed 是否块压缩
+         * @param usage 用途
+         * @param atlas 是否位于图集中
+         */
+        static Hash128 MakeKey(const Hash128 &content, const bool compressed, const TextureUsage usage, const bool atlas) {
+            return Hasher().UpdateValue(content).UpdateValue(compressed).UpdateValue(usage).UpdateValue(atlas).Finish();
+        }
+
+        /// 是否块压缩（放入图集的纹理须保持RGBA8）
+        static bool ShouldCompress(const bool allow_atlas) {
+            return BlockCompressor::IsEnabled() && !(allow_atlas && TextureAtlas::IsEnabled());
+        }
+
+        /// 块压缩格式对应的GL内部格式
+        static int GetCompressedFormat(const BlockFormat format) {
+            switch (format) {
+                case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case BlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+                case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+                case BlockFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+                default: return 0;
+            }
+        }
+
+        /// 烘焙纹理的(内部格式, 数据格式)，压缩格式的数据格式与内部格式相同
+        static std::pair<int, int> GetFormats(const CookedTexture &cooked) {
+            if (cooked.IsCompressed()) {
+                const auto format = GetCompressedFormat(cooked.GetFormat());
+                return {format, format};
+            }
+            return GetFormats(cooked.GetColorMode());
+        }
+
+        static std::pair<int, int> GetFormats(const ColorMode mode) {
+            switch (mode) {
+                case ColorMode::GRAY: return {GL_R8, GL_RED};
+                case ColorMode::GRAY_A: return {GL_RG8, GL_RG};
+                case ColorMode::RGB: return {GL_RGB8, GL_RGB};
+                default: return {GL_RGBA8, GL_RGBA};
+            }
+        }
+
+        /**
+         * 创建纹理对象并设置参数（保持绑定）
+         * @param mipmapped 有Mip链时使用三线性过滤
+         */
+        static unsigned int NewTextureObject(const bool mipmapped) {
+            unsigned int id = 0;
+            glGenTextures(1, &id);
+            GLState::BindTexture(GL_TEXTURE_2D, id);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            return id;
+        }
+
+        /**
+         * BC4只有R通道，从G/B通道压缩而来时把R映射回原通道（纹理须已绑定）
+         * @remark 保证着色器取用的通道与未压缩、图集中的纹理一致，见TextureUsage
+         */
+        static void SetChannelSwizzle(const CookedTexture &cooked, const TextureUsage usage) {
+            if (cooked.GetFormat() != BlockFormat::BC4) return;
+            switch (BlockCompressor::ChooseEncoding(cooked.GetChannels(), usage).FirstChannel) {
+                case 1: glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+                    break;
+                case 2: glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+                    break;
+                default: break;
+            }
+        }
+
+        /**
+         * 分配不可变存储并逐级上传（纹理须已绑定）
+         * @param data 全部Mip数据的起始地址，绑定了PBO时为PBO中的偏移
+         */
+        static void UploadLevels(const CookedTexture &cooked, const int internal_format, const int data_format, const unsigned char *data) {
+            const auto &levels = cooked.GetLevels();
+            glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levels.size()), internal_format,
+                           static_cast<GLsizei>(cooked.GetWidth()), static_cast<GLsizei>(cooked.GetHeight()));
+            if (cooked.IsCompressed()) {
+                for (std::size_t i = 0; i < levels.size(); ++i)
+                    glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), 0, 0, static_cast<GLsizei>(levels[i].Width),
+                                              static_cast<GLsizei>(levels[i].Height), internal_format, static_cast<GLsizei>(levels[i].Size),
+                                              data + levels[i].Offset);
+                return;
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            for (std::size_t i = 0; i < levels.size(); ++i)
+                glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), 0, 0, static_cast<GLsizei>(levels[i].Width), static_cast<GLsizei>(levels[i].Height),
+                                data_format, GL_UNSIGNED_BYTE, data + levels[i].Offset);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+
+        static unsigned int GetPlaceholder() {
+            if (PlaceholderID == 0) {
+                constexpr unsigned char white[4] = {255, 255, 255, 255};
+                PlaceholderID = NewTextureObject(false);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+            }
+            return PlaceholderID;
+        }
+
+        /// 把解码完成的图片写入PBO并提交上传
+        static void Stage(DecodedImage &decoded) {
+            const auto tex = decoded.Target.Get();
+            if (tex == nullptr) return;
+            const auto &img = decoded.Image;
+            if (!img.IsValid()) {
+                // 保留加载中的标识，同一路径不再重复尝试
+                LogE(TAG) << "纹理加载失败: " << decoded.Path;
+                return;
+            }
+            const bool use_atlas = decoded.AllowAtlas && !img.IsCompressed() && TextureAtlas::Accepts(img.GetWidth(), img.GetHeight());
+            const auto key = MakeKey(decoded.Content, img.IsCompressed(), decoded.Usage, use_atlas);
+            // 与已有纹理内容相同时指向已有纹理，不再上传；保留路径标识，同一路径之后直接返回
+            if (const auto existing = FindInstance(key); existing != nullptr && existing != tex) {
+                tex->Source = existing;
+                return;
+            }
+            // 同时以路径与内容登记
+            tex->LoadingKey = tex->Key;
+            tex->Key = key;
+            All_Instances.insert_or_assign(tex->Key, decoded.Target);
+            tex->Width = img.GetWidth();
+            tex->Height = img.GetHeight();
+            if (use_atlas) {
+                // 图集以glTexSubImage3D写入已有存储，直接从内存上传
+                if (const auto region = TextureAtlas::Allocate(img.GetLevelData(0), img.GetWidth(), img.GetHeight(),
+                                                               static_cast<int>(img.GetChannels()))) {
+                    tex->TextureID = 0;
+                    tex->AtlasRegion = region;
+                    tex->Ready = true;
+                    return;
+                }
+                LogW(TAG) << "纹理图集分配失败，使用独立纹理";
+            }
+            const auto [internalFormat, dataFormat] = GetFormats(img);
+            tex->InternalFormat = internalFormat;
+            tex->DataFormat = dataFormat;
+            const auto size = static_cast<GLsizeiptr>(img.GetDataSize());
+            PendingUpload upload{decoded.Target};
+            glGenBuffers(1, &upload.PBO);
+            GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.PBO);
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_MAP_WRITE_BIT);
+            if (const auto mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) {
+                std::memcpy(mapped, img.GetData(), size);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
+            upload.TextureID = NewTextureObject(img.GetLevels().size() > 1);
+            SetChannelSwizzle(img, decoded.Usage);
+            UploadLevels(img, internalFormat, dataFormat, nullptr);
+            // 解除绑定，否则之后的同步上传会从PBO读取
+            GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            upload.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            Uploads.push_back(upload);
+        }
+
+        /**
+         * 查找存活的纹理
+         * @remark 句柄已失效（纹理已销毁）的条目随即移除
+         * @return 不存在或已销毁返回<code>nullptr</code>
+         */
+        static Texture *FindInstance(const Hash128 &key) {
+            const auto it = All_Instances.find(key);
+            if (it == All_Instances.end()) return nullptr;
+            if (const auto tex = it->second.Get(); tex != nullptr) return tex;
+            All_Instances.erase(it);
+            return nullptr;
+        }
+
+        /// 移除指向自身或已失效的条目
+        void EraseInstance(const Hash128 &key) const {
+            if (const auto it = All_Instances.find(key); it != All_Instances.end()) {
+                if (const auto tex = it->second.Get(); tex == nullptr || tex == this) All_Instances.erase(it);
+            }
+        }
+
+        /// 指向的已有纹理，已销毁或不是别名时为自身
+        const Texture &Resolve() const {
+            if (const auto source = Source.Get(); source != nullptr) return *source;
+            return *this;
+        }
+
         /// 记录纹理槽，需要在每次DrawCall后重置为零
         static int CurrentTextureSlot;
         unsigned int TextureID = 0;
         int InternalFormat = GL_RGBA8;
         int DataFormat = GL_RGBA;
         unsigned int Width, Height;
-        std::string Md5;
+        /// @brief 纹理标识（All_Instances的键）
+        Hash128 Key;
+        /// @brief 源文件路径
+        std::string Name;
+        /// @brief 图集中的区域（不在图集中为空）
+        std::optional<TextureAtlas::Region> AtlasRegion;
+        /// @brief 是否已上传完成
+        bool Ready = true;
+        /// @brief 异步加载的路径标识（同时登记于All_Instances）
+        std::optional<Hash128> LoadingKey;
+        /// @brief 内容相同的已有纹理（见Stage）
+        Handle<Texture> Source;
+
+        static std::mutex DecodedMutex;
+        static std::deque<DecodedImage> Decoded;
+        static std::vector<PendingUpload> Uploads;
+        static std::size_t PendingDecodes;
+        static unsigned int PlaceholderID;
     };
 
     const char *Texture::TAG = "Texture";
-    std::unordered_map<std::string, Texture *> Texture::All_Instances;
+    std::unordered_map<Hash128, Handle<Texture>, Hash128Hasher> Texture::All_Instances;
     int Texture::CurrentTextureSlot = 0;
+    std::mutex Texture::DecodedMutex;
+    std::deque<Texture::DecodedImage> Texture::Decoded;
+    std::vector<Texture::PendingUpload> Texture::Uploads;
+    std::size_t Texture::PendingDecodes = 0;
+    unsigned int Texture::PlaceholderID = 0;
 }
@@ -0,0 +1,241 @@
+/**
+ * @file TextureAtlas.ixx
+ * @brief 纹理图集
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+export module CEngine.Render:TextureAtlas;
+import :GLState;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /**
+     * @brief 货架式矩形装箱
+     * @remark 按行（货架）放置矩形，新矩形放入高度足够且剩余宽度足够的货架中浪费最少的一个，否则开新货架
+     */
+    export class ShelfPacker {
+    public:
+        ShelfPacker(const std::uint32_t width, const std::uint32_t height) : Width(width), Height(height) {
+        }
+
+        /**
+         * 放置矩形
+         * @param width 宽
+         * @param height 高
+         * @return 左上角坐标，空间不足返回<code>std::nullopt</code>
+         */
+        std::optional<std::pair<std::uint32_t, std::uint32_t> > Pack(const std::uint32_t width, const std::uint32_t height) {
+            if (width > Width || height > Height) return std::nullopt;
+            Shelf *best = nullptr;
+            for (auto &shelf: Shelves) {
+                if (shelf.Height < height || Width - shelf.X < width) continue;
+                if (best == nullptr || shelf.Height < best->Height) best = &shelf;
+            }
+            if (best == nullptr) {
+                if (Height - NextY < height) return std::nullopt;
+                Shelves.push_back({NextY, height, 0});
+                NextY += height;
+                best = &Shelves.back();
+            }
+            const std::pair position{best->X, best->Y};
+            best->X += width;
+            Used += static_cast<std::uint64_t>(width) * height;
+            return position;
+        }
+
+        /// 已使用面积占比
+        float GetOccupancy() const {
+            return static_cast<float>(static_cast<double>(Used) / (static_cast<double>(Width) * Height));
+        }
+
+    private:
+        struct Shelf {
+            std::uint32_t Y;
+            std::uint32_t Height;
+            std::uint32_t X;
+        };
+
+        std::uint32_t Width, Height;
+        std::uint32_t NextY = 0;
+        std::uint64_t Used = 0;
+        std::vector<Shelf> Shelves;
+    };
+
+    /**
+     * @brief 纹理图集
+     * @remark 启用后，小纹理统一转换为RGBA8并以货架装箱放入同一个GL_TEXTURE_2D_ARRAY的各层中，\n
+     * 材质通过层号与UV矩形引用纹理，所有材质共用一次绑定，可合并到同一绘制批次；\n
+     * 层数不足时按两倍扩容并复制已有内容；区域不回收
+     */
+    export class TextureAtlas {
+    public:
+        const static char *TAG;
+
+        TextureAtlas() = delete;
+
+        /// 图集使用的纹理单元（在普通纹理槽之外）
+        static constexpr unsigned int TextureUnit = 31;
+        /// 区域之间的间隔（像素）
+        static constexpr std::uint32_t Padding = 2;
+
+        /// 图集中的区域
+        struct Region {
+            std::uint32_t Layer = 0;
+            std::uint32_t X = 0, Y = 0;
+            std::uint32_t Width = 0, Height = 0;
+        };
+
+        /**
+         * 启用图集
+         * @param page_size 每层的边长
+         * @param max_texture_size 可放入图集的纹理最大边长
+         */
+        static void Enable(const std::uint32_t page_size = 2048, const std::uint32_t max_texture_size = 512) {
+            PageSize = page_size;
+            // 区域含Padding，须能放入一层
+            MaxTextureSize = std::min(max_texture_size, page_size > Padding ? page_size - Padding : 0);
+            Enabled = true;
+            LogI(TAG) << "已启用纹理图集 (页: " << page_size << ", 最大纹理: " << MaxTextureSize << ")";
+        }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /// 纹理能否放入图集
+        static bool Accepts(const std::uint32_t width, const std::uint32_t height) {
+            return Enabled && width > 0 && height > 0 && width <= MaxTextureSize && height <= MaxTextureSize;
+        }
+
+        /**
+         * 分配区域并上传
+         * @param data 像素数据（8位每通道，行紧密排列）
+         * @param width 宽
+         * @param height 高
+         * @param channels 通道数（1~4，按R、RG、RGB、RGBA的语义扩展为RGBA）
+         * @return 失败返回<code>std::nullopt</code>
+         */
+        static std::optional<Region> Allocate(const unsigned char *data, const std::uint32_t width, const std::uint32_t height, const int channels) {
+            if (!Accepts(width, height) || channels < 1 || channels > 4) return std::nullopt;
+            std::optional<Region> region;
+            for (std::uint32_t layer = 0; layer < Packers.size() && !region; ++layer)
+                if (const auto position = Packers[layer].Pack(width + Padding, height + Padding))
+                    region = Region{layer, position->first, position->second, width, height};
+            if (!region) {
+                const auto layer = static_cast<std::uint32_t>(Packers.size());
+                Packers.emplace_back(PageSize, PageSize);
+                const auto position = Packers.back().Pack(width + Padding, height + Padding);
+                if (!position) {
+                    // 不保留空层，否则会占用数组的一层
+                    Packers.pop_back();
+                    return std::nullopt;
+                }
+                region = Region{layer, position->first, position->second, width, height};
+            }
+            if (region->Layer >= Layers) Grow(region->Layer + 1);
+            Upload(*region, data, channels);
+            return region;
+        }
+
+        /**
+         * UV矩形
+         * @remark 着色器中以<code>fract(uv) * rect.xy + rect.zw</code>采样，范围内缩半个像素避免采样到相邻区域
+         * @return (缩放x, 缩放y, 偏移x, 偏移y)
+         */
+        static std::array<float, 4> GetRect(const Region &region) {
+            const auto size = static_cast<float>(PageSize);
+            return {
+                (static_cast<float>(region.Width) - 1.0f) / size, (static_cast<float>(region.Height) - 1.0f) / size,
+                (static_cast<float>(region.X) + 0.5f) / size, (static_cast<float>(region.Y) + 0.5f) / size
+            };
+        }
+
+        /**
+         * 绑定图集
+         * @return 纹理单元
+         */
+        static int Bind() {
+            GLState::BindTexture(TextureUnit, GL_TEXTURE_2D_ARRAY, Array);
+            return static_cast<int>(TextureUnit);
+        }
+
+        /// @property Array
+        static unsigned int GetArray() { return Array; }
+
+        /// 已使用的层数
+        static std::uint32_t GetLayerCount() { return static_cast<std::uint32_t>(Packers.size()); }
+
+        /// 层的占用率
+        static float GetOccupancy(const std::uint32_t layer) { return Packers[layer].GetOccupancy(); }
+
+        /**
+         * 释放GPU资源
+         * @remark 需在OpenGL上下文销毁前调用
+         */
+        static void Release() {
+            if (Array != 0) GLState::DeleteTexture(Array);
+            Array = 0;
+            Layers = 0;
+            Packers.clear();
+        }
+
+    private:
+        static void Grow(const std::uint32_t required) {
+            auto layers = std::max(Layers, 4u);
+            while (layers < required) layers *= 2;
+            unsigned int array = 0;
+            glGenTextures(1, &array);
+            GLState::BindTexture(GL_TEXTURE_2D_ARRAY, array);
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, static_cast<GLsizei>(PageSize), static_cast<GLsizei>(PageSize), static_cast<GLsizei>(layers));
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            if (Array != 0) {
+                glCopyImageSubData(Array, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, array, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+                                   static_cast<GLsizei>(PageSize), static_cast<GLsizei>(PageSize), static_cast<GLsizei>(Layers));
+                GLState::DeleteTexture(Array);
+            }
+            Array = array;
+            Layers = layers;
+            LogD(TAG) << "纹理图集扩容: " << layers << "层";
+        }
+
+        static void Upload(const Region &region, const unsigned char *data, const int channels) {
+            const auto pixels = static_cast<std::size_t>(region.Width) * region.Height;
+            std::vector<unsigned char> rgba(pixels * 4);
+            for (std::size_t i = 0; i < pixels; ++i) {
+                const auto src = data + i * channels;
+                const auto dst = rgba.data() + i * 4;
+                // 与R8/RG8/RGB8纹理的采样结果一致：缺失的颜色通道为0，缺失的Alpha为1
+                dst[0] = src[0];
+                dst[1] = channels >= 2 ? src[1] : 0;
+                dst[2] = channels >= 3 ? src[2] : 0;
+                dst[3] = channels == 4 ? src[3] : 255;
+            }
+            GLState::BindTexture(GL_TEXTURE_2D_ARRAY, Array);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, static_cast<GLint>(region.X), static_cast<GLint>(region.Y), static_cast<GLint>(region.Layer),
+                            static_cast<GLsizei>(region.Width), static_cast<GLsizei>(region.Height), 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+
+        static bool Enabled;
+        static std::uint32_t PageSize;
+        static std::uint32_t MaxTextureSize;
+        static unsigned int Array;
+        static std::uint32_t Layers;
+        static std::vector<ShelfPacker> Packers;
+    };
+
+    const char *TextureAtlas::TAG = "TextureAtlas";
+    bool TextureAtlas::Enabled = false;
+    std::uint32_t TextureAtlas::PageSize = 2048;
+    std::uint32_t TextureAtlas::MaxTextureSize = 512;
+    unsigned int TextureAtlas::Array = 0;
+    std::uint32_t TextureAtlas::Layers = 0;
+    std::vector<ShelfPacker> TextureAtlas::Packers;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file UniformOverrides.ixx
+ * @brief 覆盖Uniform块
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glm/glm.hpp>
+export module CEngine.Render:UniformOverrides;
+import :ShaderUniformVar;
+import :ShaderProgram;
+import :Texture;
+import std;
+import CEngine.Base;
+import CEngine.Logger;
+
+namespace CEngine {
+    /**
+     * @brief 覆盖Uniform块
+     * @remark 覆盖值按(名称, 类型, 偏移)的扁平表保存，数值紧凑存放于同一块内存中；\n
+     * 首次用于某个ShaderProgram时解析地址，之后只上传修改过的值；\n
+     * 若该程序上一次上传覆盖值的对象不是自身，则全部上传
+     */
+    export class UniformOverrides {
+    public:
+        const static char *TAG;
+
+        struct Entry {
+            std::string Name;
+            ShaderUniformVar::Type Type = ShaderUniformVar::Type::UNKNOWN;
+            /// @brief 值在Data中的偏移
+            std::uint32_t Offset = 0;
+            /// @brief 在CompiledFor中的地址
+            int Location = -1;
+            bool Dirty = true;
+        };
+
+        UniformOverrides() = default;
+        UniformOverrides(const UniformOverrides &) = default;
+        UniformOverrides &operator=(const UniformOverrides &) = default;
+
+        /**
+         * 添加默认值的覆盖
+         * @remark 已存在同名覆盖时，类型相同则保留原值，否则重置为默认值
+         * @param name 变量名称
+         * @param type 类型
+         * @return 条目索引
+         */
+        std::size_t Add(const std::string &name, const ShaderUniformVar::Type type) {
+            if (const auto index = Find(name); index != npos) {
+                if (Entries[index].Type == type) return index;
+                Remove(index);
+            }
+            const auto size = SizeOf(type);
+            if (size == 0) {
+                LogE(TAG) << "不支持的Uniform类型: " << name;
+                return npos;
+            }
+            Entry entry{name, type, static_cast<std::uint32_t>(Data.size())};
+            Data.resize(Data.size() + Align(size), std::byte{0});
+            Entries.push_back(std::move(entry));
+            CompiledFor = {};
+            return Entries.size() - 1;
+        }
+
+        /**
+         * 设置覆盖值（不存在时添加）
+         * @param name 变量名称
+         * @param value 值
+         */
+        template<typename T>
+        void Set(const std::string &name, const T &value) {
+            if (const auto index = Add(name, ShaderUniformVar::TypeOf<T>()); index != npos)
+                Set(index, value);
+        }
+
+        /**
+         * 设置覆盖值并标记为修改
+         * @param index 条目索引
+         * @param value 值（类型须与条目一致）
+         */
+        template<typename T>
+        void Set(const std::size_t index, const T &value) {
+            auto &entry = Entries[index];
+            if (entry.Type != ShaderUniformVar::TypeOf<T>()) return;
+            std::memcpy(Data.data() + entry.Offset, &value, sizeof(T));
+            entry.Dirty = true;
+        }
+
+        /**
+         * 获取覆盖值
+         * @param index 条目索引
+         */
+        template<typename T>
+        T Get(const std::size_t index) const {
+            T value{};
+            if (Entries[index].Type == ShaderUniformVar::TypeOf<T>())
+                std::memcpy(&value, Data.data() + Entries[index].Offset, sizeof(T));
+            return value;
+        }
+
+        /// 移除条目
+        void Remove(const std::size_t index) {
+            if (index >= Entries.size()) return;
+            const auto offset = Entries[index].Offset;
+            const auto size = Align(SizeOf(Entries[index].Type));
+            Data.erase(Data.begin() + offset, Data.begin() + offset + size);
+            Entries.erase(Entries.begin() + static_cast<std::ptrdiff_t>(index));
+            for (auto &entry: Entries)
+                if (entry.Offset > offset) entry.Offset -= size;
+            CompiledFor = {};
+        }
+
+        /// 查找条目
+        std::size_t Find(const std::string &name) const {
+            for (std::size_t i = 0; i < Entries.size(); ++i)
+                if (Entries[i].Name == name) return i;
+            return npos;
+        }
+
+        /**
+         * 上传到ShaderProgram
+         * @remark 请先<code>Use</code>ShaderProgram；sampler2D每次都会绑定纹理并设置纹理单元
+         * @param program ShaderProgram
+         * @return 实际上传的条目数
+         */
+        std::uint32_t Upload(ShaderProgram *program) {
+            bool full = false;
+            if (CompiledFor.GetRaw() != program->GetHandle()) {
+                for (auto &entry: Entries)
+                    entry.Location = program->GetUniformLocation(entry.Name);
+                CompiledFor = program;
+                full = true;
+            }
+            if (program->getUniformOwner() != this) {
+                program->setUniformOwner(this);
+                full = true;
+            }
+            std::uint32_t uploaded = 0;
+            for (auto &entry: Entries) {
+                if (entry.Location < 0) continue;
+                if (!full && !entry.Dirty && entry.Type != ShaderUniformVar::Type::SAMPLER2D) continue;
+                UploadEntry(program, entry);
+                entry.Dirty = false;
+                ++uploaded;
+            }
+            return uploaded;
+        }
+
+        bool empty() const { return Entries.empty(); }
+
+        std::size_t size() const { return Entries.size(); }
+
+        const Entry &operator[](const std::size_t index) const { return Entries[index]; }
+
+        /// @property Entries
+        const std::vector<Entry> &getEntries() const { return Entries; }
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    private:
+        static std::uint32_t SizeOf(const ShaderUniformVar::Type type) {
+            switch (type) {
+                case ShaderUniformVar::Type::INT: return sizeof(int);
+                case ShaderUniformVar::Type::UINT: return sizeof(unsigned int);
+                case ShaderUniformVar::Type::FLOAT: return sizeof(float);
+                case ShaderUniformVar::Type::DOUBLE: return sizeof(double);
+                case ShaderUniformVar::Type::VEC2: return sizeof(glm::vec2);
+                case ShaderUniformVar::Type::VEC3: return sizeof(glm::vec3);
+                case ShaderUniformVar::Type::VEC4: return sizeof(glm::vec4);
+                case ShaderUniformVar::Type::MAT3: return sizeof(glm::mat3);
+                case ShaderUniformVar::Type::MAT4: return sizeof(glm::mat4);
+                case ShaderUniformVar::Type::SAMPLER2D: return sizeof(Texture *);
+                default: return 0;
+            }
+        }
+
+        static std::uint32_t Align(const std::uint32_t size) {
+            return (size + 7u) & ~7u;
+        }
+
+        template<typename T>
+        T Read(const Entry &entry) const {
+            T value;
+            std::memcpy(&value, Data.data() + entry.Offset, sizeof(T));
+            return value;
+        }
+
+        void UploadEntry(ShaderProgram *program, const Entry &entry) const {
+            switch (entry.Type) {
+                case ShaderUniformVar::Type::INT: program->SetUniform(entry.Location, Read<int>(entry)); break;
+                case ShaderUniformVar::Type::UINT: program->SetUniform(entry.Location, Read<unsigned int>(entry)); break;
+                case ShaderUniformVar::Type::FLOAT: program->SetUniform(entry.Location, Read<float>(entry)); break;
+                case ShaderUniformVar::Type::DOUBLE: program->SetUniform(entry.Location, Read<double>(entry)); break;
+                case ShaderUniformVar::Type::VEC2: program->SetUniform(entry.Location, Read<glm::vec2>(entry)); break;
+                case ShaderUniformVar::Type::VEC3: program->SetUniform(entry.Location, Read<glm::vec3>(entry)); break;
+                case ShaderUniformVar::Type::VEC4: program->SetUniform(entry.Location, Read<glm::vec4>(entry)); break;
+                case ShaderUniformVar::Type::MAT3: program->SetUniform(entry.Location, Read<glm::mat3>(entry)); break;
+                case ShaderUniformVar::Type::MAT4: program->SetUniform(entry.Location, Read<glm::mat4>(entry)); break;
+                case ShaderUniformVar::Type::SAMPLER2D:
+                    if (const auto tex = Read<Texture *>(entry); tex != nullptr)
+                        program->SetUniform(entry.Location, tex->Use());
+                    break;
+                default: break;
+            }
+        }
+
+        std::vector<Entry> Entries;
+        /// @brief 紧凑存放的覆盖值（8字节对齐）
+        std::vector<std::byte> Data;
+        /// @brief 地址所对应的ShaderProgram
+        Handle<ShaderProgram> CompiledFor;
+    };
+
+    const char *UniformOverrides::TAG = "UniformOverrides";
+}
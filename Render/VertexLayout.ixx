@@ -0,0 +1,328 @@
+/**
+ * @file VertexLayout.ixx
+ * @brief 顶点布局与顶点压缩
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/ext/matrix_transform.hpp>
+export module CEngine.Render:VertexLayout;
+import :MeshArena;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /**
+     * @brief 顶点信息
+     */
+    export struct VertexInfo {
+        /// @brief 顶点位置
+        glm::vec3 Position;
+        /// @brief 法线
+        glm::vec3 Normal;
+        /// @brief 纹理坐标
+        glm::vec2 TexCoord;
+        /**
+        * 比较运算符
+        */
+        bool operator==(const VertexInfo &other) const {
+            return Position == other.Position && Normal == other.Normal && TexCoord == other.TexCoord;
+        }
+
+        void Print(Logger &logger) const {
+            logger << "{" << Position << "," << Normal << "," << TexCoord << "}";
+        }
+    };
+
+    /// 顶点位置格式
+    export enum class PositionFormat : std::uint8_t {
+        /// 3 x float（12字节）
+        Float3 = 0,
+        /// 3 x unorm16 + 填充（8字节），按网格包围盒量化，反量化变换并入MVP
+        Unorm16 = 1,
+    };
+
+    /// 法线格式
+    export enum class NormalFormat : std::uint8_t {
+        /// 3 x float（12字节）
+        Float3 = 0,
+        /// 八面体编码 2 x snorm16（4字节），着色器以CE_OCT_NORMAL解码
+        Octahedral16 = 1,
+    };
+
+    /// 纹理坐标格式
+    export enum class TexCoordFormat : std::uint8_t {
+        /// 2 x float（8字节）
+        Float2 = 0,
+        /// 2 x half（4字节）
+        Half2 = 1,
+        /// 2 x unorm16（4字节），仅适用于[0, 1]内的坐标
+        Unorm16 = 2,
+    };
+
+    /**
+     * @brief 顶点布局
+     * @remark 属性地址：0 位置，1 法线，2 纹理坐标；各属性交错存放\n
+     * PositionStream为<code>true</code>时额外上传一份紧密排列的位置流，供仅深度的通道使用
+     */
+    export struct VertexLayout {
+        PositionFormat Position = PositionFormat::Float3;
+        NormalFormat Normal = NormalFormat::Float3;
+        TexCoordFormat TexCoord = TexCoordFormat::Float2;
+        bool PositionStream = false;
+
+        bool operator==(const VertexLayout &) const = default;
+
+        /// 与VertexInfo内存布局相同（无需编码）
+        bool IsRaw() const {
+            return Position == PositionFormat::Float3 && Normal == NormalFormat::Float3 && TexCoord == TexCoordFormat::Float2;
+        }
+
+        std::uint32_t GetPositionSize() const { return Position == PositionFormat::Float3 ? 12 : 8; }
+        std::uint32_t GetNormalSize() const { return Normal == NormalFormat::Float3 ? 12 : 4; }
+        std::uint32_t GetTexCoordSize() const { return TexCoord == TexCoordFormat::Float2 ? 8 : 4; }
+
+        /// 交错顶点大小（字节）
+        std::uint32_t GetStride() const { return GetPositionSize() + GetNormalSize() + GetTexCoordSize(); }
+
+        /// 顶点属性设置函数（同一布局返回同一函数，可作为MeshArena页的区分）
+        MeshArena::LayoutSetup GetSetup() const {
+            static const auto setups = MakeSetups(std::make_index_sequence<LayoutCount>());
+            return setups[Index()];
+        }
+
+        /// 位置流的顶点属性设置函数（仅属性0）
+        MeshArena::LayoutSetup GetPositionSetup() const {
+            return Position == PositionFormat::Float3 ? &SetupPositionOnly<PositionFormat::Float3> : &SetupPositionOnly<PositionFormat::Unorm16>;
+        }
+
+        /// 最紧凑的布局（16字节）
+        static VertexLayout Compact() {
+            return {PositionFormat::Unorm16, NormalFormat::Octahedral16, TexCoordFormat::Unorm16};
+        }
+
+    private:
+        static constexpr std::size_t TexCoordFormatCount = 3;
+        static constexpr std::size_t NormalFormatCount = 2;
+        static constexpr std::size_t PositionFormatCount = 2;
+        static constexpr std::size_t LayoutCount = PositionFormatCount * NormalFormatCount * TexCoordFormatCount;
+
+        std::size_t Index() const {
+            return (static_cast<std::size_t>(Position) * NormalFormatCount + static_cast<std::size_t>(Normal)) * TexCoordFormatCount +
+                   static_cast<std::size_t>(TexCoord);
+        }
+
+        static constexpr VertexLayout FromIndex(const std::size_t index) {
+            return {
+                static_cast<PositionFormat>(index / (NormalFormatCount * TexCoordFormatCount)),
+                static_cast<NormalFormat>(index / TexCoordFormatCount % NormalFormatCount),
+                static_cast<TexCoordFormat>(index % TexCoordFormatCount)
+            };
+        }
+
+        static void SetupPosition(const PositionFormat format, const GLsizei stride) {
+            if (format == PositionFormat::Float3)
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, nullptr);
+            else
+                glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, nullptr);
+            glEnableVertexAttribArray(0);
+        }
+
+        static void SetupAttributes(const VertexLayout &layout) {
+            const auto stride = static_cast<GLsizei>(layout.GetStride());
+            SetupPosition(layout.Position, stride);
+            const auto normal_offset = reinterpret_cast<void *>(static_cast<std::uintptr_t>(layout.GetPositionSize()));
+            if (layout.Normal == NormalFormat::Float3)
+                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normal_offset);
+            else
+                glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, normal_offset);
+            glEnableVertexAttribArray(1);
+            const auto tex_coord_offset = reinterpret_cast<void *>(static_cast<std::uintptr_t>(layout.GetPositionSize() + layout.GetNormalSize()));
+            switch (layout.TexCoord) {
+                case TexCoordFormat::Float2:
+                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, tex_coord_offset);
+                    break;
+                case TexCoordFormat::Half2:
+                    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, tex_coord_offset);
+                    break;
+                case TexCoordFormat::Unorm16:
+                    glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, tex_coord_offset);
+                    break;
+            }
+            glEnableVertexAttribArray(2);
+        }
+
+        template<std::size_t I>
+        static void SetupIndexed() {
+            SetupAttributes(FromIndex(I));
+        }
+
+        template<PositionFormat P>
+        static void SetupPositionOnly() {
+            SetupPosition(P, 0);
+        }
+
+        /// 每种布局一个设置函数
+        template<std::size_t... I>
+        static std::array<MeshArena::LayoutSetup, LayoutCount> MakeSetups(std::index_sequence<I...>) {
+            return {&SetupIndexed<I>...};
+        }
+    };
+
+    /// 编码后的顶点数据
+    export struct EncodedVertices {
+        /// @brief 交错顶点数据
+        std::vector<std::byte> Data;
+        /// @brief 位置流（PositionStream为<code>false</code>时为空）
+        std::vector<std::byte> Positions;
+        /// @brief 反量化变换（量化位置时将[0, 1]映射回包围盒，否则为单位矩阵）
+        glm::mat4 Dequantize{1.0f};
+    };
+
+    /**
+     * @brief 顶点编码器
+     * @remark 导入网格时按内容选择紧凑的顶点布局并编码
+     */
+    export class VertexEncoder {
+    public:
+        VertexEncoder() = delete;
+
+        /// 启用紧凑顶点（默认关闭，仅对之后导入的网格生效）
+        static void SetEnabled(const bool enabled) { Enabled = enabled; }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /// 启用紧凑顶点时是否量化位置（默认开启）
+        static void SetQuantizePositions(const bool enabled) { QuantizePositions = enabled; }
+
+        static bool IsQuantizePositions() { return QuantizePositions; }
+
+        /// 是否为导入的网格额外生成位置流（默认关闭）
+        static void SetPositionStream(const bool enabled) { PositionStream = enabled; }
+
+        static bool IsPositionStream() { return PositionStream; }
+
+        /**
+         * 为网格选择顶点布局
+         * @remark 法线使用八面体编码；纹理坐标在[0, 1]内用unorm16，绝对值不超过HalfTexCoordLimit用half，否则保持float
+         * @param vertices 顶点
+         */
+        static VertexLayout ChooseLayout(const std::vector<VertexInfo> &vertices) {
+            VertexLayout layout;
+            layout.PositionStream = PositionStream;
+            if (!Enabled || vertices.empty()) return layout;
+            layout.Normal = NormalFormat::Octahedral16;
+            if (QuantizePositions) layout.Position = PositionFormat::Unorm16;
+            glm::vec2 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+            for (const auto &vertex: vertices) {
+                min = glm::min(min, vertex.TexCoord);
+                max = glm::max(max, vertex.TexCoord);
+            }
+            if (min.x >= 0.0f && min.y >= 0.0f && max.x <= 1.0f && max.y <= 1.0f)
+                layout.TexCoord = TexCoordFormat::Unorm16;
+            else if (std::max({-min.x, -min.y, max.x, max.y}) <= HalfTexCoordLimit)
+                layout.TexCoord = TexCoordFormat::Half2;
+            return layout;
+        }
+
+        /**
+         * 按布局编码顶点
+         * @param vertices 顶点
+         * @param layout 顶点布局
+         */
+        static EncodedVertices Encode(const std::vector<VertexInfo> &vertices, const VertexLayout &layout) {
+            EncodedVertices result;
+            const auto stride = layout.GetStride();
+            const auto position_size = layout.GetPositionSize();
+            result.Data.resize(vertices.size() * stride);
+            if (layout.PositionStream) result.Positions.resize(vertices.size() * position_size);
+            // 位置量化范围：网格包围盒
+            glm::vec3 offset(0.0f), scale(1.0f);
+            if (layout.Position == PositionFormat::Unorm16 && !vertices.empty()) {
+                glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+                for (const auto &vertex: vertices) {
+                    min = glm::min(min, vertex.Position);
+                    max = glm::max(max, vertex.Position);
+                }
+                offset = min;
+                scale = glm::max(max - min, glm::vec3(std::numeric_limits<float>::min()));
+                result.Dequantize = glm::scale(glm::translate(glm::mat4(1.0f), offset), scale);
+            }
+            auto out = result.Data.data();
+            for (std::size_t i = 0; i < vertices.size(); ++i, out += stride) {
+                const auto &vertex = vertices[i];
+                if (layout.Position == PositionFormat::Float3) {
+                    std::memcpy(out, &vertex.Position, 12);
+                } else {
+                    const auto packed = glm::packUnorm4x16(glm::vec4((vertex.Position - offset) / scale, 0.0f));
+                    std::memcpy(out, &packed, 8);
+                }
+                if (layout.PositionStream) std::memcpy(result.Positions.data() + i * position_size, out, position_size);
+                const auto normal = out + position_size;
+                if (layout.Normal == NormalFormat::Float3) {
+                    std::memcpy(normal, &vertex.Normal, 12);
+                } else {
+                    const auto packed = glm::packSnorm2x16(EncodeOctahedral(vertex.Normal));
+                    std::memcpy(normal, &packed, 4);
+                }
+                const auto tex_coord = normal + layout.GetNormalSize();
+                switch (layout.TexCoord) {
+                    case TexCoordFormat::Float2:
+                        std::memcpy(tex_coord, &vertex.TexCoord, 8);
+                        break;
+                    case TexCoordFormat::Half2: {
+                        const auto packed = glm::packHalf2x16(vertex.TexCoord);
+                        std::memcpy(tex_coord, &packed, 4);
+                        break;
+                    }
+                    case TexCoordFormat::Unorm16: {
+                        const auto packed = glm::packUnorm2x16(vertex.TexCoord);
+                        std::memcpy(tex_coord, &packed, 4);
+                        break;
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * 八面体编码
+         * @param normal 单位向量
+         * @return [-1, 1]内的二维坐标
+         */
+        static glm::vec2 EncodeOctahedral(const glm::vec3 &normal) {
+            const float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+            if (sum == 0.0f) return {0.0f, 0.0f};
+            glm::vec2 p = glm::vec2(normal) / sum;
+            if (normal.z < 0.0f)
+                p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * glm::vec2(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+            return p;
+        }
+
+        /// 八面体解码（与着色器中的Decode_Octahedral一致）
+        static glm::vec3 DecodeOctahedral(const glm::vec2 &encoded) {
+            glm::vec3 n(encoded, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+            const float t = std::max(-n.z, 0.0f);
+            n.x += n.x >= 0.0f ? -t : t;
+            n.y += n.y >= 0.0f ? -t : t;
+            return glm::normalize(n);
+        }
+
+    private:
+        /// half在[1, 2)内的精度为1/1024，更大的坐标保持float
+        static constexpr float HalfTexCoordLimit = 2.0f;
+
+        static bool Enabled;
+        static bool QuantizePositions;
+        static bool PositionStream;
+    };
+
+    bool VertexEncoder::Enabled = false;
+    bool VertexEncoder::QuantizePositions = true;
+    bool VertexEncoder::PositionStream = false;
+}
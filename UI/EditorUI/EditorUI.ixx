@@ -14,9 +14,12 @@ import :FileBrowser;
 import :SceneTreeBrowser;
 import :Inspector;
 import :GPUResourceViewer;
+import :GPUProfilerPanel;
+import :ProfilerPanel;
 import std;
 import CEngine.UI;
 import CEngine.Engine;
+import CEngine.Render;
 import CEngine.Logger;
 
 namespace CEngine {
@@ -47,6 +50,12 @@ namespace CEngine {
             // GPU Resource Viewer
             if (show_gpu_resource_viewer)
                 gpu_resource_viewer.ShowGPUResourceViewer(&show_gpu_resource_viewer, window_width, window_height);
+            // GPU Profiler
+            if (show_gpu_profiler)
+                gpu_profiler_panel.ShowGPUProfiler(&show_gpu_profiler, window_width, window_height);
+            // CPU Profiler
+            if (show_cpu_profiler)
+                cpu_profiler_panel.ShowProfiler(&show_cpu_profiler, window_width, window_height);
             // DemoWindow
             if (show_demo_window)
                 ImGui::ShowDemoWindow(&show_demo_window);
@@ -89,6 +98,10 @@ namespace CEngine {
                         show_bottom_bar = !show_bottom_bar;
                     if (ImGui::MenuItem("GPU Resource Viewer", nullptr, show_gpu_resource_viewer))
                         show_gpu_resource_viewer = !show_gpu_resource_viewer;
+                    if (ImGui::MenuItem("GPU Profiler", nullptr, show_gpu_profiler))
+                        show_gpu_profiler = !show_gpu_profiler;
+                    if (ImGui::MenuItem("CPU Profiler", nullptr, show_cpu_profiler))
+                        show_cpu_profiler = !show_cpu_profiler;
                     if (ImGui::MenuItem("ImGui Demo Window", nullptr, show_demo_window))
                         show_demo_window = !show_demo_window;
                     ImGui::MenuItem("Options");
@@ -157,9 +170,14 @@ namespace CEngine {
                 ImGui::SetNextWindowSize(ImVec2(window_width, 30));
                 if (ImGui::Begin("Info Window", nullptr,
                                  ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoMove)) {
-                    ImGui::Text("  FPS: %.1f   |   Render Time: %.2fms   |  ", fps, frame_time);
+                    ImGui::Text("  FPS: %.1f   |   Render Time: %.2fms   |   GPU Time: %.2fms   |  ", fps, frame_time, GPUProfiler::GetFrameTime());
                     ImGui::SameLine();
                     ImGui::Text("Window Size: %.0f x %.0f   |  ", window_width, window_height);
+                    ImGui::SameLine();
+                    const auto &stats = Engine::GetIns()->getRenderQueue().GetStats();
+                    ImGui::Text("Draws: %u (%u units, %u instanced)   |   Switches Avoided (Program/VAO/Texture): %u/%u/%u   |   Uniform Uploads: %u   |  ",
+                                stats.DrawCalls, stats.Packets, stats.InstancedPackets,
+                                stats.ProgramSwitchesAvoided, stats.VAOSwitchesAvoided, stats.TextureSwitchesAvoided, stats.UniformUploads);
                 }
                 ImGui::End();
             }
@@ -171,7 +189,10 @@ namespace CEngine {
         FileBrowser file_browser = FileBrowser(".");
         SceneTreeBrowser scene_tree_browser = SceneTreeBrowser();
         GPUResourceViewer gpu_resource_viewer = GPUResourceViewer();
-        bool show_left_panel = true, show_right_panel = true, show_bottom_bar = true, show_gpu_resource_viewer = false, show_demo_window = false;
+        GPUProfilerPanel gpu_profiler_panel = GPUProfilerPanel();
+        ProfilerPanel cpu_profiler_panel = ProfilerPanel();
+        bool show_left_panel = true, show_right_panel = true, show_bottom_bar = true, show_gpu_resource_viewer = false, show_gpu_profiler = false,
+                show_cpu_profiler = false, show_demo_window = false;
     };
 
     const char *EditorUI::TAG = "EditorUI";
@@ -11,6 +11,7 @@ module;
 export module CEngine.UI.EditorUI:FileBrowser;
 import :SceneTreeBrowser;
 import std;
+import CEngine.Base;
 import CEngine.Logger;
 import CEngine.ModelImporter;
 import CEngine.Engine;
@@ -78,13 +79,17 @@ namespace CEngine {
                 // 展示右键菜单
                 if (ImGui::BeginPopupContextItem(node->name.c_str())) {
                     for (auto &[name, shader]: ShaderProgram::All_Instances) {
+                        if (shader.Get() == nullptr) continue;
                         if (ImGui::MenuItem(std::format("Open With Shader \"{}\"", name).c_str())) {
-                            if (const auto model = ModelImporter::import_model(node->path.string().c_str(), shader); model->IsValid()) {
-                                if (scene_tree_browser.NodeSelected != nullptr)
-                                    scene_tree_browser.NodeSelected->AddChild(model);
-                                else
-                                    Engine::GetIns()->getRoot()->AddChild(model);
-                            }
+                            // 异步导入，完成时挂到发起导入时选中的节点下
+                            ModelImporter::import_model_async(node->path.string().c_str(), shader.Get(), 1.0f,
+                                                              [target = scene_tree_browser.NodeSelected](auto *model) {
+                                                                  if (model == nullptr) return;
+                                                                  if (const auto selected = target.Get(); selected != nullptr)
+                                                                      selected->AddChild(model);
+                                                                  else
+                                                                      Engine::GetIns()->getRoot()->AddChild(model);
+                                                              });
                         }
                     }
                     ImGui::EndPopup();
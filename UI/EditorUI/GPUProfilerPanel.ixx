@@ -0,0 +1,58 @@
+/**
+ * @file GPUProfilerPanel.ixx
+ * @brief GPU计时面板
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include "imgui/imgui.h"
+export module CEngine.UI.EditorUI:GPUProfilerPanel;
+import std;
+import CEngine.Render;
+
+namespace CEngine {
+    export class GPUProfilerPanel {
+    public:
+        GPUProfilerPanel() = default;
+
+        void ShowGPUProfiler(bool *isOpen, const float window_width, const float window_height) {
+            ImGui::SetNextWindowSize(ImVec2(std::clamp(window_width / 3, 360.f, 700.f), std::clamp(window_height / 2, 300.f, 800.f)), ImGuiCond_Once);
+            ImGui::Begin("GPU Profiler", isOpen);
+            bool enabled = GPUProfiler::IsEnabled();
+            if (ImGui::Checkbox("Enabled", &enabled))
+                GPUProfiler::SetEnabled(enabled);
+            ImGui::SameLine();
+            bool draw_groups = GPUProfiler::IsDrawGroupTiming();
+            if (ImGui::Checkbox("Draw Groups", &draw_groups))
+                GPUProfiler::SetDrawGroupTiming(draw_groups);
+            ImGui::SameLine();
+            bool debug_groups = GPUProfiler::IsDebugGroupsEnabled();
+            if (ImGui::Checkbox("Debug Groups", &debug_groups))
+                GPUProfiler::SetDebugGroupsEnabled(debug_groups);
+            ImGui::Text("Frame: %llu   |   GPU Time: %.3fms   |   Dropped: %llu", static_cast<unsigned long long>(GPUProfiler::GetResultFrame()),
+                        GPUProfiler::GetFrameTime(), static_cast<unsigned long long>(GPUProfiler::GetDroppedFrames()));
+            const auto &results = GPUProfiler::GetResults();
+            const auto frame_time = GPUProfiler::GetFrameTime();
+            if (ImGui::BeginTable("##GPUProfiler#Timings", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Time (ms)", ImGuiTableColumnFlags_WidthFixed, 80.f);
+                ImGui::TableSetupColumn("Share");
+                ImGui::TableHeadersRow();
+                for (const auto &timing: results) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s%s", std::string(timing.Depth * 2, ' ').c_str(), timing.Name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", timing.Duration);
+                    ImGui::TableNextColumn();
+                    ImGui::ProgressBar(frame_time > 0 ? static_cast<float>(timing.Duration / frame_time) : 0.f, ImVec2(-FLT_MIN, 0));
+                }
+                ImGui::EndTable();
+            }
+            ImGui::End();
+        }
+    };
+}
@@ -11,6 +11,7 @@ module;
 #include "imgui/imgui.h"
 export module CEngine.UI.EditorUI:GPUResourceViewer;
 import std;
+import CEngine.Base;
 import CEngine.Render;
 import CEngine.Utils;
 
@@ -19,8 +20,8 @@ namespace CEngine {
 
     export class GPUResourceViewer {
     public:
-        ShaderProgram *SelectedShaderProgram = nullptr;
-        Texture *SelectedTexture = nullptr;
+        Handle<ShaderProgram> SelectedShaderProgram;
+        Handle<Texture> SelectedTexture;
 
         GPUResourceViewer() = default;
 
@@ -31,9 +32,11 @@ namespace CEngine {
                 if (ImGui::BeginTabItem("Shader Program")) {
                     ImGui::BeginChild("##ShaderProgram#List", ImVec2(ImGui::GetContentRegionAvail().x * 0.2f, 0), ImGuiWindowFlags_NoResize);
                     if (ImGui::BeginListBox("##ShaderProgram#ListBox", ImVec2(-FLT_MIN, -FLT_MIN))) {
-                        for (auto &[name, shader]: ShaderProgram::All_Instances)
+                        for (auto &[name, shader]: ShaderProgram::All_Instances) {
+                            if (shader.Get() == nullptr) continue;
                             if (ImGui::Selectable(name.c_str(), shader == SelectedShaderProgram))
                                 SelectedShaderProgram = shader;
+                        }
                         ImGui::EndListBox();
                     }
                     ImGui::EndChild();
@@ -78,9 +81,12 @@ namespace CEngine {
                         Texture::FromFile(Utils::ShowOpenFileDialog().string().c_str());
                     }
                     if (ImGui::BeginListBox("##Texture#ListBox", ImVec2(-FLT_MIN, -FLT_MIN))) {
-                        for (auto &[name, tex]: Texture::All_Instances)
-                            if (ImGui::Selectable(name.c_str(), tex == SelectedTexture))
+                        for (auto &[name, tex]: Texture::All_Instances) {
+                            // 异步加载的纹理同时以路径登记，只列出主标识
+                            if (tex.Get() == nullptr || tex->getKey() != name) continue;
+                            if (ImGui::Selectable(name.ToString().c_str(), tex == SelectedTexture))
                                 SelectedTexture = tex;
+                        }
                         ImGui::EndListBox();
                     }
                     ImGui::EndChild();
@@ -94,9 +100,9 @@ namespace CEngine {
                             ImGui::TableHeadersRow();
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
-                            ImGui::Text("MD5");
+                            ImGui::Text("Key");
                             ImGui::TableNextColumn();
-                            ImGui::Text(SelectedTexture->getMd5().c_str());
+                            ImGui::Text(SelectedTexture->getKey().ToString().c_str());
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
                             ImGui::Text("Texture ID");
@@ -117,20 +123,43 @@ namespace CEngine {
                             ImGui::Text("Size");
                             ImGui::TableNextColumn();
                             ImGui::Text("%d x %d", SelectedTexture->getWidth(), SelectedTexture->getHeight());
+                            if (const auto &region = SelectedTexture->getAtlasRegion()) {
+                                ImGui::TableNextRow();
+                                ImGui::TableNextColumn();
+                                ImGui::Text("Atlas Region");
+                                ImGui::TableNextColumn();
+                                ImGui::Text("Layer %u (%u, %u)", region->Layer, region->X, region->Y);
+                            }
                             ImGui::EndTable();
                         }
-                        ImGui::SeparatorText("Preview");
-                        auto id = SelectedTexture->getTextureID();
-                        ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(SelectedTexture->getTextureID())),
-                                     ImVec2(SelectedTexture->getWidth(), SelectedTexture->getHeight()));
+                        if (!SelectedTexture->IsInAtlas()) {
+                            ImGui::SeparatorText("Preview");
+                            ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(SelectedTexture->getTextureID())),
+                                         ImVec2(SelectedTexture->getWidth(), SelectedTexture->getHeight()));
+                        }
                     } else {
                         ImGui::Text("Please select a item.");
                     }
+                    if (TextureAtlas::IsEnabled()) {
+                        ImGui::SeparatorText("Texture Atlas");
+                        for (std::uint32_t i = 0; i < TextureAtlas::GetLayerCount(); ++i)
+                            ImGui::Text("Layer %u: %.1f%%", i, TextureAtlas::GetOccupancy(i) * 100.0f);
+                    }
                     ImGui::EndChild();
                     ImGui::EndTabItem();
                 }
                 if (ImGui::BeginTabItem("Mesh")) {
                     ImGui::Text("Mesh count: %u", Mesh::All_Instances.size());
+                    ImGui::Text("Object count: %u", HandleTable::GetAliveCount());
+                    if (MeshArena::IsEnabled()) {
+                        ImGui::SeparatorText("Mesh Arena");
+                        for (std::uint32_t i = 0; i < MeshArena::GetPageCount(); ++i) {
+                            const auto &vertices = MeshArena::GetVertexAllocator(i);
+                            const auto &indices = MeshArena::GetIndexAllocator(i);
+                            ImGui::Text("Page %u: vertices %u / %u, indices %u / %u, free blocks %zu", i, vertices.GetUsed(), vertices.GetCapacity(),
+                                        indices.GetUsed(), indices.GetCapacity(), vertices.GetFreeBlockCount() + indices.GetFreeBlockCount());
+                        }
+                    }
                     ImGui::EndTabItem();
                 }
                 ImGui::EndTabBar();
@@ -149,6 +178,11 @@ namespace CEngine {
             case GL_R8: return "GL_R8";
             case GL_RG: return "GL_RG";
             case GL_RG8: return "GL_RG8";
+            case 0x83F0: return "BC1 (DXT1)";
+            case 0x83F3: return "BC3 (DXT5)";
+            case GL_COMPRESSED_RED_RGTC1: return "BC4 (RGTC1)";
+            case GL_COMPRESSED_RG_RGTC2: return "BC5 (RGTC2)";
+            case GL_COMPRESSED_RGBA_BPTC_UNORM: return "BC7 (BPTC)";
             default: return "Unknown";
         }
     }
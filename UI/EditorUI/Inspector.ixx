@@ -71,63 +71,69 @@ namespace CEngine {
     void ProcessRenderUnit3D(RenderUnit3D *ru3d) {
         if (ImGui::CollapsingHeader("RenderUnit3D", ImGuiTreeNodeFlags_DefaultOpen)) {
             if (ImGui::TreeNodeEx("Shader Uniforms Override", ImGuiTreeNodeFlags_DefaultOpen)) {
-                for (auto &[name,suv]: ru3d->getUniforms()) {
-                    const auto type = suv.GetType();
+                auto &overrides = ru3d->getUniforms();
+                for (std::size_t i = 0; i < overrides.size(); ++i) {
+                    const auto &name = overrides[i].Name;
+                    const auto type = overrides[i].Type;
                     ImGui::BulletText(name.c_str());
                     ImGui::PushID(name.c_str());
                     if (type == ShaderUniformVar::Type::INT) {
-                        auto v = suv.GetValue<int>();
+                        auto v = overrides.Get<int>(i);
                         if (ImGui::DragInt("int", &v, 1, -INT_MAX, INT_MAX, "%d")) {
-                            suv.SetValue(v);
+                            overrides.Set(i, v);
                         }
                     } else if (type == ShaderUniformVar::Type::UINT) {
-                        auto v = static_cast<int>(suv.GetValue<unsigned int>());
+                        auto v = static_cast<int>(overrides.Get<unsigned int>(i));
                         if (ImGui::DragInt("uint", &v, 1, 0, INT_MAX, "%d", ImGuiSliderFlags_ClampOnInput)) {
-                            suv.SetValue(static_cast<unsigned int>(v));
+                            overrides.Set(i, static_cast<unsigned int>(v));
                         }
                     } else if (type == ShaderUniformVar::Type::FLOAT) {
-                        auto v = suv.GetValue<float>();
+                        auto v = overrides.Get<float>(i);
                         if (ImGui::DragFloat("float", &v, 0.1, -FLT_MAX, FLT_MAX, ".3f")) {
-                            suv.SetValue(v);
+                            overrides.Set(i, v);
                         }
                     } else if (type == ShaderUniformVar::Type::DOUBLE) {
-                        auto v = static_cast<float>(suv.GetValue<double>());
+                        auto v = static_cast<float>(overrides.Get<double>(i));
                         if (ImGui::DragFloat("float", &v, 0.1, -FLT_MAX, FLT_MAX, ".3f")) {
-                            suv.SetValue(static_cast<double>(v));
+                            overrides.Set(i, static_cast<double>(v));
                         }
                     } else if (type == ShaderUniformVar::Type::VEC2) {
-                        auto v = suv.GetValue<glm::vec2>();
+                        auto v = overrides.Get<glm::vec2>(i);
                         if (ImGui::DragFloat2("vec2", glm::value_ptr(v), 0.1, -FLT_MAX, FLT_MAX, "%.3f")) {
-                            suv.SetValue(v);
+                            overrides.Set(i, v);
                         }
                     } else if (type == ShaderUniformVar::Type::VEC3) {
-                        auto v = suv.GetValue<glm::vec3>();
+                        auto v = overrides.Get<glm::vec3>(i);
                         if (ImGui::ColorEdit3("vec3", glm::value_ptr(v), ImGuiColorEditFlags_Float)) {
-                            suv.SetValue(v);
+                            overrides.Set(i, v);
                         }
                     } else if (type == ShaderUniformVar::Type::VEC4) {
-                        auto v = suv.GetValue<glm::vec4>();
+                        auto v = overrides.Get<glm::vec4>(i);
                         if (ImGui::ColorEdit4("vec4", glm::value_ptr(v), ImGuiColorEditFlags_Float)) {
-                            suv.SetValue(v);
+                            overrides.Set(i, v);
                         }
                     } else if (type == ShaderUniformVar::Type::SAMPLER2D) {
-                        const auto tex = suv.GetValue<Texture *>();
-                        int v = 0;
-                        int index = 1;
-                        for (const auto t: Texture::All_Instances | std::views::values) {
-                            if (t == tex) {
-                                v = index;
-                                break;
-                            }
-                            ++index;
+                        const auto tex = overrides.Get<Texture *>(i);
+                        // 每帧收集一次，标签须在Combo读取期间保持有效
+                        std::vector<Texture *> textures;
+                        std::vector<std::string> labels;
+                        for (const auto &[key, handle]: Texture::All_Instances) {
+                            // 异步加载的纹理同时以路径登记，只取主标识
+                            const auto t = handle.Get();
+                            if (t == nullptr || t->getKey() != key) continue;
+                            textures.push_back(t);
+                            labels.push_back(t->GetDisplayName());
                         }
+                        int v = 0;
+                        if (const auto it = std::ranges::find(textures, tex); it != textures.end())
+                            v = static_cast<int>(it - textures.begin()) + 1;
                         // 为了时索引为0时输出NULL，所有变量偏移1
                         if (ImGui::Combo("sampler2D", &v, [](void *data, const int idx)-> const char *{
                             if (idx == 0) return "NULL";
-                            return std::next(Texture::All_Instances.cbegin(), idx - 1)->first.c_str();
-                        }, nullptr, Texture::All_Instances.size() + 1)) {
+                            return (*static_cast<const std::vector<std::string> *>(data))[idx - 1].c_str();
+                        }, &labels, static_cast<int>(labels.size()) + 1)) {
                             if (v >= 1)
-                                suv.SetValue(std::next(Texture::All_Instances.cbegin(), v - 1)->second);
+                                overrides.Set(i, textures[v - 1]);
                         }
                     } else {
                         ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Have not implemented.");
@@ -161,28 +167,31 @@ namespace CEngine {
         if (ImGui::CollapsingHeader("PBR3D", ImGuiTreeNodeFlags_DefaultOpen)) {
             if (ImGui::TreeNodeEx("Material", ImGuiTreeNodeFlags_DefaultOpen)) {
                 ImGui::SeparatorText("Parameters");
+                bool changed = false;
                 ImGui::Text("Emissive Intensity");
-                ImGui::DragFloat("Float##emissive_intensity", &material.Parameters.EMISSIVE_INTENSITY, 0.01f, 0.0f, FLT_MAX, "%.3f");
+                changed |= ImGui::DragFloat("Float##emissive_intensity", &material.Parameters.EMISSIVE_INTENSITY, 0.01f, 0.0f, FLT_MAX, "%.3f");
                 ImGui::Text("Metallic");
-                ImGui::DragFloat("Float##metallic", &material.Parameters.METALLIC, 0.01f, 0.0f, 1.0f, "%.3f");
+                changed |= ImGui::DragFloat("Float##metallic", &material.Parameters.METALLIC, 0.01f, 0.0f, 1.0f, "%.3f");
                 ImGui::Text("Roughness");
-                ImGui::DragFloat("Float##roughness", &material.Parameters.ROUGHNESS, 0.01f, 0.0f, 1.0f, "%.3f");
+                changed |= ImGui::DragFloat("Float##roughness", &material.Parameters.ROUGHNESS, 0.01f, 0.0f, 1.0f, "%.3f");
                 ImGui::Text("Opacity");
-                ImGui::DragFloat("Float##opacity", &material.Parameters.OPACITY, 0.01f, 0.0f, 1.0f, "%.3f");
+                changed |= ImGui::DragFloat("Float##opacity", &material.Parameters.OPACITY, 0.01f, 0.0f, 1.0f, "%.3f");
                 ImGui::Text("Diffuse Color");
-                ImGui::ColorEdit4("Color4##diffuseColor", &material.Parameters.DIFFUSE_COLOR.r);
+                changed |= ImGui::ColorEdit4("Color4##diffuseColor", &material.Parameters.DIFFUSE_COLOR.r);
                 ImGui::Text("Specular Color");
-                ImGui::ColorEdit4("Color4##specularColor", &material.Parameters.SPECULAR_COLOR.r);
+                changed |= ImGui::ColorEdit4("Color4##specularColor", &material.Parameters.SPECULAR_COLOR.r);
                 ImGui::Text("Emission Color");
-                ImGui::ColorEdit4("Color4##emissionColor", &material.Parameters.EMISSION_COLOR.r);
+                changed |= ImGui::ColorEdit4("Color4##emissionColor", &material.Parameters.EMISSION_COLOR.r);
                 ImGui::Text("Reflective Color");
-                ImGui::ColorEdit4("Color4##reflectiveColor", &material.Parameters.REFLECTIVE_COLOR.r);
+                changed |= ImGui::ColorEdit4("Color4##reflectiveColor", &material.Parameters.REFLECTIVE_COLOR.r);
                 ImGui::Text("Transparent Color");
-                ImGui::ColorEdit4("Color4##transparentColor", &material.Parameters.TRANSPARENT_COLOR.r);
+                changed |= ImGui::ColorEdit4("Color4##transparentColor", &material.Parameters.TRANSPARENT_COLOR.r);
+                if (changed) material.UpdateParameters();
                 ImGui::SeparatorText("Textures");
                 for (auto &[type, value]: material.Textures) {
                     if (value.first == nullptr) continue;
-                    ImGui::Checkbox(aiTextureTypeToString(type), &value.second);
+                    if (ImGui::Checkbox(aiTextureTypeToString(type), &value.second))
+                        material.UpdateParameters();
                 }
                 ImGui::TreePop();
             }
@@ -190,20 +199,20 @@ namespace CEngine {
     }
 
     export void DisplayInspector(const SceneTreeBrowser &scene_tree_browser) {
-        const auto node = scene_tree_browser.NodeSelected;
-        if (node == nullptr || !node->IsValid()) {
+        const auto node = scene_tree_browser.NodeSelected.Get();
+        if (node == nullptr) {
             ImGui::Text("Select A Node First");
             return;
         }
         ProcessNode(node);
 
-        if (const auto node3d = dynamic_cast<Node3D *>(node); node3d != nullptr && node3d->IsValid())
+        if (const auto node3d = dynamic_cast<Node3D *>(node); node3d != nullptr)
             ProcessNode3D(node3d);
 
-        if (const auto ru3d = dynamic_cast<RenderUnit3D *>(node); ru3d != nullptr && ru3d->IsValid())
+        if (const auto ru3d = dynamic_cast<RenderUnit3D *>(node); ru3d != nullptr)
             ProcessRenderUnit3D(ru3d);
 
-        if (const auto pbr3d = dynamic_cast<PBR3D *>(node); pbr3d != nullptr && pbr3d->IsValid())
+        if (const auto pbr3d = dynamic_cast<PBR3D *>(node); pbr3d != nullptr)
             ProcessPBR3D(pbr3d);
     }
 }
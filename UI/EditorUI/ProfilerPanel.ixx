@@ -0,0 +1,146 @@
+/**
+ * @file ProfilerPanel.ixx
+ * @brief CPU计时面板
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include "imgui/imgui.h"
+export module CEngine.UI.EditorUI:ProfilerPanel;
+import std;
+import CEngine.Profiler;
+
+namespace CEngine {
+    export class ProfilerPanel {
+    public:
+        ProfilerPanel() = default;
+
+        void ShowProfiler(bool *isOpen, const float window_width, const float window_height) {
+            ImGui::SetNextWindowSize(ImVec2(std::clamp(window_width / 2, 480.f, 1200.f), std::clamp(window_height / 2, 300.f, 800.f)), ImGuiCond_Once);
+            ImGui::Begin("CPU Profiler", isOpen);
+            if (!Profiler::CompiledIn)
+                ImGui::TextDisabled("Profiler zones are compiled out (CENGINE_PROFILER=OFF)");
+            bool enabled = Profiler::IsEnabled();
+            if (ImGui::Checkbox("Enabled", &enabled))
+                Profiler::SetEnabled(enabled);
+            ImGui::SameLine();
+            ImGui::Checkbox("Pause", &paused);
+            ImGui::SameLine();
+            if (ImGui::Button("Export Chrome Trace"))
+                Profiler::ExportChromeTrace(TracePath);
+            ImGui::SetItemTooltip("%s", TracePath);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(120.f);
+            ImGui::SliderFloat("Zoom", &zoom, 1.f, 64.f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+            if (!paused) Capture();
+            if (!frame) {
+                ImGui::TextDisabled("No frame recorded");
+                ImGui::End();
+                return;
+            }
+            ImGui::Text("Frame: %llu   |   CPU Time: %.3fms", static_cast<unsigned long long>(frame->Number), ToMs(frame->End - frame->Start));
+            ShowTimeline();
+            ShowSummary();
+            ImGui::End();
+        }
+
+    private:
+        /// 同名区间的合计
+        struct Summary {
+            const char *Name = nullptr;
+            std::uint32_t Calls = 0;
+            double Total = 0;
+            double Max = 0;
+        };
+
+        static constexpr auto TracePath = "cengine_trace.json";
+        static constexpr float RowHeight = 18.f;
+
+        static double ToMs(const std::int64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+        /// 按名称取色，同名区间颜色一致
+        static ImU32 ColorOf(const char *name) {
+            const auto hash = std::hash<std::string_view>{}(name);
+            return ImColor::HSV(static_cast<float>(hash % 360) / 360.f, 0.5f, 0.75f);
+        }
+
+        /// 复制最近完成的一帧
+        void Capture() {
+            const auto last = Profiler::GetLastFrame();
+            if (!last || (frame && frame->Number == last->Number)) return;
+            frame = last;
+            threads = Profiler::Collect(frame->Start, frame->End);
+            summaries.clear();
+            for (const auto &thread: threads)
+                for (const auto &event: thread.Events) {
+                    auto it = std::ranges::find_if(summaries, [&](const Summary &s) { return std::string_view(s.Name) == event.Name; });
+                    if (it == summaries.end()) it = summaries.insert(summaries.end(), Summary{event.Name});
+                    const auto duration = ToMs(event.End - event.Start);
+                    ++it->Calls;
+                    it->Total += duration;
+                    it->Max = std::max(it->Max, duration);
+                }
+            std::ranges::sort(summaries, std::greater{}, &Summary::Total);
+        }
+
+        /// 时间线：每个线程一组泳道，每层嵌套一行
+        void ShowTimeline() {
+            ImGui::BeginChild("##CPUProfiler#Timeline", ImVec2(0, ImGui::GetContentRegionAvail().y * 0.6f), ImGuiChildFlags_Borders,
+                              ImGuiWindowFlags_HorizontalScrollbar);
+            const auto draw_list = ImGui::GetWindowDrawList();
+            const auto width = ImGui::GetContentRegionAvail().x * zoom;
+            const auto span = static_cast<double>(std::max<std::int64_t>(frame->End - frame->Start, 1));
+            for (const auto &thread: threads) {
+                ImGui::TextUnformatted(thread.Name.c_str());
+                std::uint32_t depth = 0;
+                for (const auto &event: thread.Events) depth = std::max(depth, event.Depth + 1);
+                const auto origin = ImGui::GetCursorScreenPos();
+                ImGui::Dummy(ImVec2(width, RowHeight * static_cast<float>(depth)));
+                for (const auto &event: thread.Events) {
+                    const auto start = static_cast<double>(std::max(event.Start, frame->Start) - frame->Start) / span;
+                    const auto end = static_cast<double>(std::min(event.End, frame->End) - frame->Start) / span;
+                    const ImVec2 min(origin.x + static_cast<float>(start) * width, origin.y + RowHeight * static_cast<float>(event.Depth));
+                    const ImVec2 max(std::max(origin.x + static_cast<float>(end) * width, min.x + 1.f), min.y + RowHeight - 1.f);
+                    draw_list->AddRectFilled(min, max, ColorOf(event.Name));
+                    if (const auto text_width = ImGui::CalcTextSize(event.Name).x; max.x - min.x > text_width + 4.f)
+                        draw_list->AddText(ImVec2(min.x + 2.f, min.y + 1.f), IM_COL32_WHITE, event.Name);
+                    if (ImGui::IsMouseHoveringRect(min, max))
+                        ImGui::SetTooltip("%s\n%.3fms", event.Name, ToMs(event.End - event.Start));
+                }
+            }
+            ImGui::EndChild();
+        }
+
+        /// 按名称汇总
+        void ShowSummary() const {
+            if (ImGui::BeginTable("##CPUProfiler#Summary", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 60.f);
+                ImGui::TableSetupColumn("Total (ms)", ImGuiTableColumnFlags_WidthFixed, 80.f);
+                ImGui::TableSetupColumn("Max (ms)", ImGuiTableColumnFlags_WidthFixed, 80.f);
+                ImGui::TableHeadersRow();
+                for (const auto &summary: summaries) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(summary.Name);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", summary.Calls);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", summary.Total);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", summary.Max);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        bool paused = false;
+        float zoom = 1.f;
+        std::optional<ProfileFrame> frame;
+        std::vector<ProfileThread> threads;
+        std::vector<Summary> summaries;
+    };
+}
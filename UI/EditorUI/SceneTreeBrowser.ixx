@@ -11,13 +11,14 @@ module;
 #include <vcruntime_typeinfo.h>
 export module CEngine.UI.EditorUI:SceneTreeBrowser;
 import std;
+import CEngine.Base;
 import CEngine.Engine;
 import CEngine.Node;
 
 namespace CEngine {
     export class SceneTreeBrowser {
     public:
-        Node *NodeSelected = nullptr;
+        Handle<Node> NodeSelected;
 
         SceneTreeBrowser() = default;
 
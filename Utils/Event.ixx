@@ -50,17 +50,19 @@ namespace CEngine {
         template<class T>
         Event &operator+=(std::tuple<T *, Res(T::*)(ArgTypes...)> t) {
             /* 类函数必须封装，不需要判断void */
-            Functions.push_back([t](ArgTypes... args) -> rRes {
-                if constexpr (std::is_base_of_v<Object, T>) {
-                    /* 如果是Object的子类，增加对象可用判断 */
-                    if (const auto obj_ptr = static_cast<Object *>(std::get<0>(t)); obj_ptr != nullptr && obj_ptr->IsValid())
-                        return {std::invoke(std::get<1>(t), std::get<0>(t), args...)};
+            if constexpr (std::is_base_of_v<Object, T>) {
+                /* 如果是Object的子类，保存句柄而非裸指针，调用前判断对象是否可用 */
+                Functions.push_back([handle = Handle<T>(std::get<0>(t)), func = std::get<1>(t)](ArgTypes... args) -> rRes {
+                    if (const auto obj_ptr = handle.Get(); obj_ptr != nullptr)
+                        return {std::invoke(func, obj_ptr, args...)};
                     return std::nullopt; // 对象不可用
-                } else {
-                    /* 不是Object的子类，直接执行 */
+                });
+            } else {
+                /* 不是Object的子类，直接执行 */
+                Functions.push_back([t](ArgTypes... args) -> rRes {
                     return {std::invoke(std::get<1>(t), std::get<0>(t), args...)};
-                }
-            });
+                });
+            }
             return *this;
         }
 
@@ -0,0 +1,194 @@
+/**
+ * @file Hash.ixx
+ * @brief 128位非加密哈希
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+export module CEngine.Hash;
+import std;
+
+namespace CEngine {
+    /// 128位哈希值
+    export struct Hash128 {
+        std::uint64_t Low = 0;
+        std::uint64_t High = 0;
+
+        bool operator==(const Hash128 &) const = default;
+
+        auto operator<=>(const Hash128 &) const = default;
+
+        bool IsZero() const { return Low == 0 && High == 0; }
+
+        /// 32位十六进制字符串（高位在前）
+        std::string ToString() const {
+            return std::format("{:016x}{:016x}", High, Low);
+        }
+    };
+
+    /// Hash128用于无序容器的哈希函数（哈希值本身已充分混合，直接折叠）
+    export struct Hash128Hasher {
+        std::size_t operator()(const Hash128 &hash) const noexcept {
+            return static_cast<std::size_t>(hash.Low ^ hash.High * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    /// 字符串的透明哈希函数，配合std::equal_to<>可用std::string_view、const char*查找而不构造std::string
+    export struct StringHasher {
+        using is_transparent = void;
+
+        std::size_t operator()(const std::string_view text) const noexcept {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    /**
+     * @brief 流式128位哈希
+     * @remark XXH3风格：8条64位通道按64字节条带累加（每通道32x32→64乘法，循环可被编译器向量化），\n
+     * 每16个条带打乱一次，结束时以两组不同的密钥折叠为128位并雪崩；非加密用途，勿用于安全校验
+     */
+    export class Hasher {
+    public:
+        static constexpr std::size_t StripeSize = 64;
+        static constexpr std::size_t Lanes = 8;
+
+        explicit Hasher(const std::uint64_t seed = 0) {
+            for (std::size_t i = 0; i < Lanes; ++i) {
+                Secret[i] = DefaultSecret[i] + (i % 2 == 0 ? seed : 0 - seed);
+                Accumulators[i] = InitialAccumulators[i];
+            }
+        }
+
+        /**
+         * 追加数据
+         * @param data 数据
+         * @param size 字节数
+         */
+        Hasher &Update(const void *data, std::size_t size) {
+            auto bytes = static_cast<const std::byte *>(data);
+            Length += size;
+            if (Buffered > 0) {
+                const auto fill = std::min(size, StripeSize - Buffered);
+                std::memcpy(Buffer.data() + Buffered, bytes, fill);
+                Buffered += fill;
+                bytes += fill;
+                size -= fill;
+                if (Buffered < StripeSize) return *this;
+                Accumulate(Buffer.data());
+                Buffered = 0;
+            }
+            for (; size >= StripeSize; bytes += StripeSize, size -= StripeSize)
+                Accumulate(bytes);
+            if (size > 0) {
+                std::memcpy(Buffer.data(), bytes, size);
+                Buffered = size;
+            }
+            return *this;
+        }
+
+        /// 追加平凡可复制的值
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        Hasher &UpdateValue(const T &value) {
+            return Update(&value, sizeof(T));
+        }
+
+        /// 追加字符串内容
+        Hasher &Update(const std::string_view text) {
+            return Update(text.data(), text.size());
+        }
+
+        /// 计算结果（不改变当前状态，可继续追加）
+        Hash128 Finish() const {
+            auto acc = Accumulators;
+            if (Buffered > 0) {
+                std::array<std::byte, StripeSize> tail{};
+                std::memcpy(tail.data(), Buffer.data(), Buffered);
+                AccumulateStripe(acc, tail.data(), Stripes);
+            }
+            std::uint64_t low = Length * Prime64_1, high = ~Length * Prime64_2;
+            for (std::size_t i = 0; i < Lanes; i += 2) {
+                low += Mul128Fold64(acc[i] ^ Secret[i], acc[i + 1] ^ Secret[i + 1]);
+                high += Mul128Fold64(acc[i] ^ Secret[(i + 3) % Lanes], acc[i + 1] ^ Secret[(i + 6) % Lanes]);
+            }
+            return {Avalanche(low), Avalanche(high + low)};
+        }
+
+        /// 一次性计算
+        static Hash128 Hash(const void *data, const std::size_t size, const std::uint64_t seed = 0) {
+            return Hasher(seed).Update(data, size).Finish();
+        }
+
+    private:
+        static constexpr std::uint64_t Prime32_1 = 0x9E3779B1ull;
+        static constexpr std::uint64_t Prime32_2 = 0x85EBCA77ull;
+        static constexpr std::uint64_t Prime32_3 = 0xC2B2AE3Dull;
+        static constexpr std::uint64_t Prime64_1 = 0x9E3779B185EBCA87ull;
+        static constexpr std::uint64_t Prime64_2 = 0xC2B2AE3D27D4EB4Full;
+        static constexpr std::uint64_t Prime64_3 = 0x165667B19E3779F9ull;
+        static constexpr std::uint64_t Prime64_4 = 0x85EBCA77C2B2AE63ull;
+        static constexpr std::uint64_t Prime64_5 = 0x27D4EB2F165667C5ull;
+        static constexpr std::array<std::uint64_t, Lanes> InitialAccumulators = {
+            Prime32_3, Prime64_1, Prime64_2, Prime64_3, Prime64_4, Prime32_2, Prime64_5, Prime32_1
+        };
+        /// 取自XXH3默认密钥的前64字节
+        static constexpr std::array<std::uint64_t, Lanes> DefaultSecret = {
+            0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull,
+            0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull
+        };
+        /// 每多少个条带打乱一次累加器
+        static constexpr std::uint64_t StripesPerScramble = 16;
+
+        static std::uint64_t Read64(const std::byte *p) {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            if constexpr (std::endian::native == std::endian::big) value = std::byteswap(value);
+            return value;
+        }
+
+        /// 64x64→128位乘法，高低位异或
+        static std::uint64_t Mul128Fold64(const std::uint64_t a, const std::uint64_t b) {
+            const std::uint64_t a_lo = a & 0xFFFFFFFFull, a_hi = a >> 32, b_lo = b & 0xFFFFFFFFull, b_hi = b >> 32;
+            const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+            const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFull) + lo_hi;
+            const std::uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+            const std::uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFull);
+            return lower ^ upper;
+        }
+
+        static std::uint64_t Avalanche(std::uint64_t h) {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ull;
+            h ^= h >> 32;
+            return h;
+        }
+
+        void AccumulateStripe(std::array<std::uint64_t, Lanes> &acc, const std::byte *stripe, const std::uint64_t index) const {
+            const auto rotate = index % Lanes;
+            for (std::size_t i = 0; i < Lanes; ++i) {
+                const auto value = Read64(stripe + i * 8);
+                const auto key = value ^ Secret[(i + rotate) % Lanes];
+                acc[i ^ 1] += value;
+                acc[i] += (key & 0xFFFFFFFFull) * (key >> 32);
+            }
+        }
+
+        void Accumulate(const std::byte *stripe) {
+            AccumulateStripe(Accumulators, stripe, Stripes);
+            if (++Stripes % StripesPerScramble == 0)
+                for (std::size_t i = 0; i < Lanes; ++i) {
+                    auto &acc = Accumulators[i];
+                    acc ^= acc >> 47;
+                    acc ^= Secret[i];
+                    acc *= Prime32_1;
+                }
+        }
+
+        std::array<std::uint64_t, Lanes> Secret{};
+        std::array<std::uint64_t, Lanes> Accumulators{};
+        std::array<std::byte, StripeSize> Buffer{};
+        std::size_t Buffered = 0;
+        std::uint64_t Stripes = 0;
+        std::uint64_t Length = 0;
+    };
+}
@@ -0,0 +1,123 @@
+/**
+ * @file MappedFile.ixx
+ * @brief 只读内存映射文件
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+export module CEngine.MappedFile;
+import std;
+
+namespace CEngine {
+    /**
+     * @brief 只读内存映射文件
+     * @remark 映射整个文件，析构时解除映射；空文件映射失败
+     */
+    export class MappedFile {
+    public:
+        MappedFile() = default;
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept {
+            *this = std::move(other);
+        }
+
+        MappedFile &operator=(MappedFile &&other) noexcept {
+            if (this == &other) return *this;
+            Close();
+            Data = std::exchange(other.Data, nullptr);
+            Size = std::exchange(other.Size, 0);
+#ifdef _WIN32
+            FileHandle = std::exchange(other.FileHandle, nullptr);
+            MappingHandle = std::exchange(other.MappingHandle, nullptr);
+#endif
+            return *this;
+        }
+
+        ~MappedFile() {
+            Close();
+        }
+
+        /**
+         * 映射文件
+         * @param path 文件路径
+         * @return 失败返回<code>std::nullopt</code>
+         */
+        static std::optional<MappedFile> Open(const std::filesystem::path &path) {
+            MappedFile file;
+#ifdef _WIN32
+            file.FileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file.FileHandle == INVALID_HANDLE_VALUE) {
+                file.FileHandle = nullptr;
+                return std::nullopt;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file.FileHandle, &size) || size.QuadPart == 0) return std::nullopt;
+            file.MappingHandle = CreateFileMappingW(file.FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (file.MappingHandle == nullptr) return std::nullopt;
+            file.Data = static_cast<const std::byte *>(MapViewOfFile(file.MappingHandle, FILE_MAP_READ, 0, 0, 0));
+            if (file.Data == nullptr) return std::nullopt;
+            file.Size = static_cast<std::size_t>(size.QuadPart);
+#else
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) return std::nullopt;
+            struct stat st{};
+            if (fstat(fd, &st) != 0 || st.st_size == 0) {
+                close(fd);
+                return std::nullopt;
+            }
+            void *data = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) return std::nullopt;
+            file.Data = static_cast<const std::byte *>(data);
+            file.Size = static_cast<std::size_t>(st.st_size);
+#endif
+            return file;
+        }
+
+        /// @property Data
+        const std::byte *data() const { return Data; }
+
+        /// @property Size
+        std::size_t size() const { return Size; }
+
+        bool IsOpen() const { return Data != nullptr; }
+
+        /// 解除映射
+        void Close() {
+#ifdef _WIN32
+            if (Data != nullptr) UnmapViewOfFile(Data);
+            if (MappingHandle != nullptr) CloseHandle(MappingHandle);
+            if (FileHandle != nullptr) CloseHandle(FileHandle);
+            MappingHandle = nullptr;
+            FileHandle = nullptr;
+#else
+            if (Data != nullptr) munmap(const_cast<std::byte *>(Data), Size);
+#endif
+            Data = nullptr;
+            Size = 0;
+        }
+
+    private:
+        const std::byte *Data = nullptr;
+        std::size_t Size = 0;
+#ifdef _WIN32
+        HANDLE FileHandle = nullptr;
+        HANDLE MappingHandle = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,485 @@
+/**
+ * @file ModelCooker.ixx
+ * @brief 模型烘焙（.cemodel）
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include <assimp/material.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+export module CEngine.ModelCooker;
+import std;
+import CEngine.Logger;
+import CEngine.Render;
+import CEngine.MappedFile;
+import CEngine.Hash;
+
+namespace CEngine {
+    /**
+     * @brief .cemodel文件头
+     * @remark 文件布局：Header | NodeRecord[] | 节点网格索引(uint32)[] | MeshRecord[] | MaterialRecord[] | TextureRecord[] | 字符串 | 数据\n
+     * 各段起始按SectionAlignment对齐；数据段中每个顶点/索引流同样对齐，可直接从映射上传
+     */
+    export struct CookedModelHeader {
+        char Magic[4] = {'C', 'E', 'M', 'D'};
+        std::uint32_t Version = 0;
+        std::uint32_t NodeCount = 0;
+        std::uint32_t NodeMeshCount = 0;
+        std::uint32_t MeshCount = 0;
+        std::uint32_t MaterialCount = 0;
+        std::uint32_t TextureCount = 0;
+        std::uint32_t Reserved = 0;
+        /// @brief 模型名称（字符串段中的偏移与长度）
+        std::uint32_t NameOffset = 0;
+        std::uint32_t NameLength = 0;
+        std::uint64_t NodesOffset = 0;
+        std::uint64_t NodeMeshesOffset = 0;
+        std::uint64_t MeshesOffset = 0;
+        std::uint64_t MaterialsOffset = 0;
+        std::uint64_t TexturesOffset = 0;
+        std::uint64_t StringsOffset = 0;
+        std::uint64_t StringsSize = 0;
+        std::uint64_t DataOffset = 0;
+        std::uint64_t DataSize = 0;
+    };
+
+    /**
+     * @brief 烘焙后的模型
+     * @remark 节点按先序排列（父节点在子节点之前），网格数据为已优化、已编码的顶点与索引流，\n
+     * 数据来自映射的.cemodel文件或内存，网格的MeshData直接指向其中
+     */
+    export class CookedModel {
+    public:
+        struct Node {
+            std::string Name;
+            /// @brief 父节点索引，根节点为-1
+            std::int32_t Parent = -1;
+            glm::mat4 Transform{1.0f};
+            /// @brief 引用的网格索引
+            std::vector<std::uint32_t> Meshes;
+        };
+
+        struct MeshEntry {
+            std::string Name;
+            /// @brief 材质索引
+            std::uint32_t Material = 0;
+            MeshData Data;
+        };
+
+        /// 段与数据流的对齐（字节）
+        static constexpr std::uint64_t SectionAlignment = 16;
+
+        CookedModel() = default;
+        CookedModel(CookedModel &&) noexcept = default;
+        CookedModel &operator=(CookedModel &&) noexcept = default;
+
+        /**
+         * 映射并校验.cemodel文件
+         * @param path 文件路径
+         * @param version 期望的版本
+         * @return 文件不存在或校验失败返回<code>std::nullopt</code>
+         */
+        static std::optional<CookedModel> Open(const std::filesystem::path &path, const std::uint32_t version) {
+            auto file = MappedFile::Open(path);
+            if (!file) return std::nullopt;
+            CookedModel model;
+            if (!model.Parse({file->data(), file->size()}, version)) return std::nullopt;
+            model.File = std::move(*file);
+            return model;
+        }
+
+        /**
+         * 解析内存中的.cemodel数据
+         * @param bytes Serialize的结果
+         * @param version 期望的版本
+         */
+        static std::optional<CookedModel> FromBytes(std::vector<std::byte> bytes, const std::uint32_t version) {
+            CookedModel model;
+            model.Owned = std::move(bytes);
+            if (!model.Parse(model.Owned, version)) return std::nullopt;
+            return model;
+        }
+
+        /**
+         * 序列化
+         * @param name 模型名称
+         * @param nodes 节点（先序）
+         * @param meshes 网格
+         * @param materials 材质描述
+         * @param version 格式版本
+         */
+        static std::vector<std::byte> Serialize(const std::string &name, const std::vector<Node> &nodes, const std::vector<MeshEntry> &meshes,
+                                                const std::vector<Material::Description> &materials, const std::uint32_t version) {
+            std::string strings;
+            const auto add_string = [&strings](const std::string &text) {
+                const StringRef ref{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(text.size())};
+                strings += text;
+                return ref;
+            };
+            CookedModelHeader header;
+            header.Version = version;
+            header.NodeCount = static_cast<std::uint32_t>(nodes.size());
+            header.MeshCount = static_cast<std::uint32_t>(meshes.size());
+            header.MaterialCount = static_cast<std::uint32_t>(materials.size());
+            const auto name_ref = add_string(name);
+            header.NameOffset = name_ref.Offset;
+            header.NameLength = name_ref.Length;
+            // 节点
+            std::vector<NodeRecord> node_records;
+            std::vector<std::uint32_t> node_meshes;
+            for (const auto &node: nodes) {
+                NodeRecord record;
+                record.Name = add_string(node.Name);
+                record.Parent = node.Parent;
+                record.FirstMesh = static_cast<std::uint32_t>(node_meshes.size());
+                record.MeshCount = static_cast<std::uint32_t>(node.Meshes.size());
+                std::memcpy(record.Transform, glm::value_ptr(node.Transform), sizeof(record.Transform));
+                node_meshes.insert(node_meshes.end(), node.Meshes.begin(), node.Meshes.end());
+                node_records.push_back(record);
+            }
+            header.NodeMeshCount = static_cast<std::uint32_t>(node_meshes.size());
+            // 网格（数据段偏移）
+            std::vector<MeshRecord> mesh_records;
+            std::uint64_t data_size = 0;
+            const auto place = [&data_size](const std::span<const std::byte> stream) {
+                const auto offset = data_size;
+                data_size = AlignUp(data_size + stream.size());
+                return offset;
+            };
+            for (const auto &mesh: meshes) {
+                MeshRecord record;
+                record.Name = add_string(mesh.Name);
+                record.Material = mesh.Material;
+                record.VertexCount = mesh.Data.VertexCount;
+                record.IndexCount = mesh.Data.IndexCount;
+                record.IndexSize = mesh.Data.IndexSize;
+                record.Position = static_cast<std::uint8_t>(mesh.Data.Layout.Position);
+                record.Normal = static_cast<std::uint8_t>(mesh.Data.Layout.Normal);
+                record.TexCoord = static_cast<std::uint8_t>(mesh.Data.Layout.TexCoord);
+                record.PositionStream = mesh.Data.Layout.PositionStream ? 1 : 0;
+                record.VerticesOffset = place(mesh.Data.Vertices);
+                record.VerticesSize = mesh.Data.Vertices.size();
+                record.PositionsOffset = place(mesh.Data.Positions);
+                record.PositionsSize = mesh.Data.Positions.size();
+                record.IndicesOffset = place(mesh.Data.Indices);
+                record.IndicesSize = mesh.Data.Indices.size();
+                std::memcpy(record.Dequantize, glm::value_ptr(mesh.Data.Dequantize), sizeof(record.Dequantize));
+                mesh_records.push_back(record);
+            }
+            // 材质
+            std::vector<MaterialRecord> material_records;
+            std::vector<TextureRecord> texture_records;
+            for (const auto &material: materials) {
+                MaterialRecord record;
+                record.FirstTexture = static_cast<std::uint32_t>(texture_records.size());
+                record.TextureCount = static_cast<std::uint32_t>(material.Textures.size());
+                record.Parameters = material.Parameters;
+                for (const auto &[type, path]: material.Textures)
+                    texture_records.push_back({static_cast<std::uint32_t>(type), add_string(path)});
+                material_records.push_back(record);
+            }
+            header.TextureCount = static_cast<std::uint32_t>(texture_records.size());
+            // 段布局
+            std::uint64_t offset = AlignUp(sizeof(CookedModelHeader));
+            const auto section = [&offset](const std::size_t size) {
+                const auto start = offset;
+                offset = AlignUp(offset + size);
+                return start;
+            };
+            header.NodesOffset = section(node_records.size() * sizeof(NodeRecord));
+            header.NodeMeshesOffset = section(node_meshes.size() * sizeof(std::uint32_t));
+            header.MeshesOffset = section(mesh_records.size() * sizeof(MeshRecord));
+            header.MaterialsOffset = section(material_records.size() * sizeof(MaterialRecord));
+            header.TexturesOffset = section(texture_records.size() * sizeof(TextureRecord));
+            header.StringsOffset = section(strings.size());
+            header.StringsSize = strings.size();
+            header.DataOffset = offset;
+            header.DataSize = data_size;
+            // 写入
+            std::vector<std::byte> bytes(header.DataOffset + header.DataSize);
+            const auto write = [&bytes](const std::uint64_t at, const void *data, const std::size_t size) {
+                if (size > 0) std::memcpy(bytes.data() + at, data, size);
+            };
+            write(0, &header, sizeof(header));
+            write(header.NodesOffset, node_records.data(), node_records.size() * sizeof(NodeRecord));
+            write(header.NodeMeshesOffset, node_meshes.data(), node_meshes.size() * sizeof(std::uint32_t));
+            write(header.MeshesOffset, mesh_records.data(), mesh_records.size() * sizeof(MeshRecord));
+            write(header.MaterialsOffset, material_records.data(), material_records.size() * sizeof(MaterialRecord));
+            write(header.TexturesOffset, texture_records.data(), texture_records.size() * sizeof(TextureRecord));
+            write(header.StringsOffset, strings.data(), strings.size());
+            for (std::size_t i = 0; i < meshes.size(); ++i) {
+                const auto &data = meshes[i].Data;
+                const auto &record = mesh_records[i];
+                write(header.DataOffset + record.VerticesOffset, data.Vertices.data(), data.Vertices.size());
+                write(header.DataOffset + record.PositionsOffset, data.Positions.data(), data.Positions.size());
+                write(header.DataOffset + record.IndicesOffset, data.Indices.data(), data.Indices.size());
+            }
+            return bytes;
+        }
+
+        /// 数据是否来自映射的文件
+        bool IsMapped() const { return File.IsOpen(); }
+
+        /// @property Name
+        const std::string &GetName() const { return Name; }
+
+        /// @property Nodes
+        const std::vector<Node> &GetNodes() const { return Nodes; }
+
+        /// @property Meshes
+        const std::vector<MeshEntry> &GetMeshes() const { return Meshes; }
+
+        /// @property Materials
+        const std::vector<Material::Description> &GetMaterials() const { return Materials; }
+
+        static std::uint64_t AlignUp(const std::uint64_t value) {
+            return (value + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+        }
+
+    private:
+        struct StringRef {
+            std::uint32_t Offset = 0;
+            std::uint32_t Length = 0;
+        };
+
+        struct NodeRecord {
+            StringRef Name;
+            std::int32_t Parent = -1;
+            std::uint32_t FirstMesh = 0;
+            std::uint32_t MeshCount = 0;
+            std::uint32_t Reserved = 0;
+            float Transform[16] = {};
+        };
+
+        struct MeshRecord {
+            StringRef Name;
+            std::uint32_t Material = 0;
+            std::uint32_t VertexCount = 0;
+            std::uint32_t IndexCount = 0;
+            std::uint32_t IndexSize = 0;
+            std::uint8_t Position = 0;
+            std::uint8_t Normal = 0;
+            std::uint8_t TexCoord = 0;
+            std::uint8_t PositionStream = 0;
+            std::uint32_t Reserved = 0;
+            /// @brief 相对于数据段起始的偏移（字节）
+            std::uint64_t VerticesOffset = 0;
+            std::uint64_t VerticesSize = 0;
+            std::uint64_t PositionsOffset = 0;
+            std::uint64_t PositionsSize = 0;
+            std::uint64_t IndicesOffset = 0;
+            std::uint64_t IndicesSize = 0;
+            float Dequantize[16] = {};
+        };
+
+        struct MaterialRecord {
+            std::uint32_t FirstTexture = 0;
+            std::uint32_t TextureCount = 0;
+            Material::MParameters Parameters;
+        };
+
+        struct TextureRecord {
+            /// @brief aiTextureType
+            std::uint32_t Type = 0;
+            StringRef Path;
+        };
+
+        /// 读取一段记录（越界返回<code>false</code>）
+        template<typename T>
+        static bool ReadRecords(const std::span<const std::byte> bytes, const std::uint64_t offset, const std::uint32_t count, std::vector<T> &out) {
+            if (offset > bytes.size() || static_cast<std::uint64_t>(count) * sizeof(T) > bytes.size() - offset) return false;
+            out.resize(count);
+            if (count > 0) std::memcpy(out.data(), bytes.data() + offset, count * sizeof(T));
+            return true;
+        }
+
+        /// 解析并校验，网格数据指向bytes
+        bool Parse(const std::span<const std::byte> bytes, const std::uint32_t version) {
+            if (bytes.size() < sizeof(CookedModelHeader)) return false;
+            CookedModelHeader header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if (std::memcmp(header.Magic, CookedModelHeader{}.Magic, sizeof(header.Magic)) != 0 || header.Version != version) return false;
+            if (header.StringsOffset > bytes.size() || header.StringsSize > bytes.size() - header.StringsOffset ||
+                header.DataOffset > bytes.size() || header.DataSize > bytes.size() - header.DataOffset)
+                return false;
+            std::vector<NodeRecord> node_records;
+            std::vector<std::uint32_t> node_meshes;
+            std::vector<MeshRecord> mesh_records;
+            std::vector<MaterialRecord> material_records;
+            std::vector<TextureRecord> texture_records;
+            if (!ReadRecords(bytes, header.NodesOffset, header.NodeCount, node_records) ||
+                !ReadRecords(bytes, header.NodeMeshesOffset, header.NodeMeshCount, node_meshes) ||
+                !ReadRecords(bytes, header.MeshesOffset, header.MeshCount, mesh_records) ||
+                !ReadRecords(bytes, header.MaterialsOffset, header.MaterialCount, material_records) ||
+                !ReadRecords(bytes, header.TexturesOffset, header.TextureCount, texture_records))
+                return false;
+            const auto strings = std::string_view(reinterpret_cast<const char *>(bytes.data() + header.StringsOffset), header.StringsSize);
+            bool valid = true;
+            const auto read_string = [&strings, &valid](const StringRef ref) {
+                if (ref.Offset > strings.size() || ref.Length > strings.size() - ref.Offset) {
+                    valid = false;
+                    return std::string();
+                }
+                return std::string(strings.substr(ref.Offset, ref.Length));
+            };
+            const auto data = bytes.subspan(header.DataOffset, header.DataSize);
+            const auto read_stream = [&data, &valid](const std::uint64_t offset, const std::uint64_t size) {
+                if (offset > data.size() || size > data.size() - offset) {
+                    valid = false;
+                    return std::span<const std::byte>();
+                }
+                return data.subspan(offset, size);
+            };
+            Name = read_string({header.NameOffset, header.NameLength});
+            Nodes.clear();
+            for (std::uint32_t i = 0; i < header.NodeCount; ++i) {
+                const auto &record = node_records[i];
+                if (record.Parent >= static_cast<std::int32_t>(i) || record.Parent < -1 || record.FirstMesh > node_meshes.size() ||
+                    record.MeshCount > node_meshes.size() - record.FirstMesh)
+                    return false;
+                Node node;
+                node.Name = read_string(record.Name);
+                node.Parent = record.Parent;
+                node.Transform = glm::make_mat4(record.Transform);
+                node.Meshes.assign(node_meshes.begin() + record.FirstMesh, node_meshes.begin() + record.FirstMesh + record.MeshCount);
+                if (std::ranges::any_of(node.Meshes, [&](const auto mesh) { return mesh >= header.MeshCount; })) return false;
+                Nodes.push_back(std::move(node));
+            }
+            Meshes.clear();
+            for (const auto &record: mesh_records) {
+                if (record.Position > 1 || record.Normal > 1 || record.TexCoord > 2 || record.Material >= std::max(header.MaterialCount, 1u) ||
+                    (record.IndexSize != 2 && record.IndexSize != 4))
+                    return false;
+                MeshEntry mesh;
+                mesh.Name = read_string(record.Name);
+                mesh.Material = record.Material;
+                auto &layout = mesh.Data.Layout;
+                layout.Position = static_cast<PositionFormat>(record.Position);
+                layout.Normal = static_cast<NormalFormat>(record.Normal);
+                layout.TexCoord = static_cast<TexCoordFormat>(record.TexCoord);
+                layout.PositionStream = record.PositionStream != 0;
+                mesh.Data.VertexCount = record.VertexCount;
+                mesh.Data.IndexCount = record.IndexCount;
+                mesh.Data.IndexSize = record.IndexSize;
+                mesh.Data.Vertices = read_stream(record.VerticesOffset, record.VerticesSize);
+                mesh.Data.Positions = read_stream(record.PositionsOffset, record.PositionsSize);
+                mesh.Data.Indices = read_stream(record.IndicesOffset, record.IndicesSize);
+                mesh.Data.Dequantize = glm::make_mat4(record.Dequantize);
+                if (record.VerticesSize != static_cast<std::uint64_t>(record.VertexCount) * layout.GetStride() ||
+                    record.IndicesSize != static_cast<std::uint64_t>(record.IndexCount) * record.IndexSize ||
+                    (record.PositionsSize != 0 && record.PositionsSize != static_cast<std::uint64_t>(record.VertexCount) * layout.GetPositionSize()))
+                    return false;
+                Meshes.push_back(std::move(mesh));
+            }
+            Materials.clear();
+            for (const auto &record: material_records) {
+                if (record.FirstTexture > texture_records.size() || record.TextureCount > texture_records.size() - record.FirstTexture) return false;
+                Material::Description material;
+                material.Parameters = record.Parameters;
+                for (std::uint32_t i = 0; i < record.TextureCount; ++i) {
+                    const auto &texture = texture_records[record.FirstTexture + i];
+                    material.Textures.emplace_back(static_cast<aiTextureType>(texture.Type), read_string(texture.Path));
+                }
+                Materials.push_back(std::move(material));
+            }
+            return valid;
+        }
+
+        MappedFile File;
+        std::vector<std::byte> Owned;
+        std::string Name;
+        std::vector<Node> Nodes;
+        std::vector<MeshEntry> Meshes;
+        std::vector<Material::Description> Materials;
+    };
+
+    /**
+     * @brief 模型烘焙器
+     * @remark 模型首次导入时把处理后的节点树、网格与材质写入.cemodel文件，\n
+     * 以源文件内容与导入选项的哈希命名保存在缓存目录中；再次导入时直接映射，不再经过Assimp
+     */
+    export class ModelCooker {
+    public:
+        const static char *TAG;
+
+        ModelCooker() = delete;
+
+        /// .cemodel格式版本，格式变化时递增以使旧缓存失效
+        static constexpr std::uint32_t Version = 1;
+
+        static void SetEnabled(const bool enabled) { Enabled = enabled; }
+
+        static bool IsEnabled() { return Enabled; }
+
+        /// @property CacheDirectory
+        static void SetCacheDirectory(const std::filesystem::path &dir) { CacheDirectory = dir; }
+
+        /// @property CacheDirectory
+        static const std::filesystem::path &GetCacheDirectory() { return CacheDirectory; }
+
+        /**
+         * 缓存名称
+         * @remark 影响烘焙结果的导入选项（网格优化、顶点压缩）参与命名
+         * @param hash 源文件内容的哈希
+         */
+        static std::string GetCacheName(const Hash128 &hash) {
+            const auto options = Hasher()
+                    .UpdateValue(MeshOptimizer::IsEnabled())
+                    .UpdateValue(VertexEncoder::IsEnabled())
+                    .UpdateValue(VertexEncoder::IsQuantizePositions())
+                    .UpdateValue(VertexEncoder::IsPositionStream())
+                    .Finish();
+            return std::format("{}_{:08x}", hash.ToString(), static_cast<std::uint32_t>(options.Low));
+        }
+
+        /// 缓存文件路径
+        static std::filesystem::path GetCachePath(const std::string &name) {
+            return CacheDirectory / (name + ".cemodel");
+        }
+
+        /**
+         * 写入文件
+         * @remark 先写入临时文件再重命名，写入中途失败不会留下损坏的缓存
+         * @param bytes CookedModel::Serialize的结果
+         * @param output 输出路径
+         * @return 是否成功
+         */
+        static bool Write(const std::vector<std::byte> &bytes, const std::filesystem::path &output) {
+            std::error_code ec;
+            std::filesystem::create_directories(output.parent_path(), ec);
+            auto temp = output;
+            temp += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                if (!out) {
+                    LogE(TAG) << "无法写入: " << temp.string();
+                    return false;
+                }
+                out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                if (!out) {
+                    LogE(TAG) << "写入失败: " << temp.string();
+                    out.close();
+                    std::filesystem::remove(temp, ec);
+                    return false;
+                }
+            }
+            std::filesystem::rename(temp, output, ec);
+            if (ec) {
+                std::filesystem::remove(temp, ec);
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        static bool Enabled;
+        static std::filesystem::path CacheDirectory;
+    };
+
+    const char *ModelCooker::TAG = "ModelCooker";
+    bool ModelCooker::Enabled = true;
+    std::filesystem::path ModelCooker::CacheDirectory = "Cache/Models";
+}
@@ -11,76 +11,374 @@ module;
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <glm/ext/matrix_transform.hpp>
+#include "Utils/Profiler.h"
 export module CEngine.ModelImporter;
 import std;
 import CEngine.Logger;
 import CEngine.Render;
+import CEngine.Image;
 import CEngine.Node;
 import CEngine.Utils;
+import CEngine.ModelCooker;
+import CEngine.ThreadPool;
+import CEngine.Profiler;
 
 namespace CEngine::ModelImporter {
     auto TAG = "ModelImporter";
 
-    void process_node(const aiNode *node, const aiScene *scene, Node3D *parent, ShaderProgram *shader_program, const char *model_path,
-                      const float transform_scale = 1.0f) {
+    /// 先序收集节点，父节点在子节点之前
+    void collect_node(const aiNode *node, const std::int32_t parent, std::vector<CookedModel::Node> &nodes) {
+        CookedModel::Node cooked;
+        cooked.Name = node->mName.data;
+        cooked.Parent = parent;
+        cooked.Transform = Utils::aiMatrix4x4ToGlmMat4(node->mTransformation);
+        cooked.Meshes.assign(node->mMeshes, node->mMeshes + node->mNumMeshes);
+        const auto index = static_cast<std::int32_t>(nodes.size());
+        nodes.push_back(std::move(cooked));
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+            collect_node(node->mChildren[i], index, nodes);
+    }
+
+    /// 读取、优化并编码网格
+    EncodedMesh process_mesh(const aiMesh *mesh) {
+        CE_PROFILE_ZONE("ModelImporter::process_mesh");
+        std::vector<VertexInfo> vertices;
+        std::vector<unsigned int> indices;
+        vertices.reserve(mesh->mNumVertices);
+        indices.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 3);
+        for (unsigned int j = 0; j < mesh->mNumVertices; j++) {
+            VertexInfo vertex;
+            vertex.Position = {mesh->mVertices[j].x, mesh->mVertices[j].y, mesh->mVertices[j].z};
+            vertex.Normal = {mesh->mNormals[j].x, mesh->mNormals[j].y, mesh->mNormals[j].z};
+            if (mesh->mTextureCoords[0])
+                vertex.TexCoord = {mesh->mTextureCoords[0][j].x, mesh->mTextureCoords[0][j].y};
+            else
+                vertex.TexCoord = {0.0f, 0.0f};
+            vertices.push_back(vertex);
+        }
+        for (unsigned int j = 0; j < mesh->mNumFaces; j++) {
+            const aiFace face = mesh->mFaces[j];
+            for (unsigned int k = 0; k < face.mNumIndices; k++)
+                indices.push_back(face.mIndices[k]);
+        }
+        if (MeshOptimizer::IsEnabled()) {
+            const auto stats = MeshOptimizer::Optimize(vertices, indices);
+            LogD(TAG) << "网格优化: " << mesh->mName.data << " (顶点: " << stats.VerticesBefore << " -> " << stats.VerticesAfter
+                      << ", ACMR: " << stats.ACMRBefore << " -> " << stats.ACMRAfter << ", 过度绘制排序簇: " << stats.OverdrawClusters << ")";
+        }
+        return Mesh::Encode(vertices, indices, VertexEncoder::ChooseLayout(vertices));
+    }
+
+    /**
+     * 经Assimp导入并烘焙
+     * @param file_path 模型文件路径
+     * @param cache_path 缓存文件路径（为空时不写入）
+     * @param mesh_count 输出网格总数（可为空）
+     * @param progress 已处理的网格数（可为空）
+     */
+    std::optional<CookedModel> cook_model(const char *file_path, const std::filesystem::path &cache_path, std::atomic<std::size_t> *mesh_count = nullptr,
+                                          std::atomic<std::size_t> *progress = nullptr) {
+        CE_PROFILE_ZONE("ModelImporter::cook_model");
+        Assimp::Importer importer;
+        const aiScene *scene = importer.ReadFile(file_path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals);
+        if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            LogE(TAG) << importer.GetErrorString();
+            return std::nullopt;
+        }
+        if (mesh_count != nullptr) mesh_count->store(scene->mNumMeshes);
+        std::vector<CookedModel::Node> nodes;
+        collect_node(scene->mRootNode, -1, nodes);
+        // 各网格的转换、优化与编码互不依赖，并行处理
+        std::vector<EncodedMesh> encoded(scene->mNumMeshes);
+        ThreadPool::Global().ParallelFor(scene->mNumMeshes, [&](const std::size_t i) {
+            encoded[i] = process_mesh(scene->mMeshes[i]);
+            if (progress != nullptr) progress->fetch_add(1, std::memory_order_relaxed);
+        });
+        std::vector<CookedModel::MeshEntry> meshes;
+        meshes.reserve(scene->mNumMeshes);
+        for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+            meshes.push_back({scene->mMeshes[i]->mName.data, scene->mMeshes[i]->mMaterialIndex, encoded[i].View()});
+        std::vector<Material::Description> materials;
+        materials.reserve(scene->mNumMaterials);
+        for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+            materials.push_back(Material::DescribeAssimpMaterial(scene->mMaterials[i]));
+        auto bytes = CookedModel::Serialize(scene->mName.data, nodes, meshes, materials, ModelCooker::Version);
+        if (!cache_path.empty()) {
+            if (ModelCooker::Write(bytes, cache_path)) {
+                LogI(TAG) << "写入模型缓存: " << cache_path.string();
+                if (auto mapped = CookedModel::Open(cache_path, ModelCooker::Version)) return mapped;
+            } else
+                LogW(TAG) << "模型缓存写入失败: " << cache_path.string();
+        }
+        return CookedModel::FromBytes(std::move(bytes), ModelCooker::Version);
+    }
+
+    /**
+     * @brief 逐步构建的节点树
+     * @remark 烘焙数据中的节点按前序排列，父节点总在子节点之前，按下标依次创建即可，无需查找子节点
+     */
+    struct ModelBuilder {
+        Node3D *Root = nullptr;
+        /// @brief 已创建的节点，下标与烘焙数据中的节点相同
+        std::vector<Node3D *> Nodes;
+
+        bool IsDone(const CookedModel &model) const { return Nodes.size() == model.GetNodes().size(); }
+    };
+
+    /// 创建根节点，开始构建
+    ModelBuilder begin_model(const CookedModel &model) {
+        ModelBuilder builder;
+        builder.Root = Node3D::Create();
+        builder.Root->setName(model.GetName());
+        builder.Nodes.reserve(model.GetNodes().size());
+        return builder;
+    }
+
+    /// 创建下一个节点及其渲染单位与材质，挂到已创建的父节点下（需在渲染线程调用）
+    void build_node(const CookedModel &model, ModelBuilder &builder, const std::vector<Mesh *> &meshes, ShaderProgram *shader_program,
+                    const char *model_path, const float transform_scale) {
+        const auto index = builder.Nodes.size();
+        const auto &node = model.GetNodes()[index];
+        const auto &materials = model.GetMaterials();
         auto n3d = Node3D::Create();
-        n3d->setName(node->mName.data);
-        if (transform_scale == 1.0f)
-            n3d->SetModelMatrix(Utils::aiMatrix4x4ToGlmMat4(node->mTransformation));
+        n3d->setName(node.Name);
+        // 缩放只作用于模型的根节点
+        if (index != 0 || transform_scale == 1.0f)
+            n3d->SetModelMatrix(node.Transform);
         else
-            n3d->SetModelMatrix(glm::scale(Utils::aiMatrix4x4ToGlmMat4(node->mTransformation), glm::vec3(transform_scale)));
-        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-            const aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-            std::vector<VertexInfo> vertices;
-            std::vector<unsigned int> indices;
-            for (unsigned int j = 0; j < mesh->mNumVertices; j++) {
-                VertexInfo vertex;
-                vertex.Position = {mesh->mVertices[j].x, mesh->mVertices[j].y, mesh->mVertices[j].z};
-                vertex.Normal = {mesh->mNormals[j].x, mesh->mNormals[j].y, mesh->mNormals[j].z};
-                if (mesh->mTextureCoords[0])
-                    vertex.TexCoord = {mesh->mTextureCoords[0][j].x, mesh->mTextureCoords[0][j].y};
-                else
-                    vertex.TexCoord = {0.0f, 0.0f};
-                vertices.push_back(vertex);
-            }
-            for (unsigned int j = 0; j < mesh->mNumFaces; j++) {
-                const aiFace face = mesh->mFaces[j];
-                for (unsigned int k = 0; k < face.mNumIndices; k++)
-                    indices.push_back(face.mIndices[k]);
-            }
-            const auto m = Mesh::Create(vertices, indices);
-            m->Name = mesh->mName.data;
-            LogS(TAG) << "导入网格: " << m->Name;
-            if (shader_program == nullptr || shader_program == ShaderProgram::All_Instances["Base"]) {
-                const auto ru3d = RenderUnit3D::Create(m, ShaderProgram::All_Instances["Base"]);
+            n3d->SetModelMatrix(glm::scale(node.Transform, glm::vec3(transform_scale)));
+        for (const auto mesh_index: node.Meshes) {
+            const auto m = meshes[mesh_index];
+            if (shader_program == nullptr || shader_program == ShaderProgram::Find("Base")) {
+                const auto ru3d = RenderUnit3D::Create(m, ShaderProgram::Find("Base"));
                 n3d->AddChild(ru3d);
             } else {
-                const auto pbr3d = PBR3D::Create(m, Material::ProcessAssimpMaterial(scene->mMaterials[mesh->mMaterialIndex], model_path), shader_program);
+                const auto material_index = model.GetMeshes()[mesh_index].Material;
+                const auto material = material_index < materials.size()
+                                          ? Material::FromDescription(materials[material_index], model_path)
+                                          : Material::FromDescription({}, model_path);
+                const auto pbr3d = PBR3D::Create(m, material, shader_program);
                 n3d->AddChild(pbr3d);
             }
         }
-        for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            process_node(node->mChildren[i], scene, n3d, shader_program, model_path);
+        const auto parent = node.Parent >= 0 && static_cast<std::size_t>(node.Parent) < index ? builder.Nodes[node.Parent] : builder.Root;
+        parent->AddChild(n3d);
+        builder.Nodes.push_back(n3d);
+    }
+
+    /**
+     * 读取模型数据
+     * @remark 优先映射缓存，未命中时经Assimp导入并烘焙；不涉及OpenGL，可在工作线程中调用
+     */
+    std::optional<CookedModel> load_model(const char *file_path, std::atomic<std::size_t> *mesh_count = nullptr,
+                                          std::atomic<std::size_t> *progress = nullptr) {
+        CE_PROFILE_ZONE("ModelImporter::load_model");
+        // 以源文件内容与导入选项命名的缓存，命中时不经过Assimp
+        std::filesystem::path cache_path;
+        if (ModelCooker::IsEnabled()) {
+            if (const auto hash = TextureCooker::HashFile(file_path)) {
+                cache_path = ModelCooker::GetCachePath(ModelCooker::GetCacheName(*hash));
+                if (auto model = CookedModel::Open(cache_path, ModelCooker::Version)) {
+                    LogI(TAG) << "使用模型缓存: " << cache_path.string();
+                    if (mesh_count != nullptr) mesh_count->store(model->GetMeshes().size());
+                    if (progress != nullptr) progress->store(model->GetMeshes().size());
+                    return model;
+                }
+            }
+        }
+        auto model = cook_model(file_path, cache_path, mesh_count, progress);
+        if (model && model->GetNodes().empty()) {
+            LogE(TAG) << "模型没有节点: " << file_path;
+            return std::nullopt;
         }
-        parent->AddChild(std::move(n3d));
+        return model;
+    }
+
+    /// 创建网格（需在渲染线程调用）
+    Mesh *create_mesh(const CookedModel::MeshEntry &entry) {
+        const auto m = Mesh::Create(entry.Data);
+        m->Name = entry.Name;
+        LogS(TAG) << "导入网格: " << m->Name;
+        return m;
+    }
+
+    /// 由烘焙数据与已创建的网格构建根节点（需在渲染线程调用）
+    Node3D *build_model(const CookedModel &model, const std::vector<Mesh *> &meshes, ShaderProgram *shader_program, const char *model_path,
+                        const float transform_scale) {
+        auto builder = begin_model(model);
+        while (!builder.IsDone(model))
+            build_node(model, builder, meshes, shader_program, model_path, transform_scale);
+        return builder.Root;
+    }
+
+    float get_transform_scale(const char *file_path, const float transform_scale) {
+        return Utils::c_str_ends_with(file_path, ".fbx") ? 0.1f : transform_scale;
     }
 
     export Node3D *import_model(const char *file_path, ShaderProgram *shader_program = nullptr, float transform_scale = 1.0f) {
+        CE_PROFILE_ZONE("ModelImporter::import_model");
         if (!std::filesystem::exists(file_path)) {
             LogE(TAG) << "文件不存在: " << file_path;
             return nullptr;
         }
         LogI(TAG) << "开始导入模型: " << file_path;
-        if (Utils::c_str_ends_with(file_path, ".fbx")) transform_scale = 0.1f;
-        Assimp::Importer importer;
-        const aiScene *scene = importer.ReadFile(file_path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals);
-        if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            LogE(TAG) << importer.GetErrorString();
+        transform_scale = get_transform_scale(file_path, transform_scale);
+        const auto model = load_model(file_path);
+        if (!model) return nullptr;
+        // 每个网格仅上传一次，被多个节点引用时共享
+        std::vector<Mesh *> meshes;
+        meshes.reserve(model->GetMeshes().size());
+        for (const auto &entry: model->GetMeshes())
+            meshes.push_back(create_mesh(entry));
+        return build_model(*model, meshes, shader_program, file_path, transform_scale);
+    }
+
+    export class ImportHandle;
+    export std::shared_ptr<ImportHandle> import_model_async(const char *file_path, ShaderProgram *shader_program = nullptr, float transform_scale = 1.0f,
+                                                            std::function<void(Node3D *)> on_complete = {});
+    export void process_imports(double budget_ms);
+
+    /**
+     * @brief 异步导入的句柄
+     * @remark 由import_model_async返回，可在任意时刻查询进度；完成后GetResult返回模型根节点
+     */
+    export class ImportHandle {
+    public:
+        enum class ImportState {
+            /// 读取、转换与优化中（工作线程）
+            Loading,
+            /// 等待在渲染线程创建网格
+            Uploading,
+            Done,
+            Failed
+        };
+
+        ImportHandle(std::string path, ShaderProgram *shader_program, const float transform_scale, std::function<void(Node3D *)> on_complete)
+            : Path(std::move(path)), Shader(shader_program), TransformScale(transform_scale), OnComplete(std::move(on_complete)) {
+        }
+
+        /// @property State
+        ImportState GetState() const { return State.load(std::memory_order_acquire); }
+
+        bool IsDone() const { return GetState() == ImportState::Done || GetState() == ImportState::Failed; }
+
+        /**
+         * 进度
+         * @remark 网格的处理与创建各占一半
+         * @return 0到1
+         */
+        float GetProgress() const {
+            if (IsDone()) return 1.0f;
+            const auto total = MeshCount.load(std::memory_order_relaxed);
+            if (total == 0) return 0.0f;
+            const auto processed = std::min(Processed.load(std::memory_order_relaxed), total);
+            return static_cast<float>(processed + Created) / static_cast<float>(total * 2);
+        }
+
+        /// @property Path
+        const std::string &GetPath() const { return Path; }
+
+        /// 模型根节点（完成前或失败时为<code>nullptr</code>）
+        Node3D *GetResult() const { return GetState() == ImportState::Done ? Result : nullptr; }
+
+    private:
+        friend std::shared_ptr<ImportHandle> import_model_async(const char *, ShaderProgram *, float, std::function<void(Node3D *)>);
+        friend void process_imports(double);
+
+        std::string Path;
+        ShaderProgram *Shader;
+        float TransformScale;
+        std::function<void(Node3D *)> OnComplete;
+        std::atomic<ImportState> State = ImportState::Loading;
+        std::atomic<std::size_t> MeshCount = 0;
+        std::atomic<std::size_t> Processed = 0;
+        /// @brief 工作线程写入，State变为Uploading后由渲染线程独占
+        std::optional<CookedModel> Model;
+        /// 以下仅在渲染线程访问
+        std::vector<Mesh *> Meshes;
+        std::size_t Created = 0;
+        ModelBuilder Builder;
+        Node3D *Result = nullptr;
+    };
+
+    /// 进行中的异步导入（仅在渲染线程访问）
+    std::vector<std::shared_ptr<ImportHandle> > PendingImports;
+
+    /**
+     * 异步导入模型
+     * @remark 读取缓存或经Assimp导入、网格转换与优化在线程池中并行进行；\n
+     * 网格、节点与材质由<code>process_imports</code>在渲染线程按时间预算创建，材质纹理经Texture::FromFileAsync异步加载；\n
+     * 需在渲染线程调用
+     * @param file_path 模型文件路径
+     * @param shader_program 着色器（为空时使用Base）
+     * @param transform_scale 根节点缩放
+     * @param on_complete 完成时在渲染线程以模型根节点调用（失败时为<code>nullptr</code>）
+     * @return 文件不存在返回<code>nullptr</code>
+     */
+    std::shared_ptr<ImportHandle> import_model_async(const char *file_path, ShaderProgram *shader_program, const float transform_scale,
+                                                     std::function<void(Node3D *)> on_complete) {
+        if (!std::filesystem::exists(file_path)) {
+            LogE(TAG) << "文件不存在: " << file_path;
             return nullptr;
         }
-        const auto node = Node3D::Create();
-        node->setName(scene->mName.data);
-        process_node(scene->mRootNode, scene, node, shader_program, file_path, transform_scale);
-        return node;
+        LogI(TAG) << "开始异步导入模型: " << file_path;
+        auto handle = std::make_shared<ImportHandle>(file_path, shader_program, get_transform_scale(file_path, transform_scale), std::move(on_complete));
+        PendingImports.push_back(handle);
+        ThreadPool::Global().Submit([handle] {
+            handle->Model = load_model(handle->Path.c_str(), &handle->MeshCount, &handle->Processed);
+            handle->State.store(handle->Model ? ImportHandle::ImportState::Uploading : ImportHandle::ImportState::Failed, std::memory_order_release);
+        });
+        return handle;
+    }
+
+    /**
+     * 处理异步导入
+     * @remark 在渲染线程每帧调用一次：在时间预算内为读取完成的模型依次创建网格、节点与材质（每帧至少一项），\n
+     * 全部创建后调用完成回调
+     * @param budget_ms 每帧的时间预算（毫秒）
+     */
+    void process_imports(const double budget_ms) {
+        CE_PROFILE_ZONE("ModelImporter::process_imports");
+        const auto start = std::chrono::steady_clock::now();
+        bool first = true;
+        const auto has_time = [&] {
+            return first || std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < budget_ms;
+        };
+        std::erase_if(PendingImports, [&](const std::shared_ptr<ImportHandle> &handle) {
+            const auto state = handle->GetState();
+            if (state == ImportHandle::ImportState::Failed) {
+                LogE(TAG) << "模型导入失败: " << handle->Path;
+                if (handle->OnComplete) handle->OnComplete(nullptr);
+                return true;
+            }
+            if (state != ImportHandle::ImportState::Uploading) return false;
+            const auto &entries = handle->Model->GetMeshes();
+            handle->Meshes.reserve(entries.size());
+            while (handle->Created < entries.size() && has_time()) {
+                handle->Meshes.push_back(create_mesh(entries[handle->Created]));
+                ++handle->Created;
+                first = false;
+            }
+            if (handle->Created < entries.size()) return false;
+            // 节点与材质同样按时间预算创建
+            if (handle->Builder.Root == nullptr) handle->Builder = begin_model(*handle->Model);
+            while (!handle->Builder.IsDone(*handle->Model) && has_time()) {
+                build_node(*handle->Model, handle->Builder, handle->Meshes, handle->Shader, handle->Path.c_str(), handle->TransformScale);
+                first = false;
+            }
+            if (!handle->Builder.IsDone(*handle->Model)) return false;
+            handle->Result = handle->Builder.Root;
+            // 网格已上传，释放映射
+            handle->Model.reset();
+            handle->State.store(ImportHandle::ImportState::Done, std::memory_order_release);
+            LogI(TAG) << "模型导入完成: " << handle->Path;
+            if (handle->OnComplete) handle->OnComplete(handle->Result);
+            return true;
+        });
+    }
+
+    /// 进行中的异步导入数
+    export std::size_t get_pending_imports() {
+        return PendingImports.size();
     }
 }
@@ -0,0 +1,34 @@
+/**
+ * @file Profiler.h
+ * @brief CPU性能分析宏
+ * @remark 模块无法导出宏，使用处在全局模块片段中包含本文件并导入CEngine.Profiler；\n
+ * 未定义CE_PROFILER时所有宏展开为空，不产生任何代码
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#ifdef CE_PROFILER
+
+#define CE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CE_PROFILE_CONCAT(a, b) CE_PROFILE_CONCAT_IMPL(a, b)
+
+/// 计时至作用域结束，name须为静态存储的字符串
+#define CE_PROFILE_ZONE(name) const ::CEngine::ProfileZone CE_PROFILE_CONCAT(ce_profile_zone_, __LINE__)(name)
+/// 标记帧开始（主线程）
+#define CE_PROFILE_FRAME_BEGIN() ::CEngine::Profiler::BeginFrame()
+/// 标记帧结束（主线程）
+#define CE_PROFILE_FRAME_END() ::CEngine::Profiler::EndFrame()
+/// 命名当前线程，name须为静态存储的字符串
+#define CE_PROFILE_THREAD(name) ::CEngine::Profiler::SetThreadName(name)
+
+#else
+
+#define CE_PROFILE_ZONE(name) ((void) 0)
+#define CE_PROFILE_FRAME_BEGIN() ((void) 0)
+#define CE_PROFILE_FRAME_END() ((void) 0)
+#define CE_PROFILE_THREAD(name) ((void) 0)
+
+#endif
@@ -0,0 +1,276 @@
+/**
+ * @file Profiler.ixx
+ * @brief CPU性能分析
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+export module CEngine.Profiler;
+import std;
+import CEngine.Logger;
+
+namespace CEngine {
+    /// 一个计时区间
+    export struct ProfileEvent {
+        /// @brief 名称（静态存储）
+        const char *Name = nullptr;
+        /// @brief 开始与结束时间（ns，见Profiler::Now）
+        std::int64_t Start = 0;
+        std::int64_t End = 0;
+        /// @brief 嵌套深度
+        std::uint32_t Depth = 0;
+    };
+
+    /// 一个线程在某段时间内的计时区间
+    export struct ProfileThread {
+        std::uint32_t Id = 0;
+        std::string Name;
+        /// @brief 按开始时间排列
+        std::vector<ProfileEvent> Events;
+    };
+
+    /// 一帧的时间范围
+    export struct ProfileFrame {
+        std::uint64_t Number = 0;
+        std::int64_t Start = 0;
+        std::int64_t End = 0;
+    };
+
+    /**
+     * @brief CPU性能分析器
+     * @remark 计时区间（ProfileZone，通常经Profiler.h中的CE_PROFILE_ZONE宏使用）结束时写入所在线程的环形缓冲，\n
+     * 写入不加锁，缓冲满时覆盖最早的区间；读取（Collect/ExportChromeTrace）时复制各线程的缓冲并丢弃读取期间被覆盖的部分；\n
+     * 时间戳取自std::chrono::steady_clock
+     */
+    export class Profiler {
+    public:
+        const static char *TAG;
+
+        Profiler() = delete;
+
+        /// 是否编译了计时宏（CE_PROFILER）
+        static constexpr bool CompiledIn =
+#ifdef CE_PROFILER
+                true;
+#else
+                false;
+#endif
+
+        /// 每个线程保留的区间数
+        static constexpr std::size_t ThreadCapacity = 1u << 16;
+        /// 保留的帧数
+        static constexpr std::size_t FrameHistory = 256;
+
+        /// 是否记录（运行时开关）
+        static void SetEnabled(const bool enabled) { Enabled.store(enabled, std::memory_order_relaxed); }
+
+        static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+        /// 当前时间（ns，自进程内首次调用起）
+        static std::int64_t Now() {
+            static const auto origin = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+        }
+
+        /// 命名当前线程
+        static void SetThreadName(const char *name) {
+            auto &buffer = Local();
+            std::lock_guard lock(RegistryMutex);
+            buffer.Name = name;
+        }
+
+        /// 标记帧开始
+        static void BeginFrame() {
+            FrameStart = Now();
+        }
+
+        /// 标记帧结束
+        static void EndFrame() {
+            const auto end = Now();
+            std::lock_guard lock(FramesMutex);
+            Frames[FrameCount % FrameHistory] = {FrameCount + 1, FrameStart, end};
+            ++FrameCount;
+        }
+
+        /// 写入当前线程的环形缓冲（由ProfileZone调用）
+        static void Record(const char *name, const std::int64_t start, const std::int64_t end, const std::uint32_t depth) {
+            auto &buffer = Local();
+            const auto head = buffer.Head.load(std::memory_order_relaxed);
+            buffer.Events[head % ThreadCapacity] = {name, start, end, depth};
+            buffer.Head.store(head + 1, std::memory_order_release);
+        }
+
+        /// 当前线程的嵌套深度（由ProfileZone维护）
+        static std::uint32_t &Depth() { return Local().Depth; }
+
+        /// 最近完成的一帧
+        static std::optional<ProfileFrame> GetLastFrame() {
+            std::lock_guard lock(FramesMutex);
+            if (FrameCount == 0) return std::nullopt;
+            return Frames[(FrameCount - 1) % FrameHistory];
+        }
+
+        /// 保留的帧（从早到晚）
+        static std::vector<ProfileFrame> GetFrames() {
+            std::lock_guard lock(FramesMutex);
+            std::vector<ProfileFrame> frames;
+            for (auto i = FrameCount > FrameHistory ? FrameCount - FrameHistory : 0; i < FrameCount; ++i)
+                frames.push_back(Frames[i % FrameHistory]);
+            return frames;
+        }
+
+        /**
+         * 复制与时间范围相交的区间
+         * @param from 开始时间（ns）
+         * @param to 结束时间（ns）
+         * @return 每个有区间的线程一项，按线程Id排列
+         */
+        static std::vector<ProfileThread> Collect(const std::int64_t from = std::numeric_limits<std::int64_t>::min(),
+                                                  const std::int64_t to = std::numeric_limits<std::int64_t>::max()) {
+            std::vector<ProfileThread> threads;
+            std::lock_guard lock(RegistryMutex);
+            for (const auto &buffer: Buffers) {
+                ProfileThread thread{buffer->Id, buffer->Name.empty() ? std::format("Thread {}", buffer->Id) : buffer->Name};
+                const auto head = buffer->Head.load(std::memory_order_acquire);
+                std::vector<std::pair<std::uint64_t, ProfileEvent> > copied;
+                for (auto i = head > ThreadCapacity ? head - ThreadCapacity : 0; i < head; ++i)
+                    if (const auto &event = buffer->Events[i % ThreadCapacity]; event.End >= from && event.Start <= to)
+                        copied.emplace_back(i, event);
+                // 读取期间被覆盖的区间不可信
+                const auto after = buffer->Head.load(std::memory_order_acquire);
+                const auto valid_from = after > ThreadCapacity ? after - ThreadCapacity + 1 : 0;
+                for (const auto &[index, event]: copied)
+                    if (index >= valid_from) thread.Events.push_back(event);
+                if (thread.Events.empty()) continue;
+                std::ranges::sort(thread.Events, [](const ProfileEvent &a, const ProfileEvent &b) {
+                    return a.Start != b.Start ? a.Start < b.Start : a.Depth < b.Depth;
+                });
+                threads.push_back(std::move(thread));
+            }
+            return threads;
+        }
+
+        /**
+         * 导出为Chrome Trace（chrome://tracing、Perfetto可打开）
+         * @remark 导出所有线程缓冲中的区间（"X"事件）与帧（实例事件"i"）
+         * @param path 输出路径
+         * @return 是否成功
+         */
+        static bool ExportChromeTrace(const std::filesystem::path &path) {
+            const auto threads = Collect();
+            const auto frames = GetFrames();
+            std::ofstream out(path, std::ios::trunc);
+            if (!out) {
+                LogE(TAG) << "无法写入: " << path.string();
+                return false;
+            }
+            const auto us = [](const std::int64_t ns) { return std::format("{:.3f}", static_cast<double>(ns) / 1000.0); };
+            out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            bool first = true;
+            const auto separator = [&] {
+                if (!first) out << ",";
+                first = false;
+                out << "\n";
+            };
+            for (const auto &thread: threads) {
+                separator();
+                out << std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", thread.Id, Escape(thread.Name));
+                for (const auto &event: thread.Events) {
+                    separator();
+                    out << std::format(R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{},"dur":{}}})", Escape(event.Name), thread.Id, us(event.Start),
+                                       us(event.End - event.Start));
+                }
+            }
+            for (const auto &frame: frames) {
+                separator();
+                out << std::format(R"({{"name":"Frame {}","ph":"i","s":"g","pid":1,"tid":0,"ts":{}}})", frame.Number, us(frame.Start));
+            }
+            out << "\n]}\n";
+            if (!out) {
+                LogE(TAG) << "写入失败: " << path.string();
+                return false;
+            }
+            LogS(TAG) << "导出Chrome Trace: " << path.string();
+            return true;
+        }
+
+    private:
+        struct ThreadBuffer {
+            std::uint32_t Id = 0;
+            std::string Name;
+            /// @brief 仅所属线程访问
+            std::uint32_t Depth = 0;
+            std::atomic<std::uint64_t> Head = 0;
+            std::unique_ptr<ProfileEvent[]> Events = std::make_unique<ProfileEvent[]>(ThreadCapacity);
+        };
+
+        /// 当前线程的缓冲（首次使用时注册，线程退出后保留）
+        static ThreadBuffer &Local() {
+            thread_local const auto buffer = [] {
+                auto created = std::make_shared<ThreadBuffer>();
+                std::lock_guard lock(RegistryMutex);
+                created->Id = static_cast<std::uint32_t>(Buffers.size() + 1);
+                Buffers.push_back(created);
+                return created;
+            }();
+            return *buffer;
+        }
+
+        /// JSON字符串转义
+        static std::string Escape(const std::string_view text) {
+            std::string escaped;
+            for (const auto c: text) {
+                if (c == '"' || c == '\\') escaped += '\\';
+                if (static_cast<unsigned char>(c) < 0x20) escaped += std::format("\\u{:04x}", static_cast<int>(c));
+                else escaped += c;
+            }
+            return escaped;
+        }
+
+        static std::atomic<bool> Enabled;
+        static std::mutex RegistryMutex;
+        static std::vector<std::shared_ptr<ThreadBuffer> > Buffers;
+        static std::mutex FramesMutex;
+        static std::array<ProfileFrame, FrameHistory> Frames;
+        static std::uint64_t FrameCount;
+        static std::int64_t FrameStart;
+    };
+
+    /**
+     * @brief 计时区间
+     * @remark 构造时记录开始时间，析构时写入当前线程的缓冲；构造时未启用则不记录
+     */
+    export class ProfileZone {
+    public:
+        explicit ProfileZone(const char *name) : Name(name) {
+            if (!Profiler::IsEnabled()) return;
+            Depth = Profiler::Depth()++;
+            Start = Profiler::Now();
+        }
+
+        ~ProfileZone() {
+            if (Start < 0) return;
+            const auto end = Profiler::Now();
+            --Profiler::Depth();
+            Profiler::Record(Name, Start, end, Depth);
+        }
+
+        ProfileZone(const ProfileZone &) = delete;
+        ProfileZone &operator=(const ProfileZone &) = delete;
+
+    private:
+        const char *Name;
+        std::int64_t Start = -1;
+        std::uint32_t Depth = 0;
+    };
+
+    const char *Profiler::TAG = "Profiler";
+    std::atomic<bool> Profiler::Enabled = true;
+    std::mutex Profiler::RegistryMutex;
+    std::vector<std::shared_ptr<Profiler::ThreadBuffer> > Profiler::Buffers;
+    std::mutex Profiler::FramesMutex;
+    std::array<ProfileFrame, Profiler::FrameHistory> Profiler::Frames;
+    std::uint64_t Profiler::FrameCount = 0;
+    std::int64_t Profiler::FrameStart = 0;
+}
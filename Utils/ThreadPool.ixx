@@ -0,0 +1,136 @@
+/**
+ * @file ThreadPool.ixx
+ * @brief 线程池
+ * @version 1.0
+ * @author Chaim
+ * @date 2026/10/18
+ */
+
+module;
+#include "Utils/Profiler.h"
+export module CEngine.ThreadPool;
+import std;
+import CEngine.Profiler;
+
+namespace CEngine {
+    /**
+     * @brief 线程池
+     * @remark 固定数量的工作线程从同一个任务队列中取任务执行；析构时执行完剩余任务再退出\n
+     * 任务中不能调用OpenGL，需要上传的数据请交回渲染线程处理
+     */
+    export class ThreadPool {
+    public:
+        /**
+         * @param thread_count 工作线程数，为0时取硬件线程数-1（至少1个）
+         */
+        explicit ThreadPool(unsigned int thread_count = 0) {
+            if (thread_count == 0)
+                thread_count = std::max(1u, std::thread::hardware_concurrency() - 1);
+            Workers.reserve(thread_count);
+            for (unsigned int i = 0; i < thread_count; ++i)
+                Workers.emplace_back([this] { WorkerLoop(); });
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(Mutex);
+                Stopping = true;
+            }
+            Condition.notify_all();
+            for (auto &worker: Workers)
+                worker.join();
+        }
+
+        /// 全局线程池
+        static ThreadPool &Global() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        /**
+         * 提交任务
+         * @param func 可调用对象
+         * @return 任务结果的future
+         */
+        template<typename F>
+        auto Submit(F &&func) -> std::future<std::invoke_result_t<std::decay_t<F> > > {
+            using R = std::invoke_result_t<std::decay_t<F> >;
+            auto task = std::make_shared<std::packaged_task<R()> >(std::forward<F>(func));
+            auto future = task->get_future();
+            {
+                std::lock_guard lock(Mutex);
+                Tasks.emplace_back([task] { (*task)(); });
+            }
+            Condition.notify_one();
+            return future;
+        }
+
+        /**
+         * 并行循环
+         * @remark 调用线程也参与执行并等待全部完成；未开始的辅助任务不会被等待，因此可以在工作线程中调用
+         * @param count 迭代次数
+         * @param func 以迭代索引调用
+         */
+        template<typename F>
+        void ParallelFor(const std::size_t count, F &&func) {
+            if (count == 0) return;
+            struct State {
+                std::atomic<std::size_t> Next{0};
+                std::atomic<std::size_t> Done{0};
+                std::mutex Mutex;
+                std::condition_variable Finished;
+            };
+            auto state = std::make_shared<State>();
+            // 只有领取到索引时才会访问func，此时调用线程必然还在等待
+            auto run = [state, count, &func] {
+                for (std::size_t i; (i = state->Next.fetch_add(1)) < count;) {
+                    func(i);
+                    if (state->Done.fetch_add(1) + 1 == count) {
+                        std::lock_guard lock(state->Mutex);
+                        state->Finished.notify_all();
+                    }
+                }
+            };
+            const auto helpers = std::min(count - 1, Workers.size());
+            for (std::size_t i = 0; i < helpers; ++i)
+                Submit(run);
+            run();
+            std::unique_lock lock(state->Mutex);
+            state->Finished.wait(lock, [&] { return state->Done.load() == count; });
+        }
+
+        /// 工作线程数
+        std::size_t GetThreadCount() const { return Workers.size(); }
+
+        /// 等待执行的任务数
+        std::size_t GetPendingCount() {
+            std::lock_guard lock(Mutex);
+            return Tasks.size();
+        }
+
+    private:
+        void WorkerLoop() {
+            CE_PROFILE_THREAD("Worker");
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(Mutex);
+                    Condition.wait(lock, [this] { return Stopping || !Tasks.empty(); });
+                    if (Tasks.empty()) return;
+                    task = std::move(Tasks.front());
+                    Tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread> Workers;
+        std::deque<std::function<void()> > Tasks;
+        std::mutex Mutex;
+        std::condition_variable Condition;
+        bool Stopping = false;
+    };
+}